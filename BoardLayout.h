@@ -0,0 +1,109 @@
+/**
+ * @file BoardLayout.h
+ * @brief Defines the layout of the shared-memory order board and the seqlock protocol used to
+ *        write and read it. Shared by the POS and by external display processes.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_BOARDLAYOUT_H
+#define RESTAURANTREAL_BOARDLAYOUT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+const char BOARD_SHM_NAME[] = "/pos_board"; // Default POSIX shared-memory object name
+const uint32_t BOARD_MAGIC = 0x42534F50; // "POSB"
+const uint32_t BOARD_VERSION = 1;
+const int BOARD_CAPACITY = 256; // Orders mirrored on the board
+const int BOARD_NAME_LENGTH = 16; // Customer name bytes kept per order, including the terminator
+
+// Flag bits of BoardEntry::flags
+const uint8_t BOARD_FLAG_COLD = 1; // Food waited ready past its service level
+const uint8_t BOARD_FLAG_PROMISED = 2; // A pickup time was promised
+
+/**
+ * One order on the board, 32 bytes.
+ */
+struct BoardEntry {
+    int32_t orderID;
+    uint8_t type; // OrderType
+    uint8_t status; // Status
+    uint8_t flags; // BOARD_FLAG_* bits
+    uint8_t reserved;
+    int64_t promisedTime; // Promised pickup time, 0 when none
+    char name[BOARD_NAME_LENGTH]; // Customer name, truncated and terminated
+};
+
+/**
+ * Board header. The sequence is odd while the writer updates the board.
+ */
+struct BoardHeader {
+    uint32_t magic;
+    uint32_t version;
+    atomic<uint64_t> sequence;
+    int64_t updatedAt; // Time of the last update
+    uint32_t count; // Entries in use
+    uint32_t totalOrders; // Orders in the system, may exceed count when the board is full
+};
+
+/**
+ * The whole shared-memory segment.
+ */
+struct BoardSegment {
+    BoardHeader header;
+    BoardEntry entries[BOARD_CAPACITY];
+};
+
+/**
+ * Starts an update: readers that begin now will retry.
+ *
+ * @param board The mapped board.
+ */
+inline void boardBeginWrite(BoardSegment* board){
+    board->header.sequence.fetch_add(1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+/**
+ * Finishes an update and makes it visible to readers.
+ *
+ * @param board The mapped board.
+ */
+inline void boardEndWrite(BoardSegment* board){
+    board->header.sequence.fetch_add(1, memory_order_release);
+}
+
+/**
+ * Copies a consistent snapshot of the board without blocking the writer.
+ *
+ * @param board The mapped board.
+ * @param out Receives the snapshot; only header fields and count entries are meaningful.
+ * @return The number of retries needed because the writer was active.
+ */
+inline int boardReadSnapshot(const BoardSegment* board, BoardSegment* out){
+    int retries = 0;
+    while (true) {
+        uint64_t before = board->header.sequence.load(memory_order_acquire);
+        if ((before & 1) == 0) {
+            uint32_t count = board->header.count;
+            if (count > BOARD_CAPACITY) {
+                count = BOARD_CAPACITY;
+            }
+            out->header.updatedAt = board->header.updatedAt;
+            out->header.totalOrders = board->header.totalOrders;
+            memcpy(out->entries, board->entries, count * sizeof(BoardEntry));
+            atomic_thread_fence(memory_order_acquire);
+            if (board->header.sequence.load(memory_order_relaxed) == before) {
+                out->header.count = count;
+                out->header.sequence.store(before, memory_order_relaxed);
+                return retries;
+            }
+        }
+        retries += 1;
+    }
+}
+
+#endif //RESTAURANTREAL_BOARDLAYOUT_H
@@ -0,0 +1,131 @@
+/**
+ * @file BoardPublisher.cpp
+ * @brief This file contains the BoardPublisher class, the seqlock writer of the shared-memory order board.
+ * @author Edward Villano
+ */
+
+#include "BoardPublisher.h"
+#include "ShiftClock.h"
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * Constructor for the BoardPublisher class.
+ *
+ * @param shmNameP Name of the shared-memory object to publish into.
+ */
+BoardPublisher::BoardPublisher(const string& shmNameP){
+    shmName = shmNameP;
+}
+
+/**
+ * Destructor for the BoardPublisher class.
+ * Unmaps the segment but leaves it in place for readers.
+ */
+BoardPublisher::~BoardPublisher(){
+    if (board != nullptr) {
+        munmap(board, sizeof(BoardSegment));
+    }
+}
+
+/**
+ * Creates and maps the segment on first use.
+ * A failure is reported once and publishing is switched off.
+ *
+ * @return True if the board is mapped.
+ */
+bool BoardPublisher::open(){
+    if (board != nullptr) {
+        return true;
+    }
+    if (failed) {
+        return false;
+    }
+
+    int fd = shm_open(shmName.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0 || ftruncate(fd, sizeof(BoardSegment)) != 0) {
+        cerr << "Order board " << shmName << " unavailable, external displays disabled" << endl;
+        if (fd >= 0) {
+            close(fd);
+        }
+        failed = true;
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, sizeof(BoardSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        cerr << "Order board " << shmName << " unavailable, external displays disabled" << endl;
+        failed = true;
+        return false;
+    }
+
+    board = static_cast<BoardSegment*>(mapped);
+    boardBeginWrite(board);
+    board->header.magic = BOARD_MAGIC;
+    board->header.version = BOARD_VERSION;
+    board->header.count = 0;
+    board->header.totalOrders = 0;
+    boardEndWrite(board);
+    return true;
+}
+
+/**
+ * Copies one order into a board entry.
+ *
+ * @param entry The entry to fill.
+ * @param order The order.
+ */
+void BoardPublisher::writeEntry(BoardEntry& entry, Order& order){
+    entry.orderID = order.getOrderID();
+    entry.type = order.getOrderType();
+    entry.status = order.getOrderStatus();
+    entry.flags = (order.isCold() ? BOARD_FLAG_COLD : 0) | (order.hasPromisedTime() ? BOARD_FLAG_PROMISED : 0);
+    entry.reserved = 0;
+    entry.promisedTime = order.getPromisedTime();
+
+    string_view name = order.getName();
+    size_t length = min(name.size(), (size_t)BOARD_NAME_LENGTH - 1);
+    memcpy(entry.name, name.data(), length);
+    entry.name[length] = '\0';
+}
+
+/**
+ * Rewrites the board from the current orders.
+ * The placed and cooking orders go first, in queue order, and the slots left are filled with the
+ * other orders newest first, so a long pickup list never pushes the kitchen's orders off the board.
+ * Orders beyond the board's capacity are counted in the header but not mirrored.
+ *
+ * @param orders The orders in the system, in queue order.
+ */
+void BoardPublisher::publish(pmr::vector<Order>& orders){
+    if (!open()) {
+        return;
+    }
+
+    auto inKitchen = [](Order& order) {
+        return order.getOrderStatus() == PLACED || order.getOrderStatus() == COOKING;
+    };
+    uint32_t count = 0;
+
+    boardBeginWrite(board);
+    for (Order& order : orders) {
+        if (count == BOARD_CAPACITY) {
+            break;
+        }
+        if (inKitchen(order)) {
+            writeEntry(board->entries[count++], order);
+        }
+    }
+    for (auto it = orders.rbegin(); it != orders.rend() && count < BOARD_CAPACITY; ++it) {
+        if (!inKitchen(*it)) {
+            writeEntry(board->entries[count++], *it);
+        }
+    }
+    board->header.count = count;
+    board->header.totalOrders = orders.size();
+    board->header.updatedAt = ShiftClock::now();
+    boardEndWrite(board);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file BoardPublisher.h
+ * @brief Defines the BoardPublisher class, which mirrors the live orders into a POSIX
+ *        shared-memory segment for kitchen and pickup displays in other processes.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_BOARDPUBLISHER_H
+#define RESTAURANTREAL_BOARDPUBLISHER_H
+
+#include <string>
+#include <vector>
+#include "BoardLayout.h"
+#include "Order.h"
+
+using namespace std;
+
+/**
+ * @class BoardPublisher
+ * @brief Writer side of the shared-memory order board.
+ *
+ * The board is guarded by a seqlock, so readers never block the writer and the writer
+ * never waits for readers; readers simply retry if an update overlapped their copy.
+ */
+class BoardPublisher {
+    private:
+        string shmName; // POSIX shared-memory object name
+        BoardSegment* board = nullptr; // Mapped segment, nullptr until opened
+        bool failed = false; // Whether opening the segment failed
+
+        /**
+         * Creates and maps the segment on first use.
+         *
+         * @return True if the board is mapped.
+         */
+        bool open();
+
+        /**
+         * Copies one order into a board entry.
+         *
+         * @param entry The entry to fill.
+         * @param order The order.
+         */
+        void writeEntry(BoardEntry& entry, Order& order);
+
+    public:
+        /**
+         * Constructor for the BoardPublisher class.
+         *
+         * @param shmNameP Name of the shared-memory object to publish into.
+         */
+        BoardPublisher(const string& shmNameP = BOARD_SHM_NAME);
+
+        /**
+         * Destructor for the BoardPublisher class.
+         * Unmaps the segment but leaves it in place for readers.
+         */
+        ~BoardPublisher();
+
+        BoardPublisher(const BoardPublisher&) = delete;
+        BoardPublisher& operator=(const BoardPublisher&) = delete;
+
+        /**
+         * Rewrites the board from the current orders.
+         * Placed and cooking orders go first, then the others newest first.
+         *
+         * @param orders The orders in the system, in queue order.
+         */
+        void publish(pmr::vector<Order>& orders);
+};
+
+#endif //RESTAURANTREAL_BOARDPUBLISHER_H
@@ -0,0 +1,224 @@
+/**
+ * @file ConsoleRenderer.cpp
+ * @brief This file contains the ConsoleRenderer class, a buffered, single-write frame renderer
+ *        with a diff mode for dedicated displays.
+ * @author Edward Villano
+ */
+
+#include "ConsoleRenderer.h"
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+/**
+ * Reads a monotonic clock in nanoseconds.
+ *
+ * @return The current time in nanoseconds.
+ */
+static uint64_t nowNanoseconds(){
+    return chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Appends raw bytes to a buffer.
+ */
+static void appendBytes(vector<char>& buffer, const char* data, size_t length){
+    buffer.insert(buffer.end(), data, data + length);
+}
+
+/**
+ * Constructor for the ConsoleRenderer class.
+ *
+ * @param fdP The file descriptor to write to, -1 to disable output.
+ */
+ConsoleRenderer::ConsoleRenderer(int fdP){
+    fd = fdP;
+}
+
+/**
+ * Sets the file descriptor to write to and forgets the previous frame.
+ *
+ * @param fdP The file descriptor, -1 to disable output.
+ */
+void ConsoleRenderer::setOutput(int fdP){
+    fd = fdP;
+    cleared = false;
+    lastRows.clear();
+    lastRowEnds.clear();
+}
+
+/**
+ * Checks whether the renderer has somewhere to write.
+ *
+ * @return True if an output file descriptor is set.
+ */
+bool ConsoleRenderer::isEnabled(){
+    return fd >= 0;
+}
+
+/**
+ * Starts a new frame, keeping the capacity of every buffer.
+ */
+void ConsoleRenderer::beginFrame(){
+    frameStart = nowNanoseconds();
+    rows.clear();
+    rowEnds.clear();
+    output.clear();
+}
+
+/**
+ * Appends text to the current row.
+ *
+ * @param text The text to append.
+ */
+void ConsoleRenderer::text(string_view text){
+    appendBytes(rows, text.data(), text.size());
+}
+
+/**
+ * Appends text padded with spaces to a width.
+ *
+ * @param text The text to append.
+ * @param width The minimum width of the field.
+ * @param leftAlign Pads on the right when true, on the left otherwise.
+ */
+void ConsoleRenderer::padded(string_view text, int width, bool leftAlign){
+    int padding = width - static_cast<int>(text.size());
+    if (!leftAlign && padding > 0) {
+        rows.insert(rows.end(), padding, ' ');
+    }
+    appendBytes(rows, text.data(), text.size());
+    if (leftAlign && padding > 0) {
+        rows.insert(rows.end(), padding, ' ');
+    }
+}
+
+/**
+ * Appends an integer padded with spaces to a width.
+ *
+ * @param value The integer to append.
+ * @param width The minimum width of the field.
+ * @param leftAlign Pads on the right when true, on the left otherwise.
+ */
+void ConsoleRenderer::number(long value, int width, bool leftAlign){
+    char digits[24];
+    char* end = to_chars(digits, digits + sizeof(digits), value).ptr;
+    padded(string_view(digits, end - digits), width, leftAlign);
+}
+
+/**
+ * Ends the current row.
+ */
+void ConsoleRenderer::endRow(){
+    rowEnds.push_back(rows.size());
+}
+
+/**
+ * Writes every row of the frame, each followed by a newline.
+ */
+void ConsoleRenderer::endFrame(){
+    uint32_t start = 0;
+    for (uint32_t end : rowEnds) {
+        appendBytes(output, rows.data() + start, end - start);
+        output.push_back('\n');
+        start = end;
+    }
+    fullStats.fullRedrawBytes += output.size();
+    flushOutput(fullStats);
+}
+
+/**
+ * Writes only the rows that differ from the previous diff frame.
+ * Each changed row is addressed with an ANSI cursor move and has the rest of its line erased;
+ * rows the previous frame had beyond the end of this one are cleared.
+ * The current frame then becomes the previous frame.
+ */
+void ConsoleRenderer::endFrameDiff(){
+    char move[32];
+
+    if (!cleared) {
+        appendBytes(output, "\x1b[2J", 4);
+        cleared = true;
+    }
+
+    uint32_t start = 0;
+    for (size_t row = 0; row < rowEnds.size(); row++) {
+        uint32_t end = rowEnds[row];
+        bool same = false;
+        if (row < lastRowEnds.size()) {
+            uint32_t lastStart = row == 0 ? 0 : lastRowEnds[row - 1];
+            same = (lastRowEnds[row] - lastStart == end - start)
+                   && memcmp(lastRows.data() + lastStart, rows.data() + start, end - start) == 0;
+        }
+        if (!same) {
+            char* moveEnd = move;
+            *moveEnd++ = '\x1b';
+            *moveEnd++ = '[';
+            moveEnd = to_chars(moveEnd, move + sizeof(move), row + 1).ptr;
+            memcpy(moveEnd, ";1H", 3);
+            appendBytes(output, move, moveEnd + 3 - move);
+            appendBytes(output, rows.data() + start, end - start);
+            appendBytes(output, "\x1b[K", 3);
+        }
+        start = end;
+    }
+
+    if (lastRowEnds.size() > rowEnds.size()) {
+        char* moveEnd = move;
+        *moveEnd++ = '\x1b';
+        *moveEnd++ = '[';
+        moveEnd = to_chars(moveEnd, move + sizeof(move), rowEnds.size() + 1).ptr;
+        memcpy(moveEnd, ";1H\x1b[J", 6);
+        appendBytes(output, move, moveEnd + 6 - move);
+    }
+
+    diffStats.fullRedrawBytes += rows.size() + rowEnds.size();
+    rows.swap(lastRows);
+    rowEnds.swap(lastRowEnds);
+    flushOutput(diffStats);
+}
+
+/**
+ * Writes the output buffer, normally with a single system call.
+ * Short writes to a slow terminal are continued until the frame is out.
+ *
+ * @param stats Counters of the mode the frame was rendered in.
+ */
+void ConsoleRenderer::flushOutput(RenderStats& stats){
+    size_t written = 0;
+    while (fd >= 0 && written < output.size()) {
+        ssize_t result = write(fd, output.data() + written, output.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        written += result;
+    }
+
+    stats.frames += 1;
+    stats.bytes += written;
+    stats.nanoseconds += nowNanoseconds() - frameStart;
+}
+
+/**
+ * Retrieves the counters of full frames.
+ *
+ * @return The full frame counters.
+ */
+RenderStats ConsoleRenderer::getFullStats(){
+    return fullStats;
+}
+
+/**
+ * Retrieves the counters of diff frames.
+ *
+ * @return The diff frame counters.
+ */
+RenderStats ConsoleRenderer::getDiffStats(){
+    return diffStats;
+}
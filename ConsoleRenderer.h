@@ -0,0 +1,136 @@
+/**
+ * @file ConsoleRenderer.h
+ * @brief Defines the ConsoleRenderer class, which formats text frames into a reusable buffer and
+ *        writes each frame with a single system call, optionally emitting only the rows that changed.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_CONSOLERENDERER_H
+#define RESTAURANTREAL_CONSOLERENDERER_H
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * Output counters for one rendering mode.
+ */
+struct RenderStats {
+    uint64_t frames = 0; // Frames written
+    uint64_t bytes = 0; // Bytes written
+    uint64_t nanoseconds = 0; // Time spent formatting and writing
+    uint64_t fullRedrawBytes = 0; // Bytes the same frames would have taken as full redraws
+};
+
+/**
+ * @class ConsoleRenderer
+ * @brief Builds a frame row by row without allocating once its buffers have grown,
+ *        then writes it to a file descriptor in one go.
+ *
+ * In full mode every row is written. In diff mode the previous frame is kept and only rows that
+ * differ from it are written, each addressed with an ANSI cursor move, which suits a dedicated display.
+ */
+class ConsoleRenderer {
+    private:
+        int fd; // Output file descriptor, -1 when the renderer is disabled
+        bool cleared = false; // Whether the diff display was cleared before its first frame
+        vector<char> rows; // Text of the rows of the frame being built
+        vector<uint32_t> rowEnds; // End offset of each row in rows
+        vector<char> lastRows; // Text of the previously written diff frame
+        vector<uint32_t> lastRowEnds; // End offset of each row in lastRows
+        vector<char> output; // Bytes of the frame to write
+        uint64_t frameStart = 0; // Start time of the frame being built
+        RenderStats fullStats; // Counters of full frames
+        RenderStats diffStats; // Counters of diff frames
+
+        /**
+         * Writes the output buffer with one system call per attempt.
+         */
+        void flushOutput(RenderStats& stats);
+
+    public:
+        /**
+         * Constructor for the ConsoleRenderer class.
+         *
+         * @param fdP The file descriptor to write to, -1 to disable output.
+         */
+        ConsoleRenderer(int fdP = -1);
+
+        /**
+         * Sets the file descriptor to write to and forgets the previous frame.
+         *
+         * @param fdP The file descriptor, -1 to disable output.
+         */
+        void setOutput(int fdP);
+
+        /**
+         * Checks whether the renderer has somewhere to write.
+         *
+         * @return True if an output file descriptor is set.
+         */
+        bool isEnabled();
+
+        /**
+         * Starts a new frame.
+         */
+        void beginFrame();
+
+        /**
+         * Appends text to the current row.
+         *
+         * @param text The text to append.
+         */
+        void text(string_view text);
+
+        /**
+         * Appends text padded with spaces to a width.
+         *
+         * @param text The text to append.
+         * @param width The minimum width of the field.
+         * @param leftAlign Pads on the right when true, on the left otherwise.
+         */
+        void padded(string_view text, int width, bool leftAlign = true);
+
+        /**
+         * Appends an integer padded with spaces to a width.
+         *
+         * @param value The integer to append.
+         * @param width The minimum width of the field.
+         * @param leftAlign Pads on the right when true, on the left otherwise.
+         */
+        void number(long value, int width = 0, bool leftAlign = true);
+
+        /**
+         * Ends the current row.
+         */
+        void endRow();
+
+        /**
+         * Writes every row of the frame.
+         */
+        void endFrame();
+
+        /**
+         * Writes only the rows that differ from the previous diff frame,
+         * clearing rows the previous frame had beyond the end of this one.
+         */
+        void endFrameDiff();
+
+        /**
+         * Retrieves the counters of full frames.
+         *
+         * @return The full frame counters.
+         */
+        RenderStats getFullStats();
+
+        /**
+         * Retrieves the counters of diff frames.
+         *
+         * @return The diff frame counters.
+         */
+        RenderStats getDiffStats();
+};
+
+#endif //RESTAURANTREAL_CONSOLERENDERER_H
@@ -0,0 +1,121 @@
+/**
+ * @file DeadlineScheduler.cpp
+ * @brief This file contains the DeadlineScheduler class, which orders promised orders
+ *        earliest-deadline-first and tracks missed promises.
+ * @author Edward Villano
+ */
+
+#include "DeadlineScheduler.h"
+#include <iostream>
+#include <iomanip>
+
+/**
+ * Pops entries of orders that already left the queue or were rescheduled.
+ */
+void DeadlineScheduler::discardStale(){
+    while (!heap.empty()){
+        auto it = live.find(heap.top().orderID);
+        if (it != live.end() && it->second == heap.top().latestStart){
+            return;
+        }
+        heap.pop();
+    }
+}
+
+/**
+ * Adds a placed order to the heap if it carries a promised time.
+ * The heap key is the promised time minus the expected preparation time.
+ *
+ * @param order The order that was placed.
+ */
+void DeadlineScheduler::add(Order& order){
+    if (!order.hasPromisedTime()){
+        return;
+    }
+    time_t latestStart = order.getPromisedTime() - order.getPrepTime();
+    heap.push(Entry{latestStart, order.getOrderID()});
+    live[order.getOrderID()] = latestStart;
+}
+
+/**
+ * Moves an order to a new latest start after its meal was edited.
+ * The old entry stays in the heap and is discarded when it reaches the top.
+ *
+ * @param order The edited order.
+ */
+void DeadlineScheduler::reschedule(Order& order){
+    auto it = live.find(order.getOrderID());
+    if (it == live.end()){
+        return;
+    }
+    time_t latestStart = order.getPromisedTime() - order.getPrepTime();
+    if (latestStart != it->second){
+        it->second = latestStart;
+        heap.push(Entry{latestStart, order.getOrderID()});
+    }
+}
+
+/**
+ * Removes an order from the heap because it was dispatched or cancelled.
+ *
+ * @param orderID The order leaving the queue.
+ */
+void DeadlineScheduler::remove(int orderID){
+    live.erase(orderID);
+}
+
+/**
+ * Finds the promised order that has to start cooking soonest, if it is due.
+ *
+ * @param now The current time.
+ * @param slackSeconds How far ahead of its latest start an order counts as due.
+ * @return The ID of the due order, or -1 if no promise is at risk yet.
+ */
+int DeadlineScheduler::nextDue(time_t now, int slackSeconds){
+    discardStale();
+    if (heap.empty() || heap.top().latestStart > now + slackSeconds){
+        return -1;
+    }
+    return heap.top().orderID;
+}
+
+/**
+ * Records whether a completed order made its promised time.
+ *
+ * @param order The order that was completed.
+ * @param now The completion time.
+ */
+void DeadlineScheduler::recordCompletion(Order& order, time_t now){
+    if (!order.hasPromisedTime()){
+        return;
+    }
+    if (now > order.getPromisedTime()){
+        missed[order.getOrderType()] += 1;
+    } else {
+        met[order.getOrderType()] += 1;
+    }
+}
+
+/**
+ * Prints the met and missed promise counts per order type.
+ */
+void DeadlineScheduler::printReport(){
+    cout << "\n-----TYPE-----|--MET--|-MISSED-" << endl;
+    for (int t = PHONE; t <= DOORDASH; t++){
+        cout << setw(13) << left << OrderTypeList[t] << " | " << setw(5) << right << met[t]
+             << " | " << setw(6) << missed[t] << left << endl;
+    }
+    cout << "Promised orders waiting: " << live.size() << endl;
+}
+
+/**
+ * Retrieves the memory held by the scheduler, including its lookup table.
+ * Entries left in the heap by removed orders count until they are popped.
+ *
+ * @return The approximate footprint in bytes.
+ */
+size_t DeadlineScheduler::bytesUsed(){
+    return heap.size() * sizeof(Entry)
+           + live.size() * (sizeof(int) + sizeof(time_t) + 2 * sizeof(void*))
+           + live.bucket_count() * sizeof(void*);
+}
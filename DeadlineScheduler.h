@@ -0,0 +1,105 @@
+/**
+ * @file DeadlineScheduler.h
+ * @brief Defines the DeadlineScheduler class, an earliest-deadline-first heap over placed orders
+ *        that carry a promised pickup time.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_DEADLINESCHEDULER_H
+#define RESTAURANTREAL_DEADLINESCHEDULER_H
+
+#include <queue>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <ctime>
+#include "Order.h"
+
+using namespace std;
+
+/**
+ * @class DeadlineScheduler
+ * @brief Keeps placed orders with a promised time in a min-heap ordered by their latest start time.
+ *
+ * Insert and pop are O(log n). Orders that leave the queue some other way are removed lazily:
+ * they are dropped from the live set in O(1) and skipped when they reach the top of the heap.
+ * A rescheduled order gets a new entry, and the old one is skipped the same way.
+ */
+class DeadlineScheduler {
+    private:
+        /**
+         * Heap entry for one promised order.
+         */
+        struct Entry {
+            time_t latestStart; // Last moment the order can start cooking and still make its promise
+            int orderID; // Order the entry belongs to
+
+            bool operator>(const Entry& other) const {
+                return latestStart != other.latestStart ? latestStart > other.latestStart
+                                                        : orderID > other.orderID;
+            }
+        };
+
+        priority_queue<Entry, vector<Entry>, greater<Entry>> heap; // Earliest latest start on top
+        unordered_map<int, time_t> live; // Latest start of each order still waiting in the heap
+        int met[4] = {}; // Promises kept per OrderType
+        int missed[4] = {}; // Promises broken per OrderType
+
+        /**
+         * Pops entries of orders that already left the queue.
+         */
+        void discardStale();
+
+    public:
+        /**
+         * Adds a placed order to the heap if it carries a promised time.
+         *
+         * @param order The order that was placed.
+         */
+        void add(Order& order);
+
+        /**
+         * Moves an order to a new latest start after its meal was edited.
+         *
+         * @param order The edited order.
+         */
+        void reschedule(Order& order);
+
+        /**
+         * Removes an order from the heap because it was dispatched or cancelled.
+         *
+         * @param orderID The order leaving the queue.
+         */
+        void remove(int orderID);
+
+        /**
+         * Finds the promised order that has to start cooking soonest, if it is due.
+         *
+         * @param now The current time.
+         * @param slackSeconds How far ahead of its latest start an order counts as due.
+         * @return The ID of the due order, or -1 if no promise is at risk yet.
+         */
+        int nextDue(time_t now, int slackSeconds);
+
+        /**
+         * Records whether a completed order made its promised time.
+         *
+         * @param order The order that was completed.
+         * @param now The completion time.
+         */
+        void recordCompletion(Order& order, time_t now);
+
+        /**
+         * Prints the met and missed promise counts per order type.
+         */
+        void printReport();
+
+        /**
+         * Retrieves the memory held by the scheduler, including its lookup table.
+         *
+         * @return The approximate footprint in bytes.
+         */
+        size_t bytesUsed();
+};
+
+#endif //RESTAURANTREAL_DEADLINESCHEDULER_H
@@ -0,0 +1,135 @@
+/**
+ * @file EventBus.cpp
+ * @brief This file contains the EventBus class, a lock-free broadcast ring buffer for order events.
+ * @author Edward Villano
+ */
+
+#include "EventBus.h"
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+
+/**
+ * Registers a consumer. Call before the consumer starts polling.
+ * The consumer starts with the next event published.
+ *
+ * @param name Name shown in backpressure reports.
+ * @return The subscriber ID, or -1 if every subscriber slot is taken.
+ */
+int EventBus::subscribe(const string& name){
+    int id = subscriberCount.load();
+    if (id >= MAX_SUBSCRIBERS) {
+        return -1;
+    }
+    subscribers[id].name = name;
+    subscribers[id].cursor.store(head.load(memory_order_acquire), memory_order_relaxed);
+    subscriberCount.store(id + 1, memory_order_release);
+    return id;
+}
+
+/**
+ * Publishes an event to every subscriber. Only one thread may publish.
+ * The slot's version is made odd while the event is copied in, then set to mark the
+ * event complete before the head moves past it.
+ *
+ * @param event The event; its sequence is assigned here.
+ */
+void EventBus::publish(OrderEvent event){
+    uint64_t sequence = head.load(memory_order_relaxed);
+    Slot& slot = slots[sequence & (CAPACITY - 1)];
+
+    event.sequence = sequence;
+    uint64_t words[EVENT_WORDS];
+    memcpy(words, &event, sizeof(words));
+
+    slot.version.store(2 * sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (int i = 0; i < EVENT_WORDS; i++) {
+        slot.words[i].store(words[i], memory_order_relaxed);
+    }
+    slot.version.store(2 * (sequence + 1), memory_order_release);
+    head.store(sequence + 1, memory_order_release);
+}
+
+/**
+ * Reads the next events for a subscriber. Only the subscriber's own thread may poll it.
+ * A subscriber the producer has lapped skips to the oldest event still in the ring,
+ * and an event overwritten while it was being copied is treated the same way.
+ *
+ * @param subscriber The subscriber ID.
+ * @param out Receives up to max events in publish order.
+ * @param max Capacity of out.
+ * @return The number of events read.
+ */
+int EventBus::poll(int subscriber, OrderEvent* out, int max){
+    Subscriber& sub = subscribers[subscriber];
+    uint64_t cursor = sub.cursor.load(memory_order_relaxed);
+    int count = 0;
+
+    while (count < max) {
+        uint64_t published = head.load(memory_order_acquire);
+        if (cursor == published) {
+            break;
+        }
+        if (published - cursor > CAPACITY) {
+            sub.dropped.fetch_add(published - CAPACITY - cursor, memory_order_relaxed);
+            cursor = published - CAPACITY;
+        }
+
+        Slot& slot = slots[cursor & (CAPACITY - 1)];
+        uint64_t before = slot.version.load(memory_order_acquire);
+        uint64_t words[EVENT_WORDS];
+        for (int i = 0; i < EVENT_WORDS; i++) {
+            words[i] = slot.words[i].load(memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t after = slot.version.load(memory_order_relaxed);
+
+        if (before != 2 * (cursor + 1) || after != before) {
+            // Overwritten by a newer lap; the next pass skips ahead
+            continue;
+        }
+
+        memcpy(&out[count], words, sizeof(words));
+        count += 1;
+        cursor += 1;
+    }
+
+    sub.cursor.store(cursor, memory_order_relaxed);
+    return count;
+}
+
+/**
+ * Retrieves how many published events a subscriber has not read yet.
+ *
+ * @param subscriber The subscriber ID.
+ * @return The subscriber's lag in events.
+ */
+uint64_t EventBus::getLag(int subscriber){
+    return head.load(memory_order_acquire) - subscribers[subscriber].cursor.load(memory_order_relaxed);
+}
+
+/**
+ * Retrieves how many events a subscriber lost by falling a full ring behind.
+ *
+ * @param subscriber The subscriber ID.
+ * @return The number of dropped events.
+ */
+uint64_t EventBus::getDropped(int subscriber){
+    return subscribers[subscriber].dropped.load(memory_order_relaxed);
+}
+
+/**
+ * Prints the lag and dropped count of every subscriber.
+ * A lag close to the ring capacity means the subscriber is about to lose events.
+ */
+void EventBus::printBackpressure(){
+    cout << "\n--SUBSCRIBER--|---LAG---|-DROPPED-" << endl;
+    for (int i = 0; i < subscriberCount.load(memory_order_acquire); i++) {
+        uint64_t lag = getLag(i);
+        cout << setw(13) << left << subscribers[i].name << " | " << setw(7) << right << lag
+             << " | " << setw(7) << getDropped(i)
+             << (lag > (CAPACITY * 3) / 4 ? "  FALLING BEHIND" : "") << left << endl;
+    }
+    cout << "Events published: " << head.load(memory_order_acquire) << endl;
+}
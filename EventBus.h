@@ -0,0 +1,135 @@
+/**
+ * @file EventBus.h
+ * @brief Defines the EventBus class, a single-producer/multi-consumer ring buffer that broadcasts
+ *        order placements, status changes and cancels to independent subscribers.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_EVENTBUS_H
+#define RESTAURANTREAL_EVENTBUS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+/**
+ * Kinds of events published on the bus.
+ */
+enum EventKind : uint8_t {
+    ORDER_PLACED,
+    STATUS_CHANGED,
+    ORDER_CANCELLED,
+    STATUS_BATCH // Many orders moved to one status at once; orderID carries how many
+};
+
+const string EventKindList[4]{
+        "Placed",
+        "Status changed",
+        "Cancelled",
+        "Status batch"
+};
+
+/**
+ * A compact order event, three machine words wide.
+ */
+struct OrderEvent {
+    uint64_t sequence; // Position of the event on the bus, assigned by publish
+    int64_t timestamp; // Time the event happened
+    int32_t orderID; // Order the event is about
+    EventKind kind; // What happened
+    uint8_t type; // OrderType of the order
+    uint8_t fromStatus; // Status before the change
+    uint8_t toStatus; // Status after the change
+};
+
+/**
+ * @class EventBus
+ * @brief Broadcast ring buffer with one producer and up to MAX_SUBSCRIBERS consumers.
+ *
+ * The producer never waits: each slot is guarded by its own sequence word, and a consumer that
+ * falls a full ring behind is moved forward and has the skipped events counted as dropped.
+ * Every consumer owns its cursor, so consumers run at their own pace on any thread.
+ */
+class EventBus {
+    public:
+        static const int CAPACITY = 1024; // Events held by the ring, a power of two
+        static const int MAX_SUBSCRIBERS = 8;
+
+    private:
+        static const int EVENT_WORDS = sizeof(OrderEvent) / sizeof(uint64_t);
+
+        /**
+         * One ring entry. The version is odd while the producer writes it and
+         * 2 * (sequence + 1) once the event with that sequence is complete.
+         */
+        struct Slot {
+            atomic<uint64_t> version{0};
+            atomic<uint64_t> words[EVENT_WORDS];
+        };
+
+        /**
+         * Per consumer state, written by its consumer and read by anyone reporting backpressure.
+         */
+        struct Subscriber {
+            string name; // Name shown in backpressure reports
+            atomic<uint64_t> cursor{0}; // Sequence of the next event to read
+            atomic<uint64_t> dropped{0}; // Events overwritten before they were read
+        };
+
+        alignas(64) atomic<uint64_t> head{0}; // Sequence of the next event to publish
+        alignas(64) Slot slots[CAPACITY];
+        Subscriber subscribers[MAX_SUBSCRIBERS];
+        atomic<int> subscriberCount{0};
+
+    public:
+        /**
+         * Registers a consumer. Call before the consumer starts polling.
+         * The consumer starts with the next event published.
+         *
+         * @param name Name shown in backpressure reports.
+         * @return The subscriber ID, or -1 if every subscriber slot is taken.
+         */
+        int subscribe(const string& name);
+
+        /**
+         * Publishes an event to every subscriber. Only one thread may publish.
+         *
+         * @param event The event; its sequence is assigned here.
+         */
+        void publish(OrderEvent event);
+
+        /**
+         * Reads the next events for a subscriber. Only the subscriber's own thread may poll it.
+         *
+         * @param subscriber The subscriber ID.
+         * @param out Receives up to max events in publish order.
+         * @param max Capacity of out.
+         * @return The number of events read.
+         */
+        int poll(int subscriber, OrderEvent* out, int max);
+
+        /**
+         * Retrieves how many published events a subscriber has not read yet.
+         *
+         * @param subscriber The subscriber ID.
+         * @return The subscriber's lag in events.
+         */
+        uint64_t getLag(int subscriber);
+
+        /**
+         * Retrieves how many events a subscriber lost by falling a full ring behind.
+         *
+         * @param subscriber The subscriber ID.
+         * @return The number of dropped events.
+         */
+        uint64_t getDropped(int subscriber);
+
+        /**
+         * Prints the lag and dropped count of every subscriber.
+         */
+        void printBackpressure();
+};
+
+#endif //RESTAURANTREAL_EVENTBUS_H
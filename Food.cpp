@@ -6,19 +6,73 @@
  */
 
 #include "Food.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
 
 using namespace std;
 
+/**
+ * Retrieves the compiled-in menu item of a food code.
+ * The items are built once from foodString, priceList and prepTimeList.
+ *
+ * @param code The food code.
+ * @return The compiled-in item.
+ */
+const MenuItem& builtinMenuItem(FOOD code){
+    static const struct BuiltinMenu {
+        MenuItem items[17];
+
+        BuiltinMenu(){
+            for (int i = 0; i < 17; i++) {
+                MenuItem& item = items[i];
+                item.code = static_cast<FOOD>(i);
+                item.category = (i <= MIXED_DRINK) ? DRINK : (i <= FRIED_MOZZ) ? APPETIZER
+                              : (i <= VEG_RICE_BOWL) ? ENTREE : DESSERT;
+                item.priceCents = lround(priceList[i] * 100.0);
+                item.prepSeconds = prepTimeList[i];
+                size_t length = min(foodString[i].size(), sizeof(item.name) - 1);
+                memcpy(item.name, foodString[i].data(), length);
+                item.name[length] = '\0';
+            }
+        }
+    } builtin;
+
+    return builtin.items[code];
+}
+
 /**
  * Constructor for the Food class.
- * Initializes a Food object with a specific type of food.
+ * Initializes a Food object with a specific type of food at its compiled-in price.
  *
  * @param foodP The type of food as an enum value.
  */
 Food::Food(FOOD foodP) {
-    food = foodP;
+    item = &builtinMenuItem(foodP);
+    priceCents = item->priceCents;
 };
 
+/**
+ * Constructor for the Food class from a menu item, charged at the item's price.
+ *
+ * @param itemP The menu item, which must outlive the food.
+ */
+Food::Food(const MenuItem& itemP) {
+    item = &itemP;
+    priceCents = itemP.priceCents;
+}
+
+/**
+ * Constructor for the Food class from a menu item at a price it was charged before.
+ *
+ * @param itemP The menu item, which must outlive the food.
+ * @param priceCentsP The price in cents.
+ */
+Food::Food(const MenuItem& itemP, int32_t priceCentsP) {
+    item = &itemP;
+    priceCents = priceCentsP;
+}
+
 /**
  * Default constructor for the Food class.
  * Initializes a Food object with default values.
@@ -28,9 +82,26 @@ Food::Food() = default;
 /**
  * Prints the food item and its price.
  * This function displays the food item as a string and its corresponding price to the console.
+ * The line is formatted into a local buffer and written in one call.
  */
 void Food::print(){
-    cout << setw(15) << foodString[food] << setw(5) << "$" << getPrice() << endl;
+    char line[64];
+    string_view name = item->name;
+    size_t length = 0;
+
+    // Name right aligned to 15 columns, then "$" right aligned to 5 columns
+    if (name.size() < 15) {
+        memset(line, ' ', 15 - name.size());
+        length = 15 - name.size();
+    }
+    memcpy(line + length, name.data(), name.size());
+    length += name.size();
+    memcpy(line + length, "    $", 5);
+    length += 5;
+    length = to_chars(line + length, line + sizeof(line) - 1, getPrice()).ptr - line;
+    line[length++] = '\n';
+
+    cout.write(line, length);
 }
 
 /**
@@ -38,15 +109,61 @@ void Food::print(){
  * @return converted enum in string
  */
 string Food::getEnumToString(){
-    return to_string(static_cast<int>(food));
+    return to_string(static_cast<int>(item->code));
+}
+
+/**
+ * Retrieves the price of the food item in cents.
+ * Totals are kept in cents so sums and fees round the same way everywhere.
+ *
+ * @return The price the food was ordered at, in cents.
+ */
+long Food::getPriceCents() const{
+    return priceCents;
+}
+
+/**
+ * Retrieves the expected preparation time of the food item.
+ *
+ * @return The preparation time in seconds.
+ */
+int Food::getPrepTime() const{
+    return item->prepSeconds;
+}
+
+/**
+ * Retrieves the enum type of the food item.
+ *
+ * @return The FOOD enum value of the item.
+ */
+FOOD Food::getFood() const{
+    return item->code;
+}
+
+/**
+ * Retrieves the menu item the food was ordered from.
+ *
+ * @return The item of the catalog version the food was ordered from.
+ */
+const MenuItem* Food::getMenuItem() const{
+    return item;
+}
+
+/**
+ * Retrieves the display name of the food item.
+ *
+ * @return The name of the menu item it was ordered from.
+ */
+string_view Food::getName() const{
+    return item->name;
 }
 
 /**
  * Retrieves the price of the food item.
- * This function returns the price associated with the food item's enum type.
+ * This function returns the price the food item was ordered at.
  *
  * @return The price of the food item as a float.
  */
 float Food::getPrice() {
-    return priceList[food];
+    return priceCents / 100.0f;
 }
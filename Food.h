@@ -8,6 +8,8 @@
 #define RESTAURANTREAL_FOOD_H
 
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
 
@@ -62,22 +64,99 @@ const float priceList[17] = {
     8.99, 9.99, 6.99
 };
 
+/**
+ * Array of ints representing the expected preparation time, in seconds, of the food items in the FOOD enumeration.
+ */
+const int prepTimeList[17] = {
+    15, 30, 60, 60,
+    45, 120,
+    480, 420, 360,
+    600, 660, 540,
+    900, 480,
+    180, 300, 120
+};
+
+/**
+ * Enum names of the FOOD codes, as written in menu and pricing files.
+ */
+const string foodCodeList[17]{
+        "WATER", "SODA", "TEA", "COFFEE",
+        "BEER", "MIXED_DRINK",
+        "WINGS", "QUESADILLAS", "FRIED_MOZZ",
+        "HAMBURGER", "CHEESEBURGER", "CHICKEN_TENDERS",
+        "GRILLED_SALMON", "VEG_RICE_BOWL",
+        "APPLE_PIE", "LAVA_CAKE", "ICE_CREAM"
+};
+
+/**
+ * Sections of the menu an item is listed under.
+ */
+enum FoodCategory {
+    DRINK,
+    APPETIZER,
+    ENTREE,
+    DESSERT
+};
+
+const string FoodCategoryList[4]{
+        "DRINK",
+        "APPETIZER",
+        "ENTREE",
+        "DESSERT"
+};
+
+/**
+ * One item of a menu catalog version. Items are never changed once published,
+ * so a food can point at the item it was ordered from.
+ */
+struct MenuItem {
+    FOOD code; // Kitchen code, fixed across catalog versions
+    FoodCategory category; // Menu section
+    int32_t priceCents; // Price in this version
+    int32_t prepSeconds; // Expected preparation time
+    char name[32]; // Display name, null terminated
+};
+
+/**
+ * Retrieves the compiled-in menu item of a food code.
+ *
+ * @param code The food code.
+ * @return The item built from foodString, priceList and prepTimeList.
+ */
+const MenuItem& builtinMenuItem(FOOD code);
+
 /**
  * @class Food
  * @brief It encapsulates details about a food item such as its type and provides methods
  * for retrieving its price and displaying its information.
+ *
+ * A food keeps the price it was ordered at, so later menu versions do not change existing orders.
  */
 class Food {
     private:
-        FOOD food; // Type of food
+        const MenuItem* item = nullptr; // Menu item the food was ordered from
+        int32_t priceCents = 0; // Price charged for the food
 
     public:
         /**
-         * Constructor to create a food item with a specified type.
+         * Constructor to create a food item with a specified type at its compiled-in price.
          * @param foodP Type of food as defined in the FOOD enumeration.
          */
         Food(FOOD foodP);
 
+        /**
+         * Constructor to create a food item from a menu item at the item's price.
+         * @param itemP The menu item, which must outlive the food.
+         */
+        Food(const MenuItem& itemP);
+
+        /**
+         * Constructor to create a food item from a menu item at a price it was charged before.
+         * @param itemP The menu item, which must outlive the food.
+         * @param priceCentsP The price in cents.
+         */
+        Food(const MenuItem& itemP, int32_t priceCentsP);
+
         /**
          * Default constructor for the Food class.
          * Initializes a food item to a default value.
@@ -90,6 +169,36 @@ class Food {
          */
         float getPrice();
 
+        /**
+         * Retrieves the price of the food item in cents.
+         * @return The price in cents.
+         */
+        long getPriceCents() const;
+
+        /**
+         * Retrieves the expected preparation time of the food item.
+         * @return The preparation time in seconds.
+         */
+        int getPrepTime() const;
+
+        /**
+         * Retrieves the enum type of the food item.
+         * @return The FOOD enum value of the item.
+         */
+        FOOD getFood() const;
+
+        /**
+         * Retrieves the menu item the food was ordered from.
+         * @return The item of the catalog version the food was ordered from.
+         */
+        const MenuItem* getMenuItem() const;
+
+        /**
+         * Retrieves the display name of the food item.
+         * @return The name of the menu item it was ordered from.
+         */
+        string_view getName() const;
+
         /**
          * Get enum number and convert to string
          * @return converted enum in string
@@ -0,0 +1,327 @@
+/**
+ * @file HistoryCodec.cpp
+ * @brief This file contains the HistoryCodec class, the packed block format of the order history.
+ * @author Edward Villano
+ */
+
+#include "HistoryCodec.h"
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include "Order.h"
+
+static const int LZ_HASH_BITS = 12;
+static const size_t LZ_MIN_MATCH = 4;
+static const size_t LZ_MAX_OFFSET = 65535;
+
+/**
+ * Appends an unsigned number in 7-bit groups, low group first, the high bit marking that more follow.
+ */
+static void putVarint(vector<char>& out, uint64_t value){
+    while (value >= 0x80) {
+        out.push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+/**
+ * Maps a signed number to an unsigned one with small magnitudes staying small: 0, -1, 1, -2 ...
+ */
+static uint64_t zigzag(int64_t value){
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+/**
+ * Inverse of zigzag.
+ */
+static int64_t unzigzag(uint64_t value){
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+/**
+ * Bounds-checked reader over a packed block. Reading past the end clears ok and returns zeros.
+ */
+struct BlockReader {
+    const uint8_t* at;
+    const uint8_t* end;
+    bool ok = true;
+
+    uint64_t varint(){
+        uint64_t value = 0;
+        for (int shift = 0; at < end && shift < 64; shift += 7) {
+            uint8_t byte = *at++;
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    uint8_t byte(){
+        if (at < end) {
+            return *at++;
+        }
+        ok = false;
+        return 0;
+    }
+};
+
+/**
+ * Starting price of every food for the price deltas of a block.
+ */
+static void startingPrices(int32_t prices[17]){
+    for (int code = 0; code < 17; code++) {
+        prices[code] = builtinMenuItem(static_cast<FOOD>(code)).priceCents;
+    }
+}
+
+/**
+ * Packs plain records.
+ * Each field is stored as its difference from what the block has already seen, so the usual
+ * record of consecutive IDs, standard fee, a regular's name and menu prices takes a few bytes.
+ *
+ * @param records Plain records back to back.
+ * @param size Bytes of the records.
+ * @param out Receives the packed block, replacing its contents.
+ */
+void HistoryCodec::encode(const char* records, size_t size, vector<char>& out){
+    out.clear();
+    out.reserve(size / 3);
+
+    unordered_map<string_view, uint32_t> nameRefs;
+    int32_t lastPrice[17];
+    startingPrices(lastPrice);
+    int64_t previousID = 0;
+    int64_t previousPlaced = 0;
+
+    HistoryRecord header;
+    for (size_t at = 0; at + sizeof(header) <= size; at += header.length) {
+        memcpy(&header, records + at, sizeof(header));
+        const char* name = records + at + sizeof(header);
+        const char* meal = name + header.nameLength;
+
+        putVarint(out, zigzag(header.orderID - previousID));
+        putVarint(out, zigzag(header.placedTime - previousPlaced));
+        putVarint(out, zigzag(header.archivedTime - header.placedTime));
+        previousID = header.orderID;
+        previousPlaced = header.placedTime;
+
+        uint8_t flags = (header.type & 3) | (header.status & 3) << 2 | (header.cancelled != 0) << 4
+                        | (header.promisedTime != 0) << 5 | (header.discountCents != 0) << 6;
+        out.push_back((char)flags);
+        if (header.promisedTime != 0) {
+            putVarint(out, zigzag(header.promisedTime - header.placedTime));
+        }
+        if (header.discountCents != 0) {
+            putVarint(out, zigzag(header.discountCents));
+        }
+        putVarint(out, zigzag(header.feePercent - serviceFeePercent[header.type & 3]));
+
+        // A name already in the block is a back reference, a new one takes the next index
+        auto [ref, added] = nameRefs.emplace(string_view(name, header.nameLength), (uint32_t)nameRefs.size());
+        putVarint(out, ref->second);
+        if (added) {
+            putVarint(out, header.nameLength);
+            out.insert(out.end(), name, name + header.nameLength);
+        }
+
+        putVarint(out, header.mealSize);
+        for (int i = 0; i < header.mealSize;) {
+            uint8_t code = (uint8_t)meal[i * HistoryRecord::ITEM_BYTES] % 17;
+            int32_t cents;
+            memcpy(&cents, meal + i * HistoryRecord::ITEM_BYTES + 1, sizeof(cents));
+
+            int run = 1;
+            while (run < 8 && i + run < header.mealSize
+                   && memcmp(meal + i * HistoryRecord::ITEM_BYTES, meal + (i + run) * HistoryRecord::ITEM_BYTES,
+                             HistoryRecord::ITEM_BYTES) == 0) {
+                run += 1;
+            }
+            out.push_back((char)(code | (run - 1) << 5));
+            putVarint(out, zigzag(cents - lastPrice[code]));
+            lastPrice[code] = cents;
+            i += run;
+        }
+    }
+}
+
+/**
+ * Unpacks a packed block back to plain records.
+ *
+ * @param block The packed block.
+ * @param size Bytes of the block.
+ * @param records Number of records in the block.
+ * @param out Receives the plain records, replacing its contents.
+ * @return False if the block is damaged.
+ */
+bool HistoryCodec::decode(const char* block, size_t size, uint32_t records, vector<char>& out){
+    out.clear();
+    out.reserve(size * 4);
+
+    BlockReader in{(const uint8_t*)block, (const uint8_t*)block + size};
+    vector<string_view> names;
+    int32_t lastPrice[17];
+    startingPrices(lastPrice);
+    int64_t previousID = 0;
+    int64_t previousPlaced = 0;
+
+    for (uint32_t r = 0; r < records && in.ok; r++) {
+        HistoryRecord header{};
+        header.orderID = previousID + unzigzag(in.varint());
+        header.placedTime = previousPlaced + unzigzag(in.varint());
+        header.archivedTime = header.placedTime + unzigzag(in.varint());
+        previousID = header.orderID;
+        previousPlaced = header.placedTime;
+
+        uint8_t flags = in.byte();
+        header.type = flags & 3;
+        header.status = (flags >> 2) & 3;
+        header.cancelled = (flags >> 4) & 1;
+        header.promisedTime = (flags & 1 << 5) ? header.placedTime + unzigzag(in.varint()) : 0;
+        header.discountCents = (flags & 1 << 6) ? unzigzag(in.varint()) : 0;
+        header.feePercent = serviceFeePercent[header.type] + unzigzag(in.varint());
+
+        uint64_t ref = in.varint();
+        if (ref == names.size()) {
+            uint64_t length = in.varint();
+            if (length > (uint64_t)(in.end - in.at)) {
+                return false;
+            }
+            names.emplace_back((const char*)in.at, length);
+            in.at += length;
+        } else if (ref > names.size()) {
+            return false;
+        }
+        string_view name = names[ref];
+        header.nameLength = name.size();
+        header.mealSize = in.varint();
+
+        size_t start = out.size();
+        header.length = sizeof(header) + name.size() + header.mealSize * HistoryRecord::ITEM_BYTES;
+        out.resize(start + header.length);
+        char* item = out.data() + start + sizeof(header);
+        memcpy(item, name.data(), name.size());
+        item += name.size();
+
+        long subtotal = 0;
+        for (int i = 0; i < header.mealSize && in.ok;) {
+            uint8_t byte = in.byte();
+            uint8_t code = byte & 31;
+            int run = (byte >> 5) + 1;
+            if (code >= 17 || i + run > header.mealSize) {
+                return false;
+            }
+            int32_t cents = lastPrice[code] + unzigzag(in.varint());
+            lastPrice[code] = cents;
+            for (int k = 0; k < run; k++) {
+                item[0] = (char)code;
+                memcpy(item + 1, &cents, sizeof(cents));
+                item += HistoryRecord::ITEM_BYTES;
+            }
+            subtotal += (long)cents * run;
+            i += run;
+        }
+        header.subtotalCents = subtotal;
+        memcpy(out.data() + start, &header, sizeof(header));
+    }
+    return in.ok;
+}
+
+/**
+ * Compresses bytes with the LZ pass.
+ * Each token is a varint literal count, the literals, then a varint match length less 3 and a varint
+ * offset back into the output; a match length of 0 ends the stream.
+ *
+ * @param in The bytes to compress.
+ * @param size Number of bytes.
+ * @param out Receives the compressed bytes, replacing its contents.
+ */
+void HistoryCodec::compress(const char* in, size_t size, vector<char>& out){
+    out.clear();
+    out.reserve(size / 2 + 16);
+
+    uint32_t table[1 << LZ_HASH_BITS] = {}; // Position plus one of the last 4 bytes with each hash
+    size_t anchor = 0;
+    size_t at = 0;
+
+    while (at + LZ_MIN_MATCH <= size) {
+        uint32_t sequence;
+        memcpy(&sequence, in + at, sizeof(sequence));
+        uint32_t hash = (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+        size_t candidate = table[hash];
+        table[hash] = at + 1;
+
+        if (candidate == 0 || at - (candidate - 1) > LZ_MAX_OFFSET
+            || memcmp(in + candidate - 1, in + at, LZ_MIN_MATCH) != 0) {
+            at += 1;
+            continue;
+        }
+
+        size_t match = candidate - 1;
+        size_t length = LZ_MIN_MATCH;
+        while (at + length < size && in[match + length] == in[at + length]) {
+            length += 1;
+        }
+
+        putVarint(out, at - anchor);
+        out.insert(out.end(), in + anchor, in + at);
+        putVarint(out, length - LZ_MIN_MATCH + 1);
+        putVarint(out, at - match);
+        at += length;
+        anchor = at;
+    }
+
+    putVarint(out, size - anchor);
+    out.insert(out.end(), in + anchor, in + size);
+    putVarint(out, 0);
+}
+
+/**
+ * Decompresses bytes of the LZ pass.
+ *
+ * @param in The compressed bytes.
+ * @param size Number of compressed bytes.
+ * @param rawSize Number of bytes they decompress to.
+ * @param out Receives the bytes, replacing its contents.
+ * @return False if the input is damaged.
+ */
+bool HistoryCodec::decompress(const char* in, size_t size, size_t rawSize, vector<char>& out){
+    out.resize(rawSize);
+    BlockReader reader{(const uint8_t*)in, (const uint8_t*)in + size};
+    char* to = out.data();
+    char* end = to + rawSize;
+
+    while (reader.ok) {
+        uint64_t literals = reader.varint();
+        if (literals > (uint64_t)(end - to) || literals > (uint64_t)(reader.end - reader.at)) {
+            return false;
+        }
+        memcpy(to, reader.at, literals);
+        to += literals;
+        reader.at += literals;
+
+        uint64_t length = reader.varint();
+        if (length == 0) {
+            return reader.ok && to == end;
+        }
+        length += LZ_MIN_MATCH - 1;
+        uint64_t offset = reader.varint();
+        if (offset == 0 || offset > (uint64_t)(to - out.data()) || length > (uint64_t)(end - to)) {
+            return false;
+        }
+        const char* from = to - offset;
+        if (offset >= length) {
+            memcpy(to, from, length);
+        } else {
+            // Byte by byte, since the match overlaps the bytes it produces
+            for (uint64_t i = 0; i < length; i++) {
+                to[i] = from[i];
+            }
+        }
+        to += length;
+    }
+    return false;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file HistoryCodec.h
+ * @brief Defines the HistoryCodec class, which packs blocks of archived order records with
+ *        delta and varint coding and an optional LZ pass.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_HISTORYCODEC_H
+#define RESTAURANTREAL_HISTORYCODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Fixed part of a plain archived record, followed by the name bytes and mealSize packed items
+ * of one FOOD code byte and a 4-byte price in cents. Records are written back to back.
+ */
+struct HistoryRecord {
+    static const size_t ITEM_BYTES = 5;
+
+    int64_t placedTime;
+    int64_t archivedTime;
+    int64_t promisedTime;
+    uint32_t length; // Bytes of the whole record
+    int32_t orderID;
+    int32_t subtotalCents;
+    int32_t discountCents;
+    uint8_t type;
+    uint8_t status;
+    uint8_t cancelled;
+    uint8_t feePercent;
+    uint16_t nameLength;
+    uint16_t mealSize;
+};
+
+/**
+ * @class HistoryCodec
+ * @brief Converts between plain records and packed blocks.
+ *
+ * A packed record stores what changed from the record before it in the block:
+ *   varint  order ID and placement time as zigzag deltas, archive and promise times as offsets from placement
+ *   byte    type (2 bits), status (2 bits), cancelled, promised and discounted flags
+ *   varint  discount if any, and the fee as its difference from the type's standard fee
+ *   varint  name, as an index into the names seen so far in the block or a new name spelled out
+ *   varint  runs of equal items, each a byte of FOOD code and run length and the price's change
+ *           from the last price of that food in the block
+ * The subtotal is not stored; it is the sum of the item prices.
+ *
+ * The LZ pass is byte oriented like LZ4: literal runs and back references of at least 4 bytes found
+ * through a small hash table, so decompressing is a tight copy loop.
+ */
+class HistoryCodec {
+    public:
+        /**
+         * Packs plain records.
+         *
+         * @param records Plain records back to back.
+         * @param size Bytes of the records.
+         * @param out Receives the packed block, replacing its contents.
+         */
+        static void encode(const char* records, size_t size, vector<char>& out);
+
+        /**
+         * Unpacks a packed block back to plain records.
+         *
+         * @param block The packed block.
+         * @param size Bytes of the block.
+         * @param records Number of records in the block.
+         * @param out Receives the plain records, replacing its contents.
+         * @return False if the block is damaged.
+         */
+        static bool decode(const char* block, size_t size, uint32_t records, vector<char>& out);
+
+        /**
+         * Compresses bytes with the LZ pass.
+         *
+         * @param in The bytes to compress.
+         * @param size Number of bytes.
+         * @param out Receives the compressed bytes, replacing its contents.
+         */
+        static void compress(const char* in, size_t size, vector<char>& out);
+
+        /**
+         * Decompresses bytes of the LZ pass.
+         *
+         * @param in The compressed bytes.
+         * @param size Number of compressed bytes.
+         * @param rawSize Number of bytes they decompress to.
+         * @param out Receives the bytes, replacing its contents.
+         * @return False if the input is damaged.
+         */
+        static bool decompress(const char* in, size_t size, size_t rawSize, vector<char>& out);
+};
+
+#endif //RESTAURANTREAL_HISTORYCODEC_H
@@ -0,0 +1,294 @@
+/**
+ * @file InputTrace.cpp
+ * @brief This file contains the TraceRecorder and TraceReplayer classes, capture and replay of the
+ *        operator's input.
+ * @author Edward Villano
+ */
+
+#include "InputTrace.h"
+#include "ShiftClock.h"
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+static const char TRACE_MAGIC[8] = {'P', 'O', 'S', 'T', 'R', 'A', 'C', 'E'};
+static const uint32_t TRACE_VERSION = 1;
+static const char RECORD_LINE = 1;
+static const char RECORD_END = 2;
+
+/**
+ * Appends an unsigned varint, seven bits per byte with the high bit set on all but the last.
+ */
+static void putVarint(string& out, uint64_t value){
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * Reads an unsigned varint; false if the data ends inside it.
+ */
+static bool getVarint(const string& data, size_t& at, uint64_t& value){
+    value = 0;
+    for (int shift = 0; shift < 64 && at < data.size(); shift += 7) {
+        uint8_t byte = data[at++];
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Reads a varint length and that many bytes.
+ */
+static bool getText(const string& data, size_t& at, string& text){
+    uint64_t length;
+    if (!getVarint(data, at, length) || data.size() - at < length) {
+        return false;
+    }
+    text.assign(data, at, length);
+    at += length;
+    return true;
+}
+
+/**
+ * Destructor for the TraceRecorder class.
+ * Gives the stream its buffer back and the shift clock back to the system clock.
+ */
+TraceRecorder::~TraceRecorder(){
+    if (attached != nullptr) {
+        attached->rdbuf(source);
+        ShiftClock::release();
+    }
+}
+
+/**
+ * Creates a trace, writes its header and puts the recorder in front of a stream's buffer.
+ *
+ * @param path The trace file.
+ * @param input The stream to record, normally cin.
+ * @param menuPath Menu file loaded, empty for the built in menu.
+ * @param rulesPath Pricing rules file loaded, empty for none.
+ * @param state The whole state at the start, as a state file.
+ * @return False if the trace cannot be created.
+ */
+bool TraceRecorder::start(const string& path, istream& input, const string& menuPath, const string& rulesPath,
+                          const string& state){
+    trace.open(path, ios::binary | ios::trunc);
+    if (!trace) {
+        return false;
+    }
+
+    startMs = chrono::duration_cast<chrono::milliseconds>(
+            chrono::system_clock::now().time_since_epoch()).count();
+    offsetMs = 0;
+    string header(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.append(reinterpret_cast<const char*>(&TRACE_VERSION), sizeof(TRACE_VERSION));
+    header.append(reinterpret_cast<const char*>(&startMs), sizeof(startMs));
+    for (const string* text : {&menuPath, &rulesPath, &state}) {
+        putVarint(header, text->size());
+        header.append(*text);
+    }
+    trace.write(header.data(), header.size());
+    trace.flush();
+
+    last = chrono::steady_clock::now();
+    ShiftClock::set(startMs / 1000);
+    attached = &input;
+    source = input.rdbuf(this);
+    return true;
+}
+
+/**
+ * Takes the next line from the source, records it with the time since the line before,
+ * and hands it to the reader. The shift clock is set from the recorded times, truncated the way
+ * a replay truncates them, so a line typed just after a second boundary is not a second off.
+ *
+ * @return The first character of the line, or EOF when the source has no more input.
+ */
+int TraceRecorder::underflow(){
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    line.clear();
+    for (int c = source->sbumpc(); c != traits_type::eof(); c = source->sbumpc()) {
+        line.push_back(traits_type::to_char_type(c));
+        if (c == '\n') {
+            break;
+        }
+    }
+    if (line.empty()) {
+        return traits_type::eof();
+    }
+
+    auto now = chrono::steady_clock::now();
+    int64_t gap = chrono::duration_cast<chrono::milliseconds>(now - last).count();
+    string record(1, RECORD_LINE);
+    putVarint(record, gap);
+    putVarint(record, line.size());
+    record.append(line);
+    trace.write(record.data(), record.size());
+    trace.flush();
+    // The gap is measured between records, so rounding never adds up over a shift
+    last += chrono::milliseconds(gap);
+    offsetMs += gap;
+    ShiftClock::set((startMs + offsetMs) / 1000);
+
+    setg(line.data(), line.data(), line.data() + line.size());
+    return traits_type::to_int_type(line[0]);
+}
+
+/**
+ * Ends the trace with the final state, gives the stream its buffer back and releases the shift clock.
+ *
+ * @param digest Digest of the final state.
+ * @param orders Number of orders in the final state.
+ */
+void TraceRecorder::finish(uint64_t digest, uint64_t orders){
+    if (!isRecording()) {
+        return;
+    }
+    string record(1, RECORD_END);
+    record.append(reinterpret_cast<const char*>(&digest), sizeof(digest));
+    putVarint(record, orders);
+    trace.write(record.data(), record.size());
+    trace.close();
+
+    attached->rdbuf(source);
+    attached = nullptr;
+    ShiftClock::release();
+}
+
+/**
+ * Checks whether input is being recorded.
+ *
+ * @return True between start and finish.
+ */
+bool TraceRecorder::isRecording() const{
+    return attached != nullptr;
+}
+
+/**
+ * Destructor for the TraceReplayer class.
+ * Gives the stream its buffer back.
+ */
+TraceReplayer::~TraceReplayer(){
+    detach();
+}
+
+/**
+ * Reads a trace and its header, and looks ahead for the end record and the number of lines.
+ *
+ * @param path The trace file.
+ * @return False if the file cannot be read or is not a trace.
+ */
+bool TraceReplayer::open(const string& path){
+    ifstream input(path, ios::binary);
+    if (!input) {
+        return false;
+    }
+    stringstream contents;
+    contents << input.rdbuf();
+    data = contents.str();
+
+    const size_t fixedBytes = sizeof(TRACE_MAGIC) + sizeof(TRACE_VERSION) + sizeof(startMs);
+    uint32_t version;
+    if (data.size() < fixedBytes || memcmp(data.data(), TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        return false;
+    }
+    memcpy(&version, data.data() + sizeof(TRACE_MAGIC), sizeof(version));
+    memcpy(&startMs, data.data() + sizeof(TRACE_MAGIC) + sizeof(version), sizeof(startMs));
+    at = fixedBytes;
+    if (version != TRACE_VERSION || !getText(data, at, menuPath) || !getText(data, at, rulesPath)
+        || !getText(data, at, state)) {
+        return false;
+    }
+
+    // A trace cut short by a crash simply has no end record
+    size_t scan = at;
+    uint64_t gap, length;
+    while (scan < data.size() && data[scan] == RECORD_LINE) {
+        scan += 1;
+        if (!getVarint(data, scan, gap) || !getVarint(data, scan, length) || data.size() - scan < length) {
+            break;
+        }
+        scan += length;
+        totalLines += 1;
+    }
+    if (scan < data.size() && data[scan] == RECORD_END && data.size() - scan > sizeof(digest)) {
+        memcpy(&digest, data.data() + scan + 1, sizeof(digest));
+        scan += 1 + sizeof(digest);
+        ended = getVarint(data, scan, orders);
+    }
+    return true;
+}
+
+/**
+ * Starts feeding the trace to a stream and sets the shift clock to the start of the capture.
+ *
+ * @param input The stream, normally cin.
+ * @param speedUp Factor to divide the recorded gaps by, 0 to replay as fast as possible.
+ */
+void TraceReplayer::attach(istream& input, double speedUp){
+    speed = speedUp;
+    replayStart = chrono::steady_clock::now();
+    ShiftClock::set(startMs / 1000);
+    attached = &input;
+    original = input.rdbuf(this);
+}
+
+/**
+ * Gives the stream its buffer back.
+ */
+void TraceReplayer::detach(){
+    if (attached != nullptr) {
+        attached->rdbuf(original);
+        attached = nullptr;
+    }
+}
+
+/**
+ * Hands out the next line of the trace, after setting the shift clock to the second it was typed
+ * and, when paced, waiting until its scaled time has come.
+ *
+ * @return The first character of the line.
+ * @throws TraceEnded When the trace has no more lines.
+ */
+int TraceReplayer::underflow(){
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+
+    uint64_t gap;
+    if (at >= data.size() || data[at] != RECORD_LINE) {
+        throw TraceEnded();
+    }
+    at += 1;
+    if (!getVarint(data, at, gap) || !getText(data, at, line) || line.empty()) {
+        throw TraceEnded();
+    }
+    offsetMs += gap;
+    lines += 1;
+
+    if (speed > 0) {
+        this_thread::sleep_until(replayStart + chrono::microseconds((int64_t)(offsetMs * 1000 / speed)));
+    }
+    ShiftClock::set((startMs + offsetMs) / 1000);
+
+    setg(line.data(), line.data(), line.data() + line.size());
+    return traits_type::to_int_type(line[0]);
+}
+
+/**
+ * Retrieves the time of the last line handed out.
+ *
+ * @return Milliseconds since the start of the capture.
+ */
+uint64_t TraceReplayer::elapsedMs() const{
+    return offsetMs;
+}
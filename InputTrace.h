@@ -0,0 +1,169 @@
+/**
+ * @file InputTrace.h
+ * @brief Defines the TraceRecorder and TraceReplayer classes, which capture the operator's input
+ *        of a shift into a compact binary trace and feed it back to the system later.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_INPUTTRACE_H
+#define RESTAURANTREAL_INPUTTRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+
+using namespace std;
+
+/**
+ * Thrown by a replay's input once the trace has no more input, so a replay of a shift that ended
+ * in a crash stops wherever the input stopped.
+ */
+class TraceEnded : public runtime_error {
+    public:
+        TraceEnded() : runtime_error("end of trace") {}
+};
+
+/**
+ * @class TraceRecorder
+ * @brief Sits between standard input and everything that reads it, recording every line read.
+ *
+ * A trace starts with a header: the magic "POSTRACE", a version, the wall clock in milliseconds at
+ * the start of the capture, the menu and pricing rules files loaded and the whole state as loaded,
+ * as a state file. Each line of input follows as a record of a tag byte, the milliseconds since the record before as
+ * a varint, the line's length as a varint and its bytes. An orderly exit adds an end record with a
+ * digest of the final state and the number of orders, which a replay must reproduce.
+ *
+ * Lines are taken from the real input one at a time and written and flushed as they arrive, so
+ * a trace is complete up to the last line typed even if the process dies. While recording, the shift
+ * clock is held at each line's recorded time, as a replay sets it, so both see the same seconds.
+ */
+class TraceRecorder : public streambuf {
+    private:
+        streambuf* source = nullptr; // Standard input's own buffer
+        istream* attached = nullptr; // Stream whose buffer this replaced
+        ofstream trace;
+        string line; // Line being handed to the reader
+        chrono::steady_clock::time_point last; // Time of the previous record
+        int64_t startMs = 0; // Wall clock at the start of the capture, in milliseconds
+        uint64_t offsetMs = 0; // Time of the last line since the start, as recorded
+
+        /**
+         * Takes the next line from the source and records it.
+         */
+        int underflow() override;
+
+    public:
+        TraceRecorder() = default;
+
+        /**
+         * Destructor for the TraceRecorder class.
+         * Gives the stream its buffer back.
+         */
+        ~TraceRecorder() override;
+
+        /**
+         * Creates a trace and starts recording the input of a stream.
+         *
+         * @param path The trace file.
+         * @param input The stream to record, normally cin.
+         * @param menuPath Menu file loaded, empty for the built in menu.
+         * @param rulesPath Pricing rules file loaded, empty for none.
+         * @param state The whole state at the start, as a state file.
+         * @return False if the trace cannot be created.
+         */
+        bool start(const string& path, istream& input, const string& menuPath, const string& rulesPath,
+                   const string& state);
+
+        /**
+         * Ends the trace with the final state and stops recording.
+         *
+         * @param digest Digest of the final state.
+         * @param orders Number of orders in the final state.
+         */
+        void finish(uint64_t digest, uint64_t orders);
+
+        /**
+         * Checks whether input is being recorded.
+         *
+         * @return True between start and finish.
+         */
+        bool isRecording() const;
+};
+
+/**
+ * @class TraceReplayer
+ * @brief Feeds the lines of a trace to whatever reads from the stream it is attached to.
+ *
+ * Before each line the shift clock is set to the second the line was typed, so placements, timers,
+ * deadlines and pricing see the times of the recorded shift. Lines are given as fast as they are
+ * read, or paced by their recorded gaps divided by a speed-up factor.
+ */
+class TraceReplayer : public streambuf {
+    private:
+        string data; // The whole trace
+        size_t at = 0; // Position of the next record
+        string line; // Line being handed to the reader
+        uint64_t offsetMs = 0; // Time of the last line since the start of the capture
+        double speed = 0; // Speed-up of the recorded gaps, 0 for no pacing
+        chrono::steady_clock::time_point replayStart;
+        istream* attached = nullptr;
+        streambuf* original = nullptr;
+
+        /**
+         * Hands out the next line of the trace.
+         */
+        int underflow() override;
+
+    public:
+        int64_t startMs = 0; // Wall clock at the start of the capture, in milliseconds
+        string menuPath; // Menu file of the capture
+        string rulesPath; // Pricing rules file of the capture
+        string state; // State at the start of the capture
+        bool ended = false; // Whether the capture ended in an orderly exit
+        uint64_t digest = 0; // Digest of the final state, if it ended
+        uint64_t orders = 0; // Orders in the final state, if it ended
+        uint64_t lines = 0; // Lines handed out so far
+        uint64_t totalLines = 0; // Lines in the trace
+
+        TraceReplayer() = default;
+
+        /**
+         * Destructor for the TraceReplayer class.
+         * Gives the stream its buffer back.
+         */
+        ~TraceReplayer() override;
+
+        /**
+         * Reads a trace and its header.
+         *
+         * @param path The trace file.
+         * @return False if the file cannot be read or is not a trace.
+         */
+        bool open(const string& path);
+
+        /**
+         * Starts feeding the trace to a stream and sets the shift clock to the start of the capture.
+         *
+         * @param input The stream, normally cin.
+         * @param speedUp Factor to divide the recorded gaps by, 0 to replay as fast as possible.
+         */
+        void attach(istream& input, double speedUp);
+
+        /**
+         * Gives the stream its buffer back.
+         */
+        void detach();
+
+        /**
+         * Retrieves the time of the last line handed out.
+         *
+         * @return Milliseconds since the start of the capture.
+         */
+        uint64_t elapsedMs() const;
+};
+
+#endif //RESTAURANTREAL_INPUTTRACE_H
@@ -0,0 +1,176 @@
+/**
+ * @file Inventory.cpp
+ * @brief This file contains the Inventory class, which tracks food stock with atomic counters.
+ * @author Edward Villano
+ */
+
+#include "Inventory.h"
+
+/**
+ * Constructor for the Inventory class.
+ * Every food starts untracked.
+ */
+Inventory::Inventory(){
+    for (int food = 0; food < 17; food++) {
+        stock[food].store(UNTRACKED, memory_order_relaxed);
+        lowAt[food].store(0, memory_order_relaxed);
+    }
+    available.store((1u << 17) - 1, memory_order_relaxed);
+    low.store(0, memory_order_relaxed);
+}
+
+/**
+ * Brings a food's bits in line with its counter.
+ * If the counter moves while the bits are written, they are written again, so whichever
+ * thread changes the counter last also leaves the bits matching it.
+ *
+ * @param food The food whose counter changed.
+ */
+void Inventory::refresh(FOOD food){
+    uint32_t bit = 1u << food;
+    int count = stock[food].load(memory_order_acquire);
+
+    while (true) {
+        bool isAvailable = count > 0;
+        bool isLow = count != UNTRACKED && count <= lowAt[food].load(memory_order_relaxed);
+
+        uint32_t availableBefore = isAvailable ? available.fetch_or(bit, memory_order_acq_rel)
+                                               : available.fetch_and(~bit, memory_order_acq_rel);
+        uint32_t lowBefore = isLow ? low.fetch_or(bit, memory_order_acq_rel)
+                                   : low.fetch_and(~bit, memory_order_acq_rel);
+
+        if (((availableBefore & bit) != 0) != isAvailable || ((lowBefore & bit) != 0) != isLow) {
+            version.fetch_add(1, memory_order_release);
+        }
+
+        int now = stock[food].load(memory_order_acquire);
+        if (now == count) {
+            return;
+        }
+        count = now;
+    }
+}
+
+/**
+ * Sets the portions left of a food.
+ *
+ * @param food The food to stock.
+ * @param count Portions left, 0 to sell out the food, or -1 to stop tracking it.
+ * @param lowAtP Portions at or below which the food is reported as running low.
+ */
+void Inventory::setStock(FOOD food, int count, int lowAtP){
+    lowAt[food].store(lowAtP, memory_order_relaxed);
+    stock[food].store(count < 0 ? UNTRACKED : count, memory_order_release);
+    refresh(food);
+}
+
+/**
+ * Takes one portion of a food for an order.
+ * The counter is only decremented while it is above zero, so concurrent orders
+ * can never take more portions than there are.
+ *
+ * @param food The food being ordered.
+ * @return True if a portion was taken, false if the food is sold out.
+ */
+bool Inventory::reserve(FOOD food){
+    int count = stock[food].load(memory_order_relaxed);
+    do {
+        if (count == UNTRACKED) {
+            return true;
+        }
+        if (count <= 0) {
+            return false;
+        }
+    } while (!stock[food].compare_exchange_weak(count, count - 1, memory_order_acq_rel, memory_order_relaxed));
+
+    if (count - 1 <= lowAt[food].load(memory_order_relaxed)) {
+        refresh(food);
+    }
+    return true;
+}
+
+/**
+ * Gives back a portion of a food from a cancelled order or removed item.
+ *
+ * @param food The food to give back.
+ */
+void Inventory::release(FOOD food){
+    int count = stock[food].load(memory_order_relaxed);
+    do {
+        if (count == UNTRACKED) {
+            return;
+        }
+    } while (!stock[food].compare_exchange_weak(count, count + 1, memory_order_acq_rel, memory_order_relaxed));
+
+    if (count <= lowAt[food].load(memory_order_relaxed)) {
+        refresh(food);
+    }
+}
+
+/**
+ * Checks whether a food can be ordered.
+ *
+ * @param food The food to check.
+ * @return True if the food is untracked or has portions left.
+ */
+bool Inventory::isAvailable(FOOD food){
+    return (available.load(memory_order_acquire) >> food) & 1;
+}
+
+/**
+ * Checks whether a food is running low.
+ *
+ * @param food The food to check.
+ * @return True if the food is tracked and at or below its low mark.
+ */
+bool Inventory::isLow(FOOD food){
+    return (low.load(memory_order_acquire) >> food) & 1;
+}
+
+/**
+ * Retrieves the portions left of a food.
+ *
+ * @param food The food to look up.
+ * @return The portions left, or -1 if the food is untracked.
+ */
+int Inventory::getStock(FOOD food){
+    int count = stock[food].load(memory_order_acquire);
+    return count == UNTRACKED ? -1 : count;
+}
+
+/**
+ * Retrieves the portions at or below which a food runs low.
+ *
+ * @param food The food to look up.
+ * @return The threshold set with its stock.
+ */
+int Inventory::getLowAt(FOOD food){
+    return lowAt[food].load(memory_order_relaxed);
+}
+
+/**
+ * Retrieves the bits of the foods running low.
+ *
+ * @return Bit n is set if FOOD n is running low.
+ */
+uint32_t Inventory::getLowMask(){
+    return low.load(memory_order_acquire);
+}
+
+/**
+ * Retrieves the bits of the foods that can be ordered.
+ *
+ * @return Bit n is set if FOOD n is available.
+ */
+uint32_t Inventory::getAvailableMask(){
+    return available.load(memory_order_acquire);
+}
+
+/**
+ * Retrieves a counter that changes whenever a food becomes low, sold out or available again.
+ *
+ * @return The version of the masks.
+ */
+uint32_t Inventory::getVersion(){
+    return version.load(memory_order_acquire);
+}
@@ -0,0 +1,128 @@
+/**
+ * @file Inventory.h
+ * @brief Defines the Inventory class, lock-free per-FOOD stock counters with an availability bitmask.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_INVENTORY_H
+#define RESTAURANTREAL_INVENTORY_H
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include "Food.h"
+
+using namespace std;
+
+/**
+ * @class Inventory
+ * @brief Counts the portions left of each food so sold-out items are refused while an order is built.
+ *
+ * Reservations and releases are compare-and-swap loops on the food's counter, so any number of intake
+ * threads can take stock without a lock and a counter never goes below zero. Two bitmasks over the FOOD
+ * codes summarize the counters: which foods are available and which are running low. They are refreshed
+ * after every change until they match the counter, so the whole menu is checked with a single load.
+ *
+ * Foods start untracked, meaning unlimited, until a count is set for them.
+ */
+class Inventory {
+    private:
+        static const int UNTRACKED = INT_MAX;
+
+        atomic<int> stock[17]; // Portions left per FOOD, UNTRACKED for unlimited
+        atomic<int> lowAt[17]; // Portions at or below which a FOOD counts as running low
+        atomic<uint32_t> available; // Bit per FOOD with portions left
+        atomic<uint32_t> low; // Bit per FOOD running low
+        atomic<uint32_t> version{0}; // Bumped whenever the low or available bits change
+
+        /**
+         * Brings a food's bits in line with its counter.
+         */
+        void refresh(FOOD food);
+
+    public:
+        /**
+         * Constructor for the Inventory class.
+         * Every food starts untracked.
+         */
+        Inventory();
+
+        /**
+         * Sets the portions left of a food.
+         *
+         * @param food The food to stock.
+         * @param count Portions left, 0 to sell out the food, or -1 to stop tracking it.
+         * @param lowAtP Portions at or below which the food is reported as running low.
+         */
+        void setStock(FOOD food, int count, int lowAtP);
+
+        /**
+         * Takes one portion of a food for an order.
+         *
+         * @param food The food being ordered.
+         * @return True if a portion was taken, false if the food is sold out.
+         */
+        bool reserve(FOOD food);
+
+        /**
+         * Gives back a portion of a food from a cancelled order or removed item.
+         *
+         * @param food The food to give back.
+         */
+        void release(FOOD food);
+
+        /**
+         * Checks whether a food can be ordered.
+         *
+         * @param food The food to check.
+         * @return True if the food is untracked or has portions left.
+         */
+        bool isAvailable(FOOD food);
+
+        /**
+         * Checks whether a food is running low.
+         *
+         * @param food The food to check.
+         * @return True if the food is tracked and at or below its low mark.
+         */
+        bool isLow(FOOD food);
+
+        /**
+         * Retrieves the portions left of a food.
+         *
+         * @param food The food to look up.
+         * @return The portions left, or -1 if the food is untracked.
+         */
+        int getStock(FOOD food);
+
+        /**
+         * Retrieves the portions at or below which a food runs low.
+         *
+         * @param food The food to look up.
+         * @return The threshold set with its stock.
+         */
+        int getLowAt(FOOD food);
+
+        /**
+         * Retrieves the bits of the foods running low.
+         *
+         * @return Bit n is set if FOOD n is running low.
+         */
+        uint32_t getLowMask();
+
+        /**
+         * Retrieves the bits of the foods that can be ordered.
+         *
+         * @return Bit n is set if FOOD n is available.
+         */
+        uint32_t getAvailableMask();
+
+        /**
+         * Retrieves a counter that changes whenever a food becomes low, sold out or available again.
+         *
+         * @return The version of the masks.
+         */
+        uint32_t getVersion();
+};
+
+#endif //RESTAURANTREAL_INVENTORY_H
@@ -0,0 +1,160 @@
+/**
+ * @file KitchenBatcher.cpp
+ * @brief This file contains the KitchenBatcher class, which consolidates identical items across
+ *        placed orders into cooking batches.
+ * @author Edward Villano
+ */
+
+#include "KitchenBatcher.h"
+#include <iostream>
+
+/**
+ * Adds every item of a newly placed order to the running demand.
+ *
+ * @param order The order that was placed.
+ */
+void KitchenBatcher::addOrder(Order& order){
+    for (const Food& item : order.getMeal()){
+        FOOD food = item.getFood();
+        PendingItem& entry = pending[food][order.getOrderID()];
+        entry.quantity += 1;
+        entry.placedTime = order.getPlacedTime();
+        demand[food] += 1;
+    }
+}
+
+/**
+ * Removes whatever is still outstanding for an order from the running demand.
+ * Items already cooked in a finished batch are no longer pending and are skipped.
+ *
+ * @param order The order leaving the placed queue.
+ */
+void KitchenBatcher::removeOrder(Order& order){
+    for (const Food& item : order.getMeal()){
+        FOOD food = item.getFood();
+        auto it = pending[food].find(order.getOrderID());
+        if (it != pending[food].end()){
+            demand[food] -= it->second.quantity;
+            pending[food].erase(it);
+        }
+    }
+}
+
+/**
+ * Adds an item that was added to a placed order to the running demand.
+ *
+ * @param order The edited order.
+ * @param food The food that was added.
+ */
+void KitchenBatcher::addItem(Order& order, FOOD food){
+    PendingItem& entry = pending[food][order.getOrderID()];
+    entry.quantity += 1;
+    entry.placedTime = order.getPlacedTime();
+    demand[food] += 1;
+}
+
+/**
+ * Removes an item that was taken off a placed order from the running demand.
+ * If every item of that food was already cooked in a batch, nothing is pending to remove.
+ *
+ * @param order The edited order.
+ * @param food The food that was removed.
+ */
+void KitchenBatcher::removeItem(Order& order, FOOD food){
+    auto it = pending[food].find(order.getOrderID());
+    if (it == pending[food].end()){
+        return;
+    }
+    demand[food] -= 1;
+    if (--it->second.quantity == 0){
+        pending[food].erase(it);
+    }
+}
+
+/**
+ * Retrieves the number of outstanding items of a food across all placed orders.
+ *
+ * @param food The food to look up.
+ * @return The outstanding quantity.
+ */
+int KitchenBatcher::getDemand(FOOD food){
+    return demand[food];
+}
+
+/**
+ * Groups outstanding identical items into batches.
+ * Tickets are visited in placement order, so each batch is the oldest ticket
+ * plus every following ticket placed within the window.
+ *
+ * @param windowSeconds Maximum placement time spread of the tickets in one batch.
+ * @param minQuantity Smallest batch worth proposing.
+ * @return The proposed batches, ordered by food.
+ */
+vector<CookBatch> KitchenBatcher::proposeBatches(int windowSeconds, int minQuantity){
+    vector<CookBatch> batches;
+
+    for (int f = 0; f < 17; f++){
+        if (demand[f] < minQuantity){
+            continue;
+        }
+
+        CookBatch current{static_cast<FOOD>(f), 0, 0, {}};
+        for (auto& [orderID, entry] : pending[f]){
+            if (current.quantity > 0 && entry.placedTime - current.oldest > windowSeconds){
+                if (current.quantity >= minQuantity){
+                    batches.push_back(current);
+                }
+                current = CookBatch{static_cast<FOOD>(f), 0, 0, {}};
+            }
+            if (current.quantity == 0){
+                current.oldest = entry.placedTime;
+            }
+            current.quantity += entry.quantity;
+            current.tickets.push_back({orderID, entry.quantity});
+        }
+        if (current.quantity >= minQuantity){
+            batches.push_back(current);
+        }
+    }
+    return batches;
+}
+
+/**
+ * Marks a proposed batch as cooked, removing its items from the outstanding demand
+ * and printing how the batch fans out to its tickets.
+ *
+ * @param batch The batch that finished cooking.
+ * @param name Display name of the batch's food on the current menu.
+ */
+void KitchenBatcher::finishBatch(const CookBatch& batch, string_view name){
+    cout << "\nBatch of " << batch.quantity << " x " << name << " ready:" << endl;
+
+    for (const BatchTicket& ticket : batch.tickets){
+        auto it = pending[batch.food].find(ticket.orderID);
+        if (it == pending[batch.food].end()){
+            // Ticket was cancelled or dispatched after the batch was proposed
+            continue;
+        }
+        int served = min(ticket.quantity, it->second.quantity);
+        it->second.quantity -= served;
+        demand[batch.food] -= served;
+        if (it->second.quantity == 0){
+            pending[batch.food].erase(it);
+        }
+        cout << "  Order #" << ticket.orderID << ": " << served << " x " << name << endl;
+    }
+}
+
+/**
+ * Retrieves the memory held by the outstanding tickets.
+ * Each ticket is a tree node of its own, counted with four words of node overhead.
+ *
+ * @return The approximate footprint in bytes.
+ */
+size_t KitchenBatcher::bytesUsed(){
+    size_t tickets = 0;
+    for (const map<int, PendingItem>& food : pending) {
+        tickets += food.size();
+    }
+    return tickets * (sizeof(int) + sizeof(PendingItem) + 4 * sizeof(void*));
+}
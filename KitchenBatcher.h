@@ -0,0 +1,123 @@
+/**
+ * @file KitchenBatcher.h
+ * @brief Defines the KitchenBatcher class, a consolidation view over placed orders that keeps
+ *        running per-FOOD demand counts and proposes batches of identical items to cook together.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_KITCHENBATCHER_H
+#define RESTAURANTREAL_KITCHENBATCHER_H
+
+#include <map>
+#include <vector>
+#include <ctime>
+#include "Order.h"
+
+using namespace std;
+
+/**
+ * A single ticket that a cooking batch fans out to once it is finished.
+ */
+struct BatchTicket {
+    int orderID; // Order the items belong to
+    int quantity; // Number of the batch's items that go to this order
+};
+
+/**
+ * A proposed batch of identical items taken from one or more placed orders.
+ */
+struct CookBatch {
+    FOOD food; // Item cooked in this batch
+    int quantity; // Total number of items in the batch
+    time_t oldest; // Placement time of the oldest ticket in the batch
+    vector<BatchTicket> tickets; // Back-references to the orders the batch serves
+};
+
+/**
+ * @class KitchenBatcher
+ * @brief Tracks outstanding items of placed orders so identical items can be cooked in one batch.
+ *
+ * Demand counts are updated incrementally as orders are placed, cancelled and dispatched,
+ * so the orders list never has to be rescanned.
+ */
+class KitchenBatcher {
+    private:
+        /**
+         * Outstanding items of one food for a single order.
+         */
+        struct PendingItem {
+            int quantity; // Items still waiting to be cooked
+            time_t placedTime; // Placement time of the order
+        };
+
+        int demand[17] = {}; // Running count of outstanding items per FOOD
+        map<int, PendingItem> pending[17]; // Outstanding items per FOOD, keyed by order ID (placement order)
+
+    public:
+        /**
+         * Adds every item of a newly placed order to the running demand.
+         *
+         * @param order The order that was placed.
+         */
+        void addOrder(Order& order);
+
+        /**
+         * Removes whatever is still outstanding for an order from the running demand.
+         * Called when an order is cancelled or dispatched to the kitchen.
+         *
+         * @param order The order leaving the placed queue.
+         */
+        void removeOrder(Order& order);
+
+        /**
+         * Adds an item that was added to a placed order to the running demand.
+         *
+         * @param order The edited order.
+         * @param food The food that was added.
+         */
+        void addItem(Order& order, FOOD food);
+
+        /**
+         * Removes an item that was taken off a placed order from the running demand.
+         *
+         * @param order The edited order.
+         * @param food The food that was removed.
+         */
+        void removeItem(Order& order, FOOD food);
+
+        /**
+         * Retrieves the number of outstanding items of a food across all placed orders.
+         *
+         * @param food The food to look up.
+         * @return The outstanding quantity.
+         */
+        int getDemand(FOOD food);
+
+        /**
+         * Groups outstanding identical items into batches.
+         * A batch starts at its oldest ticket and collects every later ticket placed within the window.
+         *
+         * @param windowSeconds Maximum placement time spread of the tickets in one batch.
+         * @param minQuantity Smallest batch worth proposing.
+         * @return The proposed batches, ordered by food.
+         */
+        vector<CookBatch> proposeBatches(int windowSeconds, int minQuantity);
+
+        /**
+         * Marks a proposed batch as cooked, removing its items from the outstanding demand
+         * and printing how the batch fans out to its tickets.
+         *
+         * @param batch The batch that finished cooking.
+         * @param name Display name of the batch's food on the current menu.
+         */
+        void finishBatch(const CookBatch& batch, string_view name);
+
+        /**
+         * Retrieves the memory held by the outstanding tickets.
+         *
+         * @return The approximate footprint in bytes.
+         */
+        size_t bytesUsed();
+};
+
+#endif //RESTAURANTREAL_KITCHENBATCHER_H
@@ -0,0 +1,146 @@
+/**
+ * @file MealTable.cpp
+ * @brief This file contains the MealTable class, which interns meal compositions shared by orders.
+ * @author Edward Villano
+ */
+
+#include "MealTable.h"
+#include <algorithm>
+
+const Meal MealTable::EMPTY{};
+
+/**
+ * Checks whether an item being interned is the same item, charged at the same price, as one of a meal.
+ */
+static bool sameItem(const MealTable::KeyedItem& a, const Food& b){
+    return a.item == b.getMenuItem() && (uint32_t)a.key == (uint32_t)b.getPriceCents();
+}
+
+/**
+ * Constructor for the MealTable class.
+ *
+ * @param resourceP Memory resource the meals' items are allocated from.
+ */
+MealTable::MealTable(pmr::memory_resource* resourceP) : resource(resourceP){
+}
+
+/**
+ * Hashes the multiset of items being interned, in canonical order, mixing in a whole item's menu item
+ * and price per step.
+ *
+ * @return The composition hash.
+ */
+uint64_t MealTable::hashItems(){
+    uint64_t hash = keyed.size();
+    for (const KeyedItem& item : keyed) {
+        hash ^= reinterpret_cast<uintptr_t>(item.item) + (item.key << 40);
+        hash *= 0x9e3779b97f4a7c15ull;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+/**
+ * Returns the meal with a set of items, adding it to the table first if it is new.
+ * A new meal's totals and per-food counts are worked out here, once for every order that shares it.
+ *
+ * @param items The items, in any order; sorted into canonical order by the call.
+ * @return The shared meal, valid for the lifetime of the table.
+ */
+const Meal* MealTable::intern(vector<Food>& items){
+    if (items.empty()) {
+        return &EMPTY;
+    }
+    // Each item's sort key is read once, rather than once per comparison
+    keyed.clear();
+    for (const Food& item : items) {
+        keyed.push_back(KeyedItem{((uint64_t)item.getFood() << 32) | (uint32_t)item.getPriceCents(),
+                                  item.getMenuItem(), item});
+    }
+    sort(keyed.begin(), keyed.end(), [](const KeyedItem& a, const KeyedItem& b) {
+        return a.key != b.key ? a.key < b.key : less<const MenuItem*>()(a.item, b.item);
+    });
+    for (size_t k = 0; k < keyed.size(); k++) {
+        items[k] = keyed[k].food;
+    }
+    uint64_t hash = hashItems();
+
+    auto [first, last] = ids.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        const Meal& meal = meals[it->second - 1];
+        if (equal(keyed.begin(), keyed.end(), meal.items.begin(), meal.items.end(), sameItem)) {
+            return &meal;
+        }
+    }
+
+    // Moved in whole, so the items keep the table's resource
+    Meal& meal = meals.emplace_back(Meal{(uint32_t)meals.size() + 1, hash, 0, 0, {},
+                                         pmr::vector<Food>(items.begin(), items.end(), resource)});
+    itemBytes += meal.items.capacity() * sizeof(Food);
+    for (const Food& item : items) {
+        meal.subtotalCents += item.getPriceCents();
+        meal.prepSeconds += item.getPrepTime();
+        meal.counts[item.getFood()] += 1;
+    }
+    ids.emplace(hash, meal.id);
+    return &meal;
+}
+
+/**
+ * Returns the meal of another meal with one more item.
+ *
+ * @param meal The meal to start from.
+ * @param item The item to add.
+ * @return The shared meal.
+ */
+const Meal* MealTable::with(const Meal* meal, Food item){
+    vector<Food> items(meal->items.begin(), meal->items.end());
+    items.push_back(item);
+    return intern(items);
+}
+
+/**
+ * Returns the meal of another meal without one of its items.
+ *
+ * @param meal The meal to start from.
+ * @param position Position of the item in the meal's items.
+ * @return The shared meal, or the same meal if the position is out of range.
+ */
+const Meal* MealTable::without(const Meal* meal, size_t position){
+    if (position >= meal->items.size()) {
+        return meal;
+    }
+    vector<Food> items(meal->items.begin(), meal->items.end());
+    items.erase(items.begin() + position);
+    return intern(items);
+}
+
+/**
+ * Retrieves a meal by ID.
+ *
+ * @param id The meal's ID.
+ * @return The meal, or the empty meal for ID 0.
+ */
+const Meal* MealTable::get(uint32_t id){
+    return id == 0 ? &EMPTY : &meals[id - 1];
+}
+
+/**
+ * Retrieves the number of distinct meals in the table.
+ *
+ * @return The number of interned meals, the empty meal not included.
+ */
+size_t MealTable::size(){
+    return meals.size();
+}
+
+/**
+ * Retrieves the memory held by the table, including its lookup table.
+ *
+ * @return The approximate footprint in bytes.
+ */
+size_t MealTable::bytesUsed(){
+    return itemBytes + meals.size() * sizeof(Meal)
+           + ids.size() * (sizeof(uint64_t) + sizeof(uint32_t) + 2 * sizeof(void*))
+           + ids.bucket_count() * sizeof(void*);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file MealTable.h
+ * @brief Defines the MealTable class, a shared table of the distinct meal compositions of a shift.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_MEALTABLE_H
+#define RESTAURANTREAL_MEALTABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+#include "Food.h"
+
+using namespace std;
+
+/**
+ * One distinct meal composition. Meals are never changed once interned, so any number of orders
+ * can point at the same one; editing an order points it at another meal instead.
+ */
+struct Meal {
+    uint32_t id = 0; // Position in the table, 0 for the empty meal
+    uint64_t hash = 0; // Hash of the item multiset
+    long subtotalCents = 0; // Sum of the items' prices
+    int prepSeconds = 0; // Sum of the items' preparation times
+    uint16_t counts[17] = {}; // Items per FOOD code
+    pmr::vector<Food> items; // Items in canonical order, by food code then price
+};
+
+/**
+ * @class MealTable
+ * @brief Interns meal compositions so every order with the same items shares one immutable meal.
+ *
+ * Rushes repeat a handful of combos, so most orders add no memory of their own beyond a pointer.
+ * A composition is keyed by the hash of its item multiset: two orders with the same items in any
+ * order share a meal. Items compare by the menu item they were ordered from and the price charged,
+ * so meals from different menu versions stay apart. Totals, preparation time and the per-food counts
+ * are worked out once per composition when it is interned.
+ *
+ * Items live in the shift arena and meals are never removed, so a meal stays valid for the whole
+ * shift. The table is single threaded, like the rest of the system's order state.
+ */
+class MealTable {
+    public:
+        /**
+         * An item being interned with its canonical sort key.
+         */
+        struct KeyedItem {
+            uint64_t key; // Food code in the high word, price in the low word
+            const MenuItem* item; // Menu item, breaking ties between menu versions
+            Food food;
+        };
+
+    private:
+        pmr::memory_resource* resource; // Memory of the meals' items
+        deque<Meal> meals; // Interned meals by ID; a deque never moves them
+        unordered_multimap<uint64_t, uint32_t> ids; // IDs by composition hash
+        size_t itemBytes = 0; // Bytes of items allocated from the resource
+        vector<KeyedItem> keyed; // Items being interned, kept to reuse its memory
+
+        /**
+         * Hashes the multiset of items being interned.
+         */
+        uint64_t hashItems();
+
+    public:
+        /**
+         * The meal with no items, shared by every order before anything is added to it.
+         */
+        static const Meal EMPTY;
+
+        /**
+         * Constructor for the MealTable class.
+         *
+         * @param resourceP Memory resource the meals' items are allocated from.
+         */
+        explicit MealTable(pmr::memory_resource* resourceP = pmr::get_default_resource());
+
+        MealTable(const MealTable&) = delete;
+        MealTable& operator=(const MealTable&) = delete;
+
+        /**
+         * Returns the meal with a set of items, adding it to the table first if it is new.
+         *
+         * @param items The items, in any order; sorted into canonical order by the call.
+         * @return The shared meal, valid for the lifetime of the table.
+         */
+        const Meal* intern(vector<Food>& items);
+
+        /**
+         * Returns the meal of another meal with one more item.
+         *
+         * @param meal The meal to start from.
+         * @param item The item to add.
+         * @return The shared meal.
+         */
+        const Meal* with(const Meal* meal, Food item);
+
+        /**
+         * Returns the meal of another meal without one of its items.
+         *
+         * @param meal The meal to start from.
+         * @param position Position of the item in the meal's items.
+         * @return The shared meal, or the same meal if the position is out of range.
+         */
+        const Meal* without(const Meal* meal, size_t position);
+
+        /**
+         * Retrieves a meal by ID.
+         *
+         * @param id The meal's ID.
+         * @return The meal, or the empty meal for ID 0.
+         */
+        const Meal* get(uint32_t id);
+
+        /**
+         * Retrieves the number of distinct meals in the table.
+         *
+         * @return The number of interned meals, the empty meal not included.
+         */
+        size_t size();
+
+        /**
+         * Retrieves the memory held by the table, including its lookup table.
+         *
+         * @return The approximate footprint in bytes.
+         */
+        size_t bytesUsed();
+};
+
+#endif //RESTAURANTREAL_MEALTABLE_H
@@ -0,0 +1,243 @@
+/**
+ * @file MenuCatalog.cpp
+ * @brief This file contains the MenuCatalog class, a menu file loader publishing immutable menu versions.
+ * @author Edward Villano
+ */
+
+#include "MenuCatalog.h"
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+/**
+ * Hashes a code or name into a slot, ignoring case.
+ * FNV-1a started from the seed, with a final mix so the top bits depend on every character.
+ *
+ * @return The slot, below MenuSnapshot::HASH_SLOTS.
+ */
+static uint32_t slotOf(string_view word, uint32_t seed){
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : word) {
+        hash ^= (uint8_t)tolower((unsigned char)c);
+        hash *= 16777619u;
+    }
+    hash ^= hash >> 15;
+    hash *= 0x2c1b3c6du;
+    hash ^= hash >> 12;
+    return hash % MenuSnapshot::HASH_SLOTS;
+}
+
+/**
+ * Compares a code or name, ignoring case.
+ */
+static bool sameWord(string_view a, string_view b){
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Looks up an item by its code or display name, ignoring case.
+ * The word is hashed to its slot and checked against the one item that can be there.
+ *
+ * @param word The code (LAVA_CAKE) or name (Lava Cake).
+ * @return The item, or nullptr if no item has that code or name.
+ */
+const MenuItem* MenuSnapshot::find(string_view word) const{
+    int code = slots[slotOf(word, seed)];
+    if (code < 0) {
+        return nullptr;
+    }
+    const MenuItem& item = items[code];
+    if (sameWord(word, foodCodeList[code]) || sameWord(word, item.name)) {
+        return &item;
+    }
+    return nullptr;
+}
+
+/**
+ * Checks whether a food can be ordered from this version.
+ *
+ * @param code The food code.
+ * @return True if the food is listed.
+ */
+bool MenuSnapshot::isListed(FOOD code) const{
+    return (listed >> code) & 1;
+}
+
+/**
+ * Finds a seed for which every code and name hashes to its own slot.
+ * A name spelled like its own code shares the code's slot.
+ *
+ * @param menu The version to build the lookup for.
+ * @return False if two items have the same name or no seed was found.
+ */
+bool MenuCatalog::build(MenuSnapshot& menu){
+    struct Key {
+        string_view word;
+        int8_t code;
+    };
+    Key keys[34];
+    int keyCount = 0;
+
+    for (int code = 0; code < 17; code++) {
+        keys[keyCount++] = Key{foodCodeList[code], (int8_t)code};
+        if (!sameWord(menu.items[code].name, foodCodeList[code])) {
+            keys[keyCount++] = Key{menu.items[code].name, (int8_t)code};
+        }
+    }
+    for (int i = 0; i < keyCount; i++) {
+        for (int j = i + 1; j < keyCount; j++) {
+            if (keys[i].code != keys[j].code && sameWord(keys[i].word, keys[j].word)) {
+                return false;
+            }
+        }
+    }
+
+    for (uint32_t seed = 0; seed < (1u << 16); seed++) {
+        memset(menu.slots, -1, sizeof(menu.slots));
+        bool collision = false;
+        for (int i = 0; i < keyCount && !collision; i++) {
+            int8_t& slot = menu.slots[slotOf(keys[i].word, seed)];
+            collision = slot >= 0;
+            slot = keys[i].code;
+        }
+        if (!collision) {
+            menu.seed = seed;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Makes a version current.
+ * The version is kept alive by the catalog, so readers still using the previous one are unaffected.
+ *
+ * @param menu The fully built version.
+ */
+void MenuCatalog::publish(unique_ptr<MenuSnapshot> menu){
+    const MenuSnapshot* next = menu.get();
+    versions.push_back(std::move(menu));
+    current.store(next, memory_order_release);
+}
+
+/**
+ * Constructor for the MenuCatalog class.
+ * Starts with the compiled-in menu as version 1, every food listed in code order.
+ */
+MenuCatalog::MenuCatalog(){
+    auto menu = make_unique<MenuSnapshot>();
+    for (int code = 0; code < 17; code++) {
+        const MenuItem& item = builtinMenuItem(static_cast<FOOD>(code));
+        menu->items[code] = item;
+        menu->listed |= 1u << code;
+        menu->byCategory[item.category][menu->categoryCount[item.category]++] = code;
+    }
+    build(*menu);
+    menu->version = 1;
+    publish(std::move(menu));
+}
+
+/**
+ * Retrieves the current version of the menu.
+ *
+ * @return The version, valid until the catalog is destroyed.
+ */
+const MenuSnapshot& MenuCatalog::snapshot() const{
+    return *current.load(memory_order_acquire);
+}
+
+/**
+ * Replaces the menu with the one in a file.
+ * The new version is built off to the side and only published once it is complete,
+ * so an order being taken sees either the old menu or the new one, never a mix.
+ *
+ * @param path The menu file.
+ * @return The number of items loaded, or -1 if the menu was not replaced.
+ */
+int MenuCatalog::load(const string& path){
+    ifstream file(path);
+    if (!file) {
+        cerr << "Menu " << path << " not found, keeping menu version " << snapshot().version << endl;
+        return -1;
+    }
+
+    auto menu = make_unique<MenuSnapshot>();
+    for (int code = 0; code < 17; code++) {
+        menu->items[code] = builtinMenuItem(static_cast<FOOD>(code));
+    }
+
+    string line;
+    int lineNumber = 0;
+    int loaded = 0;
+
+    while (getline(file, line)) {
+        lineNumber += 1;
+        line = line.substr(0, line.find('#'));
+
+        istringstream words(line);
+        string codeWord, categoryWord, name;
+        double dollars;
+        int prepSeconds;
+        if (!(words >> codeWord)) {
+            continue;
+        }
+
+        bool ok = false;
+        if (words >> categoryWord >> dollars >> prepSeconds && getline(words >> ws, name)) {
+            name = name.substr(0, name.find_last_not_of(" \t\r") + 1);
+
+            int code = -1;
+            int category = -1;
+            for (int i = 0; i < 17; i++) {
+                code = (foodCodeList[i] == codeWord) ? i : code;
+            }
+            for (int i = DRINK; i <= DESSERT; i++) {
+                category = (FoodCategoryList[i] == categoryWord) ? i : category;
+            }
+
+            ok = code >= 0 && category >= 0 && !((menu->listed >> code) & 1) && dollars >= 0 && prepSeconds > 0
+                 && !name.empty() && name.size() < sizeof(MenuItem::name);
+            if (ok) {
+                MenuItem& item = menu->items[code];
+                item.category = static_cast<FoodCategory>(category);
+                item.priceCents = lround(dollars * 100);
+                item.prepSeconds = prepSeconds;
+                memcpy(item.name, name.data(), name.size());
+                item.name[name.size()] = '\0';
+                menu->listed |= 1u << code;
+                menu->byCategory[category][menu->categoryCount[category]++] = code;
+            }
+        }
+
+        if (ok) {
+            loaded += 1;
+        } else {
+            cerr << path << ":" << lineNumber << ": invalid menu item skipped" << endl;
+        }
+    }
+
+    if (loaded == 0) {
+        cerr << "No menu items in " << path << ", keeping menu version " << snapshot().version << endl;
+        return -1;
+    }
+    if (!build(*menu)) {
+        cerr << "Two menu items in " << path << " share a name, keeping menu version " << snapshot().version << endl;
+        return -1;
+    }
+
+    lock_guard<mutex> lock(writer);
+    menu->version = versions.size() + 1;
+    publish(std::move(menu));
+    return loaded;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file MenuCatalog.h
+ * @brief Defines the MenuCatalog class, which loads the menu from a file into immutable versions
+ *        that are swapped in while orders are being taken.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_MENUCATALOG_H
+#define RESTAURANTREAL_MENUCATALOG_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Food.h"
+
+using namespace std;
+
+/**
+ * One version of the menu. Every FOOD code has an item, whether it is listed or not, so foods
+ * ordered from an older version still have a name and the kitchen codes never move.
+ */
+struct MenuSnapshot {
+    static const int HASH_SLOTS = 128;
+
+    uint32_t version = 0; // Counts up from 1, the compiled-in menu
+    MenuItem items[17]; // Indexed by FOOD code
+    uint32_t listed = 0; // Bit per FOOD that can be ordered
+    uint8_t byCategory[4][17]; // Listed FOOD codes per category, in file order
+    uint8_t categoryCount[4] = {}; // Entries used in each byCategory row
+    uint32_t seed = 0; // Seed that makes the lookup hash collision free
+    int8_t slots[HASH_SLOTS]; // FOOD code of each hash slot, -1 for an empty slot
+
+    /**
+     * Looks up an item by its code or display name, ignoring case.
+     *
+     * @param word The code (LAVA_CAKE) or name (Lava Cake).
+     * @return The item, or nullptr if no item has that code or name.
+     */
+    const MenuItem* find(string_view word) const;
+
+    /**
+     * Checks whether a food can be ordered from this version.
+     *
+     * @param code The food code.
+     * @return True if the food is listed.
+     */
+    bool isListed(FOOD code) const;
+};
+
+/**
+ * @class MenuCatalog
+ * @brief Publishes menu versions to readers through a single atomic pointer.
+ *
+ * Menu file, one item per line, '#' starts a comment:
+ *   CODE CATEGORY price prepSeconds Display Name
+ * for example "LAVA_CAKE DESSERT 8.25 300 Lava Cake". Codes are the FOOD enum names and categories
+ * are DRINK, APPETIZER, ENTREE or DESSERT. Foods not in the file are off the menu.
+ *
+ * A load builds the whole new version, then publishes it with a release store; readers take the
+ * current version with one acquire load and never lock. Foods in orders point at the item they were
+ * ordered from, so a replaced version stays allocated until the catalog is destroyed at the end of
+ * the shift rather than being freed once readers move on.
+ */
+class MenuCatalog {
+    private:
+        atomic<const MenuSnapshot*> current{nullptr}; // Version new orders are taken from
+        vector<unique_ptr<MenuSnapshot>> versions; // Every version published, oldest first
+        mutex writer; // Serializes loads; readers never take it
+
+        /**
+         * Indexes the listed items by category and finds a seed for the lookup hash.
+         */
+        static bool build(MenuSnapshot& menu);
+
+        /**
+         * Makes a version current.
+         */
+        void publish(unique_ptr<MenuSnapshot> menu);
+
+    public:
+        /**
+         * Constructor for the MenuCatalog class.
+         * Starts with the compiled-in menu as version 1.
+         */
+        MenuCatalog();
+
+        /**
+         * Retrieves the current version of the menu.
+         *
+         * @return The version, valid until the catalog is destroyed.
+         */
+        const MenuSnapshot& snapshot() const;
+
+        /**
+         * Replaces the menu with the one in a file.
+         * Lines that cannot be parsed are reported and skipped; the current version is kept
+         * if no item could be loaded.
+         *
+         * @param path The menu file.
+         * @return The number of items loaded, or -1 if the menu was not replaced.
+         */
+        int load(const string& path);
+};
+
+#endif //RESTAURANTREAL_MENUCATALOG_H
@@ -0,0 +1,200 @@
+/**
+ * @file NameIndex.cpp
+ * @brief This file contains the NameIndex class, a sorted array of customer names for prefix lookups.
+ * @author Edward Villano
+ */
+
+#include "NameIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <thread>
+
+/**
+ * Compares two names without case.
+ *
+ * @return Negative, zero or positive like strcmp.
+ */
+static int compareNames(string_view a, string_view b){
+    // Names come from the name pool, so the same name is usually the same bytes
+    if (a.data() == b.data() && a.size() == b.size()) {
+        return 0;
+    }
+    size_t length = min(a.size(), b.size());
+    for (size_t i = 0; i < length; i++) {
+        int difference = tolower((unsigned char)a[i]) - tolower((unsigned char)b[i]);
+        if (difference != 0) {
+            return difference;
+        }
+    }
+    return (a.size() < b.size()) ? -1 : (a.size() > b.size());
+}
+
+/**
+ * Checks whether a name starts with a prefix, ignoring case.
+ */
+static bool startsWith(string_view name, string_view prefix){
+    return name.size() >= prefix.size() && compareNames(name.substr(0, prefix.size()), prefix) == 0;
+}
+
+/**
+ * Finds the position of an order's entry, or where it would go.
+ *
+ * @param name The customer name.
+ * @param orderID The order's ID.
+ * @return The first entry not ordered before the name and ID.
+ */
+vector<NameEntry>::iterator NameIndex::position(string_view name, int orderID){
+    return lower_bound(entries.begin(), entries.end(), 0, [&](const NameEntry& entry, int) {
+        int order = compareNames(entry.name, name);
+        return order < 0 || (order == 0 && entry.orderID < orderID);
+    });
+}
+
+/**
+ * Adds an order to the index.
+ *
+ * @param name The customer name, which must outlive the entry.
+ * @param orderID The order's ID.
+ * @param status The order's status.
+ */
+void NameIndex::insert(string_view name, int orderID, Status status){
+    entries.insert(position(name, orderID), NameEntry{name, orderID, status});
+}
+
+/**
+ * Adds many orders to the index at once, as when a state file is loaded.
+ * Inserting them one at a time would shift the array once per order, quadratic in a large file.
+ * Instead the new entries are cut into slices sorted on separate threads, merged pairwise with the
+ * merges of each round also on separate threads, and the result merged with the entries already indexed.
+ *
+ * @param added The orders to add, in any order; sorted in place.
+ * @param threads Number of threads to sort with, at least one.
+ */
+void NameIndex::insertAll(vector<NameEntry>& added, int threads){
+    const size_t minSlice = 16 * 1024;
+    auto before = [](const NameEntry& a, const NameEntry& b) {
+        int order = compareNames(a.name, b.name);
+        return order < 0 || (order == 0 && a.orderID < b.orderID);
+    };
+
+    threads = max(1, min<int>(threads, (added.size() + minSlice - 1) / minSlice));
+    vector<size_t> bounds;
+    for (int k = 0; k <= threads; k++) {
+        bounds.push_back(added.size() * k / threads);
+    }
+
+    // Runs a task per slice, the first on the calling thread
+    auto eachSlice = [](size_t slices, const auto& task) {
+        vector<thread> workers;
+        for (size_t k = 1; k < slices; k++) {
+            workers.emplace_back(task, k);
+        }
+        task(0);
+        for (thread& worker : workers) {
+            worker.join();
+        }
+    };
+
+    eachSlice(bounds.size() - 1, [&](size_t k) {
+        sort(added.begin() + bounds[k], added.begin() + bounds[k + 1], before);
+    });
+    while (bounds.size() > 2) {
+        eachSlice((bounds.size() - 1) / 2, [&](size_t k) {
+            inplace_merge(added.begin() + bounds[2 * k], added.begin() + bounds[2 * k + 1],
+                          added.begin() + bounds[2 * k + 2], before);
+        });
+        vector<size_t> merged;
+        for (size_t k = 0; k < bounds.size(); k += 2) {
+            merged.push_back(bounds[k]);
+        }
+        if (merged.back() != bounds.back()) {
+            merged.push_back(bounds.back());
+        }
+        bounds = std::move(merged);
+    }
+
+    vector<NameEntry> combined;
+    combined.reserve(entries.size() + added.size());
+    merge(entries.begin(), entries.end(), added.begin(), added.end(), back_inserter(combined), before);
+    entries = std::move(combined);
+}
+
+/**
+ * Removes an order from the index.
+ *
+ * @param name The customer name the order was indexed under.
+ * @param orderID The order's ID.
+ */
+void NameIndex::erase(string_view name, int orderID){
+    auto it = position(name, orderID);
+    if (it != entries.end() && it->orderID == orderID) {
+        entries.erase(it);
+    }
+}
+
+/**
+ * Records a status change of an indexed order.
+ *
+ * @param name The customer name the order was indexed under.
+ * @param orderID The order's ID.
+ * @param status The order's new status.
+ */
+void NameIndex::setStatus(string_view name, int orderID, Status status){
+    auto it = position(name, orderID);
+    if (it != entries.end() && it->orderID == orderID) {
+        it->status = status;
+    }
+}
+
+/**
+ * Finds the orders whose customer name starts with a prefix, ignoring case.
+ * All such names sort together, so the matches are one run starting at the prefix's position.
+ *
+ * @param prefix The start of the name.
+ * @param matches Receives the matching entries in name order, after being cleared.
+ * @param limit The most entries to return.
+ * @return The number of entries returned.
+ */
+size_t NameIndex::findPrefix(string_view prefix, vector<NameEntry>& matches, size_t limit){
+    matches.clear();
+    auto it = lower_bound(entries.begin(), entries.end(), prefix, [](const NameEntry& entry, string_view key) {
+        return compareNames(entry.name, key) < 0;
+    });
+    for (; it != entries.end() && matches.size() < limit && startsWith(it->name, prefix); it++) {
+        matches.push_back(*it);
+    }
+    return matches.size();
+}
+
+/**
+ * Retrieves the number of indexed orders.
+ *
+ * @return The number of entries.
+ */
+size_t NameIndex::size(){
+    return entries.size();
+}
+
+/**
+ * Removes many orders from the index in one pass.
+ * The entries' memory is given back once the index has shrunk to less than half of it.
+ *
+ * @param orderIDs The orders' IDs, in ID order.
+ */
+void NameIndex::eraseAll(const vector<int>& orderIDs){
+    entries.erase(remove_if(entries.begin(), entries.end(), [&orderIDs](const NameEntry& entry) {
+        return binary_search(orderIDs.begin(), orderIDs.end(), entry.orderID);
+    }), entries.end());
+    if (entries.size() < entries.capacity() / 2) {
+        entries.shrink_to_fit();
+    }
+}
+
+/**
+ * Retrieves the memory held by the index.
+ *
+ * @return The approximate footprint in bytes.
+ */
+size_t NameIndex::bytesUsed(){
+    return entries.capacity() * sizeof(NameEntry);
+}
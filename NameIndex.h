@@ -0,0 +1,112 @@
+/**
+ * @file NameIndex.h
+ * @brief Defines the NameIndex class, a case-insensitive prefix index from customer names to orders.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_NAMEINDEX_H
+#define RESTAURANTREAL_NAMEINDEX_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "Order.h"
+
+using namespace std;
+
+/**
+ * One order under a customer name.
+ */
+struct NameEntry {
+    string_view name; // Customer name, a view into the system's name pool
+    int orderID;
+    Status status; // Status of the order, kept current by the system
+};
+
+/**
+ * @class NameIndex
+ * @brief Keeps the orders sorted by customer name, ignoring case, so every order whose name starts
+ *        with a prefix is found with one binary search.
+ *
+ * Entries are kept in a flat sorted array ordered by name and then order ID. Inserts and erases
+ * shift the tail of the array, which for a shift's worth of orders is a short memmove, and lookups
+ * stay O(log n + matches) no matter how long the queue gets.
+ */
+class NameIndex {
+    private:
+        vector<NameEntry> entries; // Sorted by name without case, then by order ID
+
+        /**
+         * Finds the position of an order's entry, or where it would go.
+         */
+        vector<NameEntry>::iterator position(string_view name, int orderID);
+
+    public:
+        /**
+         * Adds an order to the index.
+         *
+         * @param name The customer name, which must outlive the entry.
+         * @param orderID The order's ID.
+         * @param status The order's status.
+         */
+        void insert(string_view name, int orderID, Status status);
+
+        /**
+         * Adds many orders to the index at once, as when a state file is loaded.
+         *
+         * @param added The orders to add, in any order; sorted in place.
+         * @param threads Number of threads to sort with, at least one.
+         */
+        void insertAll(vector<NameEntry>& added, int threads);
+
+        /**
+         * Removes an order from the index.
+         *
+         * @param name The customer name the order was indexed under.
+         * @param orderID The order's ID.
+         */
+        void erase(string_view name, int orderID);
+
+        /**
+         * Records a status change of an indexed order.
+         *
+         * @param name The customer name the order was indexed under.
+         * @param orderID The order's ID.
+         * @param status The order's new status.
+         */
+        void setStatus(string_view name, int orderID, Status status);
+
+        /**
+         * Finds the orders whose customer name starts with a prefix, ignoring case.
+         *
+         * @param prefix The start of the name.
+         * @param matches Receives the matching entries in name order, after being cleared.
+         * @param limit The most entries to return.
+         * @return The number of entries returned.
+         */
+        size_t findPrefix(string_view prefix, vector<NameEntry>& matches, size_t limit);
+
+        /**
+         * Retrieves the number of indexed orders.
+         *
+         * @return The number of entries.
+         */
+        size_t size();
+
+        /**
+         * Removes many orders from the index in one pass.
+         * The entries' memory is given back once the index has shrunk to less than half of it.
+         *
+         * @param orderIDs The orders' IDs, in ID order.
+         */
+        void eraseAll(const vector<int>& orderIDs);
+
+        /**
+         * Retrieves the memory held by the index.
+         *
+         * @return The approximate footprint in bytes.
+         */
+        size_t bytesUsed();
+};
+
+#endif //RESTAURANTREAL_NAMEINDEX_H
@@ -6,7 +6,11 @@
  */
 #include "OptionsMenu.h"
 #include <iostream>
+#include <iomanip>
 #include <limits>
+#include <chrono>
+#include <thread>
+#include <sstream>
 
 /**
  * Displays the main menu of the restaurant ordering system.
@@ -24,6 +28,20 @@ void OptionsMenu::DisplayMainMenu() {
     cout << "5. List all orders waiting to be picked up\n";
     cout << "6. Mark order as ready for pick up\n";
     cout << "7. Cancel an order\n";
+    cout << "8. Show batch cooking suggestions\n";
+    cout << "9. Promised time report and deadline scheduling\n";
+    cout << "10. Event bus status\n";
+    cout << "11. Display statistics\n";
+    cout << "12. Reprint receipts\n";
+    cout << "13. Find orders by customer name\n";
+    cout << "14. Edit a placed order\n";
+    cout << "15. End of day price reconciliation\n";
+    cout << "16. Inventory\n";
+    cout << "17. Reload menu\n";
+    cout << "18. Order history\n";
+    cout << "19. Replication status\n";
+    cout << "20. Bulk status change\n";
+    cout << "21. Memory usage\n";
     cout << "0. Exit\n";
     cout << "Enter your choice: ";
 }
@@ -38,54 +56,279 @@ void OptionsMenu::DisplayMainMenu() {
 void OptionsMenu::ProcessChoice(ifstream& inputStreamP, ofstream& outputStreamP) {
 
     POS.fileRead(inputStreamP);
+    if (!leaderPath.empty()) {
+        if (POS.lead(leaderPath)) {
+            cout << "Leading followers on " << leaderPath << endl;
+        } else {
+            cerr << "Another terminal leads " << leaderPath << ", running without replication" << endl;
+        }
+    }
+    if (!tracePath.empty()) {
+        ostringstream state;
+        POS.writeCheckpoint(state);
+        if (recorder.start(tracePath, cin, menuPath, rulesPath, state.str())) {
+            cout << "Recording input to " << tracePath << endl;
+        } else {
+            cerr << "Cannot write trace " << tracePath << ", running without one" << endl;
+        }
+    }
+    runMenu(outputStreamP);
+}
+
+/**
+ * Follows the leader on a socket, keeping a copy of its orders, until it goes away.
+ * If the leader shut down normally the copy is written to the output file and the program ends.
+ * If it was lost, this terminal tries to take over the socket and then runs the main menu on the
+ * copy; when another follower was first, this one follows the new leader instead.
+ * A follower started before any leader waits for one.
+ *
+ * @param socketPath The leader's socket.
+ * @param historyPath History directory to open on taking over, empty for none.
+ * @param outputStreamP The output file.
+ */
+void OptionsMenu::ProcessFollower(const string& socketPath, const string& historyPath, ofstream& outputStreamP) {
+    const auto retryDelay = chrono::milliseconds(200);
+    bool followed = false;
+    bool waiting = false;
+
+    while (true) {
+        FollowEnd end = POS.follow(socketPath);
+        if (end == LEADER_SHUT_DOWN) {
+            cout << "Leader shut down, stopping" << endl;
+            POS.fileWrite(outputStreamP);
+            cout << "Bye!" << endl;
+            return;
+        }
+        if (end == LEADER_LOST) {
+            cout << "Lost the leader on " << socketPath << endl;
+            followed = true;
+        } else if (!followed) {
+            if (!waiting) {
+                cout << "Waiting for a leader on " << socketPath << endl;
+                waiting = true;
+            }
+            this_thread::sleep_for(retryDelay);
+            continue;
+        }
+
+        if (POS.lead(socketPath)) {
+            cout << "Took over as leader on " << socketPath << endl;
+            break;
+        }
+        // Another follower took over; it is followed once it listens
+        this_thread::sleep_for(retryDelay);
+    }
+
+    if (!historyPath.empty()) {
+        POS.openHistory(historyPath);
+    }
+    runMenu(outputStreamP);
+}
+
+/**
+ * Runs the main menu until the user exits, then writes the orders to the output file.
+ *
+ * @param outputStreamP The output file.
+ */
+void OptionsMenu::runMenu(ofstream& outputStreamP) {
     int choice = -1;
 
     while (choice != 0) {
+        POS.tick();
         DisplayMainMenu();
         choice = menuInput();
-        switch (choice) {
-
-            case 0:
-                POS.fileWrite(outputStreamP);
-                break;
-            case 1:
-                POS.placeOrder();
-                break;
-            case 2:
-                POS.getNextOrderToCook();
-                break;
-            case 3:
-                POS.getOrderDetails();
-                break;
-            case 4:
-                POS.markOrderComplete();
-                break;
-            case 5:
-                POS.listAllOrders();
-                break;
-            case 6:
-                POS.markOrderForPickup();
-                break;
-            case 7:
-                POS.cancelOrder();
-                break;
-            default:
-                cout << "Invalid choice. Please try again.\n";
+        if (choice == 0) {
+            recorder.finish(POS.stateDigest(), POS.report().orders);
+            POS.fileWrite(outputStreamP);
+        } else {
+            runChoice(POS, choice);
         }
     }
     cout << "Bye!" << endl;
 }
 
+/**
+ * Runs the console of a multi-store process.
+ * A store is picked from the list and the main menu then runs on that store's shard, which reads
+ * the prompts of the option while the console waits. The consolidated report and snapshots go
+ * to every store at once. Exiting writes every store's snapshot.
+ *
+ * @param stores The running stores.
+ */
+void OptionsMenu::ProcessStores(StoreShards& stores) {
+    int choice = -1;
+
+    while (choice != 0) {
+        cout << "\n---------------------------------\n";
+        cout << "   Stores   \n";
+        cout << "---------------------------------\n";
+        cout << "1. Work with a store\n";
+        cout << "2. Consolidated report\n";
+        cout << "3. Write every store's snapshot\n";
+        cout << "0. Exit\n";
+        cout << "Enter your choice: ";
+        choice = menuInput(3);
+
+        if (choice == 1) {
+            for (size_t k = 0; k < stores.size(); k++) {
+                cout << (k + 1) << ". " << stores.storeName(k) << "\n";
+            }
+            cout << "Store: ";
+            int store = menuInput(stores.size());
+            int option = -1;
+            while (store > 0 && option != 0) {
+                cout << "\nStore " << stores.storeName(store - 1);
+                DisplayMainMenu();
+                option = menuInput();
+                if (option != 0) {
+                    // Prompts and output of the option come from the store's thread
+                    stores.call(store - 1, [option](RestaurantSystem& POS) {
+                        POS.setEcho(true);
+                        runChoice(POS, option);
+                        POS.tick();
+                        POS.setEcho(false);
+                    });
+                }
+            }
+        } else if (choice == 2) {
+            printStoreReports(stores);
+        } else if (choice == 3 || choice == 0) {
+            int written = stores.snapshot();
+            cout << written << " store snapshots written" << endl;
+        }
+    }
+    cout << "Bye!" << endl;
+}
+
+/**
+ * Prints the consolidated report, a row per store and the totals.
+ *
+ * @param stores The running stores.
+ */
+void OptionsMenu::printStoreReports(StoreShards& stores) {
+    vector<StoreReport> reports = stores.report();
+    StoreReport total;
+
+    cout << "\n" << left << setw(14) << "Store" << right << setw(8) << "Orders" << setw(8) << "Placed"
+         << setw(8) << "Cooking" << setw(9) << "Complete" << setw(8) << "Ready" << setw(13) << "Charged"
+         << "  Wait DT/ON/PH/DD" << "\n";
+    auto row = [](const string& name, const StoreReport& report, bool waits) {
+        char charged[32];
+        snprintf(charged, sizeof(charged), "$%ld.%02ld", report.chargedCents / 100, report.chargedCents % 100);
+        cout << left << setw(14) << name << right << setw(8) << report.orders << setw(8) << report.byStatus[PLACED]
+             << setw(8) << report.byStatus[COOKING] << setw(9) << report.byStatus[COMPLETE]
+             << setw(8) << report.byStatus[READY_FOR_PICKUP] << setw(13) << charged;
+        if (waits) {
+            cout << "  ";
+            for (int type = 0; type < 4; type++) {
+                cout << (type ? "/" : "") << (report.waitSeconds[type] + 59) / 60;
+            }
+            cout << " min";
+        }
+        cout << "\n";
+    };
+
+    for (size_t k = 0; k < reports.size(); k++) {
+        row(stores.storeName(k), reports[k], true);
+        total.orders += reports[k].orders;
+        total.chargedCents += reports[k].chargedCents;
+        for (int i = 0; i < 4; i++) {
+            total.byStatus[i] += reports[k].byStatus[i];
+            total.byType[i] += reports[k].byType[i];
+        }
+    }
+    row("All stores", total, false);
+    cout << flush;
+}
+
+/**
+ * Runs one choice of the main menu on a system.
+ * Shared by the single store menu and the store menu of a multi-store process.
+ *
+ * @param POS The system to run the choice on.
+ * @param choice The choice, 1 to 21.
+ */
+void OptionsMenu::runChoice(RestaurantSystem& POS, int choice) {
+    switch (choice) {
+        case 1:
+            POS.placeOrder();
+            break;
+        case 2:
+            POS.getNextOrderToCook();
+            break;
+        case 3:
+            POS.getOrderDetails();
+            break;
+        case 4:
+            POS.markOrderComplete();
+            break;
+        case 5:
+            POS.listAllOrders();
+            break;
+        case 6:
+            POS.markOrderForPickup();
+            break;
+        case 7:
+            POS.cancelOrder();
+            break;
+        case 8:
+            POS.showCookingBatches();
+            break;
+        case 9:
+            POS.deadlineReport();
+            break;
+        case 10:
+            POS.eventBusStatus();
+            break;
+        case 11:
+            POS.displayStatistics();
+            break;
+        case 12:
+            POS.reprintReceipts();
+            break;
+        case 13:
+            POS.findOrdersByName();
+            break;
+        case 14:
+            POS.editOrder();
+            break;
+        case 15:
+            POS.reconcilePrices();
+            break;
+        case 16:
+            POS.manageInventory();
+            break;
+        case 17:
+            POS.reloadMenu();
+            break;
+        case 18:
+            POS.historyReport();
+            break;
+        case 19:
+            POS.replicationStatus();
+            break;
+        case 20:
+            POS.bulkStatusChange();
+            break;
+        case 21:
+            POS.memoryReport();
+            break;
+        default:
+            cout << "Invalid choice. Please try again.\n";
+    }
+}
+
 /**
  * Captures and validates user input for menu selection.
  * This function ensures that the input is a valid integer within the expected range.
  * It repeatedly prompts the user for input until a valid number is entered.
  *
+ * @param maxChoice The highest choice on the menu.
  * @return The validated choice entered by the user.
  */
-int OptionsMenu::menuInput(){
+int OptionsMenu::menuInput(int maxChoice){
     int choice = -1;
-    while (choice > 7 || choice < 0) {
+    while (choice > maxChoice || choice < 0) {
         cin >> choice;
         // Check for input failure
         if (cin.fail()) {
@@ -95,4 +338,70 @@ int OptionsMenu::menuInput(){
         }
     }
     return choice;
-}
\ No newline at end of file
+}
+
+/**
+ * Loads the pricing rules new orders are priced with.
+ *
+ * @param path The rules file.
+ */
+void OptionsMenu::setPricingRules(const string& path){
+    rulesPath = path;
+    POS.loadPricingRules(path);
+}
+
+/**
+ * Loads the menu new orders are taken from.
+ *
+ * @param path The menu file.
+ */
+void OptionsMenu::setMenu(const string& path){
+    menuPath = path;
+    POS.loadMenu(path);
+}
+
+/**
+ * Archives finished and cancelled orders in a history directory.
+ *
+ * @param path The history directory.
+ */
+void OptionsMenu::setHistory(const string& path){
+    POS.openHistory(path);
+}
+
+/**
+ * Draws the kitchen display on a terminal or serial device.
+ *
+ * @param path The device or file to draw the kitchen display on.
+ */
+void OptionsMenu::setKitchenDisplay(const string& path){
+    POS.setKitchenDisplay(path);
+}
+
+/**
+ * Leads followers on a socket once the orders are read.
+ *
+ * @param socketPath The socket followers connect to.
+ */
+void OptionsMenu::setLeader(const string& socketPath){
+    leaderPath = socketPath;
+}
+
+/**
+ * Records every line typed into a trace once the orders are read, for TraceReplay.
+ *
+ * @param path The trace file.
+ */
+void OptionsMenu::setTrace(const string& path){
+    tracePath = path;
+}
+
+/**
+ * Holds the orders and everything kept for them under a memory budget, spilling ready orders to
+ * the history when it is exceeded.
+ *
+ * @param bytes The budget in bytes, 0 for no budget.
+ */
+void OptionsMenu::setMemoryBudget(size_t bytes){
+    POS.setMemoryBudget(bytes);
+}
@@ -9,6 +9,8 @@
 #define OPTIONS_MENU_H
 
 #include "RestaurantSystem.h"
+#include "StoreShards.h"
+#include "InputTrace.h"
 
 using namespace std;
 
@@ -23,7 +25,7 @@ public:
     * This method prints the options available to the user, including placing orders,
     * getting order details, marking orders as complete, and exiting the program.
     */
-    void DisplayMainMenu();
+    static void DisplayMainMenu();
 
     /**
      * Reads and stores orders from input file
@@ -36,18 +38,119 @@ public:
      */
     void ProcessChoice(ifstream& inputStreamP, ofstream& outputStreamP);
 
+    /**
+     * Follows the leader on a socket, keeping a copy of its orders.
+     * When the leader shuts down the copy is written to the output file; when it is lost this
+     * terminal takes over as leader, if no other follower did first, and runs the main menu.
+     *
+     * @param socketPath The leader's socket.
+     * @param historyPath History directory to open on taking over, empty for none.
+     * @param outputStreamP The output file.
+     */
+    void ProcessFollower(const string& socketPath, const string& historyPath, ofstream& outputStreamP);
+
+    /**
+     * Runs the console of a multi-store process.
+     * A store is picked and the main menu runs on that store's own thread; the consolidated
+     * report and snapshots go to every store at once. Exiting writes every store's snapshot.
+     *
+     * @param stores The running stores.
+     */
+    static void ProcessStores(StoreShards& stores);
+
+    /**
+     * Runs one choice of the main menu on a system.
+     *
+     * @param POS The system to run the choice on.
+     * @param choice The choice, 1 to 21.
+     */
+    static void runChoice(RestaurantSystem& POS, int choice);
+
     /**
      * Captures and validates user input for menu selection.
      * This method ensures that the input is a valid integer within the expected range.
      * It repeatedly prompts the user for input until a valid number is entered.
      *
+     * @param maxChoice The highest choice on the menu.
      * @return The validated choice entered by the user.
      */
-    int menuInput();
+    static int menuInput(int maxChoice = 21);
+
+    /**
+     * Loads the pricing rules new orders are priced with.
+     *
+     * @param path The rules file.
+     */
+    void setPricingRules(const string& path);
+
+    /**
+     * Loads the menu new orders are taken from.
+     *
+     * @param path The menu file.
+     */
+    void setMenu(const string& path);
+
+    /**
+     * Archives finished and cancelled orders in a history directory.
+     *
+     * @param path The history directory.
+     */
+    void setHistory(const string& path);
+
+    /**
+     * Draws the kitchen display on a terminal or serial device.
+     *
+     * @param path The device or file to draw the kitchen display on.
+     */
+    void setKitchenDisplay(const string& path);
+
+    /**
+     * Leads followers on a socket once the orders are read.
+     *
+     * @param socketPath The socket followers connect to.
+     */
+    void setLeader(const string& socketPath);
+
+    /**
+     * Records every line typed into a trace once the orders are read, for TraceReplay.
+     *
+     * @param path The trace file.
+     */
+    void setTrace(const string& path);
+
+    /**
+     * Holds the orders under a memory budget, spilling ready orders to the history past it.
+     *
+     * @param bytes The budget in bytes, 0 for no budget.
+     */
+    void setMemoryBudget(size_t bytes);
 
 private:
+    /**
+     * Runs the main menu until the user exits, then writes the orders to the output file.
+     *
+     * @param outputStreamP The output file.
+     */
+    void runMenu(ofstream& outputStreamP);
+
+    /**
+     * Prints the consolidated report of every store.
+     *
+     * @param stores The running stores.
+     */
+    static void printStoreReports(StoreShards& stores);
+
     // Instance of RestaurantSystem to manage restaurant operations.
     RestaurantSystem POS = RestaurantSystem();
+
+    // Socket to lead followers on, empty to run alone
+    string leaderPath;
+
+    // Files loaded and trace to record, kept so a trace can name what it ran with
+    string menuPath;
+    string rulesPath;
+    string tracePath;
+    TraceRecorder recorder;
 };
 
 #endif // OPTIONS_MENU_H
\ No newline at end of file
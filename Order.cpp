@@ -11,6 +11,9 @@
 #include <iomanip>
 #include <string>
 #include <algorithm>
+#include <limits>
+#include "ReceiptFormatter.h"
+#include "ShiftClock.h"
 
 /**
  * Default constructor for the Order class.
@@ -23,14 +26,18 @@ Order::Order() = default;
  * Initializes an Order object with specified order ID, name, and type.
  *
  * @param orderIDP The unique identifier for the order.
- * @param nameP The name associated with the order.
+ * @param nameIDP The ID of the name in the system's name pool.
+ * @param nameP The name associated with the order, as stored in the name pool.
  * @param typeP The type of the order (e.g., DRIVE_THROUGH, ONSITE).
  */
-Order::Order(int orderIDP, string nameP, OrderType typeP){
+Order::Order(int orderIDP, uint32_t nameIDP, string_view nameP, OrderType typeP){
     orderID = orderIDP;
+    nameID = nameIDP;
     name = nameP;
     type = typeP;
+    feePercent = serviceFeePercent[type];
     status = PLACED;
+    placedTime = ShiftClock::now();
     if (type == DRIVE_THROUGH || type == ONSITE){
         skipCount = -1;
     } else {
@@ -44,31 +51,91 @@ Order::Order(int orderIDP, string nameP, OrderType typeP){
  * Specifically for file reading.
  *
  * @param orderIDP
+ * @param nameIDP
  * @param nameP
  * @param typeP
- * @param mealP
+ * @param mealP The meal, interned in the system's meal table
  * @param skipCountP
  * @param statusP
  */
-Order::Order(int orderIDP, string nameP, OrderType typeP,
-             vector <Food> mealP, int skipCountP, Status statusP   ){
+Order::Order(int orderIDP, uint32_t nameIDP, string_view nameP, OrderType typeP,
+             const Meal* mealP, int skipCountP, Status statusP){
+    meal = mealP;
     orderID = orderIDP;
+    nameID = nameIDP;
     name = nameP;
     type = typeP;
-    meal = mealP;
-    skipCount = 0;
+    feePercent = serviceFeePercent[type];
+    skipCount = skipCountP;
     status = statusP;
+    placedTime = ShiftClock::now();
+}
+
+/**
+ * Prompts for one item of a category and adds it to the items being chosen.
+ * Sold-out items are marked in the list and refused, items running low show the portions left.
+ *
+ * @param menu The menu version the item is chosen from.
+ * @param category The category to list.
+ * @param inventory Stock the item is reserved from.
+ * @param items The items chosen so far.
+ */
+void Order::chooseItem(const MenuSnapshot& menu, FoodCategory category, Inventory& inventory, vector<Food>& items){
+    static const char* const titles[4] = {"Drinks", "Appetizers", "Entrees", "Deserts"};
+    const uint8_t* codes = menu.byCategory[category];
+    int count = menu.categoryCount[category];
+    int choice2 = -1;
+
+    if (count == 0) {
+        cout << "\nNo " << titles[category] << " on the menu right now." << endl;
+        return;
+    }
+
+    while (choice2 < 1 || choice2 > count) {
+        cout << "\n" << titles[category] << ":\n";
+        for (int i = 0; i < count; i++) {
+            FOOD food = static_cast<FOOD>(codes[i]);
+            cout << " " << (i + 1) << ". " << menu.items[food].name;
+            if (!inventory.isAvailable(food)) {
+                cout << " (sold out)";
+            } else if (inventory.isLow(food)) {
+                cout << " (" << inventory.getStock(food) << " left)";
+            }
+            cout << "\n";
+        }
+        cout << " 0. Back to item type selection" << endl;
+
+        cin >> choice2;
+
+        if (choice2 == 0) {
+            break;
+        } else if (choice2 < 0 || choice2 > count) {
+            cout << "Invalid input, please try again." << endl;
+        } else {
+            FOOD food = static_cast<FOOD>(codes[choice2 - 1]);
+            if (inventory.isAvailable(food) && inventory.reserve(food)) {
+                items.push_back(Food(menu.items[food]));
+            } else {
+                cout << menu.items[food].name << " is sold out, please choose something else." << endl;
+                choice2 = -1;
+            }
+        }
+    }
 }
+
 /**
  * Adds meals to the order based on user input.
  * Allows the user to continually add items to the order and returns true if any meal was added.
+ * Every item added takes a portion from the inventory and is charged at the menu version's price.
+ * The items chosen are interned once, when the user stops adding.
  *
+ * @param menu The menu version the items are chosen from.
+ * @param inventory Stock the items are reserved from.
+ * @param meals The meal table the new meal is interned in.
  * @return True if at least one meal is added to the order, false if the user exits the menu without adding.
  */
-bool Order::addMeal(){
-    int choice1, choice2;
-
-    choice1 = choice2 = -1;
+bool Order::addMeal(const MenuSnapshot& menu, Inventory& inventory, MealTable& meals){
+    int choice1 = -1;
 
     cout << "\nSelect Item Type To Add:\n"
             " 1. Drink\n"
@@ -81,106 +148,29 @@ bool Order::addMeal(){
     if (choice1 == 0){
         return false;
     }
+    vector<Food> items(meal->items.begin(), meal->items.end());
 
     while (choice1 != 0) {
 
-        choice2 = -1;
-
         cin.ignore();
         cin.clear();
 
 
         switch (choice1) {
             case 1:
-                while (choice2 < 1 || choice2 > 6) {
-                    cout << "\nDrinks:\n"
-                            " 1. Water\n"
-                            " 2. Soda\n"
-                            " 3. Tea\n"
-                            " 4. Coffee\n"
-                            " 5. Beer\n"
-                            " 6. Mixed Drink\n"
-                            " 0. Back to item type selection"
-                         << endl;
-
-                    cin >> choice2;
-
-                    if (choice2 < 0 || choice2 > 6) {
-                        cout << "Invalid input, please try again." << endl;
-                    }
-
-                    if (choice2 == 0){
-                        break;
-                    } else {
-                        meal.push_back(Food(static_cast<FOOD>(choice2-1)));
-                    }
-                }
+                chooseItem(menu, DRINK, inventory, items);
                 break;
 
             case 2:
-                while (choice2 < 1 || choice2 > 3) {
-                    cout << "\nAppetizers:\n"
-                            " 1. Wings\n"
-                            " 2. Quesadillas\n"
-                            " 3. Fried Mozzarella\n"
-                            " 0. Back to item type selection" << endl;
-
-                    cin >> choice2;
-
-                    if (choice2 < 0 || choice2 > 3) {
-                        cout << "Invalid input, please try again." << endl;
-                    }
-
-                    if (choice2 == 0) {
-                        break;
-                    } else {
-                        meal.push_back(Food(static_cast<FOOD>(choice2 + 5)));
-                    }
-                }
+                chooseItem(menu, APPETIZER, inventory, items);
                 break;
 
             case 3:
-                while (choice2 < 1 || choice2 > 5) {
-                    cout << "\nEntrees:\n"
-                            " 1. Hamburger\n"
-                            " 2. Cheeseburger\n"
-                            " 3. Four Chicken Tenders\n"
-                            " 4. Grilled Salmon\n"
-                            " 5. Vegetable Rice Bowl\n"
-                            " 0. Back to item type selection" << endl;
-                    cin >> choice2;
-
-                    if (choice2 < 0 || choice2 > 5) {
-                        cout << "Invalid input, please try again." << endl;
-                    }
-
-                    if (choice2 == 0) {
-                        break;
-                    } else {
-                        meal.push_back(Food(static_cast<FOOD>(choice2 + 8)));
-                    }
-                }
+                chooseItem(menu, ENTREE, inventory, items);
                 break;
 
             case 4:
-                while (choice2 < 1 || choice2 > 3) {
-                    cout << "\nDeserts:\n"
-                            " 1. Apple Pie\n"
-                            " 2. Lava Cake\n"
-                            " 3. Ice Cream\n"
-                            " 0. Back to item type selection" << endl;
-                    cin >> choice2;
-
-                    if (choice2 < 0 || choice2 > 3) {
-                        cout << "Invalid input, please try again." << endl;
-                    }
-
-                    if (choice2 == 0) {
-                        break;
-                    } else {
-                        meal.push_back(Food(static_cast<FOOD>(choice2 + 13)));
-                    }
-                }
+                chooseItem(menu, DESSERT, inventory, items);
                 break;
 
             default:
@@ -196,21 +186,116 @@ bool Order::addMeal(){
                 " 0. Stop adding" << endl;
         cin >> choice1;
     }
+    if (status == PLACED) {
+        meal = meals.intern(items);
+    }
     return true;
 };
 
 /**
- * Calculates and returns the total amount of the order.
- * Adds up the prices of each food item in the order.
+ * Adds one food item to a placed order, moving it to the meal with that item.
+ *
+ * @param item The item to add.
+ * @param meals The meal table the new meal is interned in.
+ * @return True if the item was added, false if the order is no longer placed.
+ */
+bool Order::addItem(Food item, MealTable& meals){
+    if (status != PLACED) {
+        return false;
+    }
+    meal = meals.with(meal, item);
+    return true;
+}
+
+/**
+ * Removes one food item from a placed order, moving it to the meal without that item.
+ *
+ * @param position Position of the item in the meal.
+ * @param meals The meal table the new meal is interned in.
+ * @return True if the item was removed, false if the order is no longer placed
+ * or the position is out of range.
+ */
+bool Order::removeItem(size_t position, MealTable& meals){
+    if (status != PLACED || position >= meal->items.size()) {
+        return false;
+    }
+    meal = meals.without(meal, position);
+    return true;
+}
+
+/**
+ * Retrieves the amount of the order before fees.
  *
- * @return The total price of the order as a double.
+ * @return The meal total in dollars.
  */
 double Order::getAmount(){
-    double amount = 0.00;
-    for(Food& e: meal ){
-        amount += e.getPrice();
-    };
-    return amount;
+    return meal->subtotalCents / 100.0;
+}
+
+/**
+ * Retrieves the meal total before fees.
+ *
+ * @return The subtotal in cents.
+ */
+long Order::getSubtotalCents(){
+    return meal->subtotalCents;
+}
+
+/**
+ * Retrieves the discount given by the pricing rules.
+ *
+ * @return The discount in cents.
+ */
+long Order::getDiscountCents(){
+    return discountCents;
+}
+
+/**
+ * Retrieves the service fee percentage charged for the order.
+ *
+ * @return The fee in percent.
+ */
+int Order::getFeePercent(){
+    return feePercent;
+}
+
+/**
+ * Sets the discount and service fee the pricing rules give the order.
+ * The order is repriced whenever its meal changes, so the discount matches the cached subtotal.
+ *
+ * @param discountCentsP The discount in cents.
+ * @param feePercentP The service fee in percent.
+ */
+void Order::setPricing(long discountCentsP, int feePercentP){
+    discountCents = discountCentsP;
+    feePercent = feePercentP;
+}
+
+/**
+ * Retrieves the service fee charged on the discounted subtotal.
+ *
+ * @return The fee in cents, rounded to the nearest cent.
+ */
+long Order::getFeeCents(){
+    return ((meal->subtotalCents - discountCents) * feePercent + 50) / 100;
+}
+
+/**
+ * Retrieves the amount charged for the order, discount and fee included.
+ *
+ * @return The total in cents.
+ */
+long Order::getTotalCents(){
+    return meal->subtotalCents - discountCents + getFeeCents();
+}
+
+/**
+ * Retrieves the expected preparation time of the order.
+ *
+ * @return The expected preparation time in seconds.
+ */
+int Order::getPrepTime(){
+    return meal->prepSeconds;
 };
 
 /**
@@ -231,6 +316,16 @@ void Order::increaseSkipCount(){
     }
 };
 
+/**
+ * Raises the skip count of the order to its maximum so it is served
+ * ahead of higher priority types. Only phone and Doordash orders carry a skip count.
+ */
+void Order::escalate(){
+    if (skipCount >= 0) {
+        skipCount = 3;
+    }
+}
+
 /**
  * Retrieves the type of the order.
  *
@@ -249,27 +344,171 @@ int Order::getOrderID(){
     return orderID;
 };
 
+/**
+ * Retrieves the food items in the order.
+ *
+ * @return The shared meal's items, in canonical order.
+ */
+const pmr::vector<Food>& Order::getMeal(){
+    return meal->items;
+}
+
+/**
+ * Retrieves the shared meal of the order, with its precomputed totals.
+ *
+ * @return The meal, valid for the lifetime of the system's meal table.
+ */
+const Meal* Order::getSharedMeal(){
+    return meal;
+}
+
+/**
+ * Retrieves the ID of the order's meal in the system's meal table.
+ *
+ * @return The meal ID, 0 for an order with no items.
+ */
+uint32_t Order::getMealID(){
+    return meal->id;
+}
+
+/**
+ * Points the order at another meal of the meal table.
+ * The totals come with the meal, so the order is repriced by the caller as after an edit.
+ *
+ * @param mealP The meal.
+ */
+void Order::setMeal(const Meal* mealP){
+    meal = mealP;
+}
+
+/**
+ * Retrieves the time the order was placed.
+ *
+ * @return The placement time as a time_t.
+ */
+time_t Order::getPlacedTime(){
+    return placedTime;
+}
+
+/**
+ * Sets the time the order was placed, for orders restored from history.
+ *
+ * @param placedTimeP The placement time.
+ */
+void Order::setPlacedTime(time_t placedTimeP){
+    placedTime = placedTimeP;
+}
+
+/**
+ * Checks whether a pickup time was promised for the order.
+ *
+ * @return True if the order carries a promised time.
+ */
+bool Order::hasPromisedTime(){
+    return promisedTime != 0;
+}
+
+/**
+ * Retrieves the promised pickup time of the order.
+ *
+ * @return The promised time, or 0 if none was promised.
+ */
+time_t Order::getPromisedTime(){
+    return promisedTime;
+}
+
+/**
+ * Sets the promised pickup time of the order.
+ *
+ * @param promisedTimeP The promised time, or 0 to clear the promise.
+ */
+void Order::setPromisedTime(time_t promisedTimeP){
+    promisedTime = promisedTimeP;
+}
+
+/**
+ * Retrieves the handle of the order's armed service level timer.
+ *
+ * @return The timer handle, or -1 if none is armed.
+ */
+int Order::getSlaTimer(){
+    return slaTimer;
+}
+
+/**
+ * Sets the handle of the order's armed service level timer.
+ *
+ * @param slaTimerP The timer handle, or -1 if none is armed.
+ */
+void Order::setSlaTimer(int slaTimerP){
+    slaTimer = slaTimerP;
+}
+
+/**
+ * Retrieves the handle of the order's task in the kitchen pipeline.
+ *
+ * @return The task handle, or -1 if the order has no task.
+ */
+int Order::getTask(){
+    return task;
+}
+
+/**
+ * Sets the handle of the order's task in the kitchen pipeline.
+ *
+ * @param taskP The task handle, or -1 if the order has no task.
+ */
+void Order::setTask(int taskP){
+    task = taskP;
+}
+
+/**
+ * Checks whether the order's food was flagged as cold.
+ *
+ * @return True if the order waited for pickup past its service level.
+ */
+bool Order::isCold(){
+    return cold;
+}
+
+/**
+ * Flags the order's food as cold.
+ */
+void Order::markCold(){
+    cold = true;
+}
+
 /**
  * Retrieves the name associated with the order.
  *
- * @return The name as a string.
+ * @return A view of the name, valid for the lifetime of the system's name pool.
  */
-string Order::getName(){
+string_view Order::getName(){
     return name;
 }
 
+/**
+ * Retrieves the ID of the order's name in the system's name pool.
+ *
+ * @return The name ID.
+ */
+uint32_t Order::getNameID(){
+    return nameID;
+}
+
 /**
  * Retrieve the size of vector meal
- * followed by each food enum value
+ * followed by each food enum value and the price it was charged in cents
  *
- * @return meal size and each food enum
+ * @return meal size and each food enum with its price
  */
 string Order::mealToString(){
+    const pmr::vector<Food>& items = meal->items;
     string s;
-    s = to_string(meal.size());
+    s = to_string(items.size());
 
-    for (int i = 0; i < meal.size(); i++){
-        s +=( " " + meal[i].getEnumToString());
+    for (int i = 0; i < items.size(); i++){
+        s +=( " " + to_string(items[i].getFood()) + " " + to_string(items[i].getPriceCents()));
     }
 
     return s;
@@ -278,42 +517,32 @@ string Order::mealToString(){
 /**
  * Prints the details of the order, including all food items, their prices, and the total amount.
  * If the order is a Doordash order, a service fee is included in the total amount.
+ * The receipt is rendered into a stack buffer by the receipt formatter and written in one call;
+ * the order itself is left unchanged.
  *
  * @param input A boolean flag to indicate if additional user interaction is required after printing.
  */
 void Order::print(bool input){
-    string trash;
-    transform(name.begin(), name.end(), name.begin(), ::toupper);
-
-    double total = 0.00;
+    static ReceiptFormatter formatter;
+    char receipt[2048];
+    ReceiptCopy copy = input ? CUSTOMER_COPY : KITCHEN_COPY;
 
-if(input){
-    cout << endl << "---------------------------------" << endl;
-    cout << "    THANK YOU " << setw(10) << name << "!" << endl;
-    cout << "---------------------------------" << endl << endl;
-}
-else{
-    cout << endl << setw(10) << name << "   " << orderID << endl;
-}
-    for(int i = 0; i < meal.size(); i++){
-        meal[i].print();
-        total += meal[i].getPrice();
-    }
-    if(getOrderType() == 3) {
-        cout << endl << setw(15) << "Doordash Service Fee = 5%" << endl;
-        cout << setw(15) <<  "Total Price: $" << (total*1.05) << endl;
-    }
-    else{
-        cout << endl << setw(15) << "Total Price: $" << total << endl;
+    size_t length = formatter.format(*this, copy, receipt, sizeof(receipt));
+    if (length > 0) {
+        cout.write(receipt, length);
+    } else {
+        // Only unusually large orders outgrow the stack buffer
+        vector<char> large(sizeof(receipt) + 64 * meal->items.size());
+        length = formatter.format(*this, copy, large.data(), large.size());
+        cout.write(large.data(), length);
     }
 
     if(input) {
-        cout << endl << "---------------------------------" << endl;
-        cout << "\nPress enter to continue...";
+        cout << "\nPress enter to continue..." << flush;
 
         cin.ignore();
         cin.clear();
-        getline(cin, trash);
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
     }
 }
 
@@ -327,7 +556,8 @@ Status Order::getOrderStatus(){
 }
 
 /**
- * Sets the status of the order to a new value and prints the update.
+ * Sets the status of the order to a new value.
+ * Announcing the change is left to the subscribers of the system's event bus.
  *
  * @param statusP The new status to set, represented as an integer.
  * @return The updated status as a Status enum.
@@ -335,7 +565,5 @@ Status Order::getOrderStatus(){
 Status Order::setOrderStatus(int statusP){
     status = static_cast<Status>(statusP + 1);
 
-    cout << "Order #" << orderID << " marked as " << StatusList[status] << endl;
-
     return status;
 }
\ No newline at end of file
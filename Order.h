@@ -9,8 +9,14 @@
 #define RESTAURANTREAL_ORDER_H
 
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include "Food.h"
+#include "Inventory.h"
+#include "MenuCatalog.h"
+#include "MealTable.h"
 #include <vector>
+#include <ctime>
 
 using namespace std;
 
@@ -29,6 +35,36 @@ const string OrderTypeList[4]{
         "DOORDASH"
 };
 
+/**
+ * Service fee charged on top of the meal total, in percent, for each OrderType.
+ */
+const int serviceFeePercent[4] = {
+        0,  // DRIVE_THROUGH
+        0,  // ONSITE
+        0,  // PHONE
+        5   // DOORDASH
+};
+
+/**
+ * Seconds an order of each OrderType may wait in PLACED before it is escalated.
+ */
+const int placedSlaSeconds[4] = {
+        180,  // DRIVE_THROUGH
+        600,  // ONSITE
+        900,  // PHONE
+        900   // DOORDASH
+};
+
+/**
+ * Seconds an order of each OrderType may wait ready for pickup before its food is flagged as cold.
+ */
+const int pickupSlaSeconds[4] = {
+        120,  // DRIVE_THROUGH
+        300,  // ONSITE
+        600,  // PHONE
+        600   // DOORDASH
+};
+
 enum Status {
     PLACED,
     COOKING,
@@ -48,17 +84,33 @@ const string StatusList[5]{
  * @brief Represents an individual order in the restaurant system.
  *
  * Contains information about the order ID, type, the meals included, customer name, order status, and skip count.
+ * The meal is a shared composition of the system's meal table, so orders with the same items hold one pointer
+ * to the same meal and its precomputed totals.
  */
 class Order {
     private:
         int orderID; // Unique identifier for the order
         OrderType type; // Type of the order (DRIVE_THROUGH, ONSITE, etc.)
-        vector<Food> meal; // List of food items in the order
+        const Meal* meal = &MealTable::EMPTY; // Food items of the order, shared with every order of the same items
+        long discountCents = 0; // Taken off the subtotal by the pricing rules
+        int feePercent = 0; // Service fee charged on the discounted subtotal
         int skipCount; // Skip count for the order, relevant for certain order types
-        string name; // Customer name associated with the order
+        string_view name; // Customer name, interned in the system's name pool
+        uint32_t nameID; // ID of the name in the system's name pool
         Status status; // Current status of the order (PLACED, COOKING, etc.)
+        time_t placedTime; // Time the order was placed or loaded into the system
+        time_t promisedTime = 0; // Promised pickup time, 0 when no time was promised
+        int slaTimer = -1; // Handle of the armed service level timer, -1 when none is armed
+        int task = -1; // Handle of the order's task in the system's pipeline, -1 when it has none
+        bool cold = false; // Whether the food sat ready for pickup past its service level
+
+        /**
+         * Prompts for one item of a category and adds it to the items being chosen.
+         */
+        void chooseItem(const MenuSnapshot& menu, FoodCategory category, Inventory& inventory, vector<Food>& items);
 
     public:
+
         /**
          * Default constructor for the Order class.
          * Initializes an Order object with default values.
@@ -70,10 +122,11 @@ class Order {
         * Initializes an Order object with specified order ID, name, and type.
         *
         * @param orderIDP The unique identifier for the order.
-        * @param nameP The name associated with the order.
+        * @param nameIDP The ID of the name in the system's name pool.
+        * @param nameP The name associated with the order, as stored in the name pool.
         * @param typeP The type of the order (e.g., DRIVE_THROUGH, ONSITE).
         */
-        Order(int orderIDP, string nameP, OrderType typeP);
+        Order(int orderIDP, uint32_t nameIDP, string_view nameP, OrderType typeP);
 
         /**
          * Constructor for Order class with additional parameters
@@ -81,31 +134,105 @@ class Order {
          * Specifically for file reading.
          *
          * @param orderIDP
+         * @param nameIDP
          * @param nameP
          * @param typeP
-         * @param mealP
+         * @param mealP The meal, interned in the system's meal table
          * @param skipCountP
          * @param statusP
          */
-        Order(int orderIDP, string nameP, OrderType typeP,
-          vector <Food> mealP, int skipCountP, Status statusP);
+        Order(int orderIDP, uint32_t nameIDP, string_view nameP, OrderType typeP,
+          const Meal* mealP, int skipCountP, Status statusP);
 
         /**
         * Adds meals to the order based on user input.
         * Allows the user to continually add items to the order and returns true if any meal was added.
+        * Every item added takes a portion from the inventory and is charged at the menu version's price.
+        * The items chosen are interned once, when the user stops adding.
         *
+        * @param menu The menu version the items are chosen from.
+        * @param inventory Stock the items are reserved from.
+        * @param meals The meal table the new meal is interned in.
         * @return True if at least one meal is added to the order, false if the user exits the menu without adding.
         */
-        bool addMeal();
+        bool addMeal(const MenuSnapshot& menu, Inventory& inventory, MealTable& meals);
+
+        /**
+        * Adds one food item to a placed order, moving it to the meal with that item.
+        *
+        * @param item The item to add.
+        * @param meals The meal table the new meal is interned in.
+        * @return True if the item was added, false if the order is no longer placed.
+        */
+        bool addItem(Food item, MealTable& meals);
 
         /**
-        * Calculates and returns the total amount of the order.
-        * Adds up the prices of each food item in the order.
+        * Removes one food item from a placed order, moving it to the meal without that item.
         *
-        * @return The total price of the order as a double.
+        * @param position Position of the item in the meal.
+        * @param meals The meal table the new meal is interned in.
+        * @return True if the item was removed, false if the order is no longer placed
+        * or the position is out of range.
+        */
+        bool removeItem(size_t position, MealTable& meals);
+
+        /**
+        * Retrieves the amount of the order before fees.
+        *
+        * @return The meal total in dollars.
         */
         double getAmount();
 
+        /**
+        * Retrieves the meal total before fees.
+        *
+        * @return The subtotal in cents.
+        */
+        long getSubtotalCents();
+
+        /**
+        * Retrieves the discount given by the pricing rules.
+        *
+        * @return The discount in cents.
+        */
+        long getDiscountCents();
+
+        /**
+        * Retrieves the service fee percentage charged for the order.
+        *
+        * @return The fee in percent.
+        */
+        int getFeePercent();
+
+        /**
+        * Sets the discount and service fee the pricing rules give the order.
+        *
+        * @param discountCentsP The discount in cents.
+        * @param feePercentP The service fee in percent.
+        */
+        void setPricing(long discountCentsP, int feePercentP);
+
+        /**
+        * Retrieves the service fee charged on the discounted subtotal.
+        *
+        * @return The fee in cents, rounded to the nearest cent.
+        */
+        long getFeeCents();
+
+        /**
+        * Retrieves the amount charged for the order, discount and fee included.
+        *
+        * @return The total in cents.
+        */
+        long getTotalCents();
+
+        /**
+        * Retrieves the expected preparation time of the order.
+        *
+        * @return The expected preparation time in seconds.
+        */
+        int getPrepTime();
+
         /**
         * Retrieves the current skip count of the order.
         *
@@ -118,6 +245,12 @@ class Order {
         */
         void increaseSkipCount();
 
+        /**
+        * Raises the skip count of the order to its maximum so it is served
+        * ahead of higher priority types. Only phone and Doordash orders carry a skip count.
+        */
+        void escalate();
+
         /**
         * Retrieves the type of the order.
         *
@@ -132,16 +265,127 @@ class Order {
          */
         int getOrderID();
 
+        /**
+         * Retrieves the food items in the order.
+         *
+         * @return The shared meal's items, in canonical order.
+         */
+        const pmr::vector<Food>& getMeal();
+
+        /**
+         * Retrieves the shared meal of the order, with its precomputed totals.
+         *
+         * @return The meal, valid for the lifetime of the system's meal table.
+         */
+        const Meal* getSharedMeal();
+
+        /**
+         * Retrieves the ID of the order's meal in the system's meal table.
+         *
+         * @return The meal ID, 0 for an order with no items.
+         */
+        uint32_t getMealID();
+
+        /**
+         * Points the order at another meal of the meal table.
+         *
+         * @param mealP The meal.
+         */
+        void setMeal(const Meal* mealP);
+
+        /**
+         * Retrieves the time the order was placed.
+         *
+         * @return The placement time as a time_t.
+         */
+        time_t getPlacedTime();
+
+        /**
+         * Sets the time the order was placed, for orders restored from history.
+         *
+         * @param placedTimeP The placement time.
+         */
+        void setPlacedTime(time_t placedTimeP);
+
+        /**
+         * Checks whether a pickup time was promised for the order.
+         *
+         * @return True if the order carries a promised time.
+         */
+        bool hasPromisedTime();
+
+        /**
+         * Retrieves the promised pickup time of the order.
+         *
+         * @return The promised time, or 0 if none was promised.
+         */
+        time_t getPromisedTime();
+
+        /**
+         * Sets the promised pickup time of the order.
+         *
+         * @param promisedTimeP The promised time, or 0 to clear the promise.
+         */
+        void setPromisedTime(time_t promisedTimeP);
+
+        /**
+         * Retrieves the handle of the order's armed service level timer.
+         *
+         * @return The timer handle, or -1 if none is armed.
+         */
+        int getSlaTimer();
+
+        /**
+         * Sets the handle of the order's armed service level timer.
+         *
+         * @param slaTimerP The timer handle, or -1 if none is armed.
+         */
+        void setSlaTimer(int slaTimerP);
+
+        /**
+         * Retrieves the handle of the order's task in the kitchen pipeline.
+         *
+         * @return The task handle, or -1 if the order has no task.
+         */
+        int getTask();
+
+        /**
+         * Sets the handle of the order's task in the kitchen pipeline.
+         *
+         * @param taskP The task handle, or -1 if the order has no task.
+         */
+        void setTask(int taskP);
+
+        /**
+         * Checks whether the order's food was flagged as cold.
+         *
+         * @return True if the order waited for pickup past its service level.
+         */
+        bool isCold();
+
+        /**
+         * Flags the order's food as cold.
+         */
+        void markCold();
+
         /**
          * Retrieves the name associated with the order.
          *
-         * @return The name as a string.
+         * @return A view of the name, valid for the lifetime of the system's name pool.
+         */
+        string_view getName();
+
+        /**
+         * Retrieves the ID of the order's name in the system's name pool.
+         *
+         * @return The name ID.
          */
-        string getName();
+        uint32_t getNameID();
 
         /**
          * Prints the details of the order, including all food items, their prices, and the total amount.
          * If the order is a Doordash order, a service fee is included in the total amount.
+         * The order itself is left unchanged.
          *
          * @param input A boolean flag to indicate if additional user interaction is required after printing.
          */
@@ -156,14 +400,14 @@ class Order {
 
         /**
          * Retrieve the size of vector meal
-         * followed by each food enum
+         * followed by each food enum value and the price it was charged in cents
          *
-         * @return meal size and each food enum
+         * @return meal size and each food enum with its price
          */
         string mealToString();
 
         /**
-         * Sets the status of the order to a new value and prints the update.
+         * Sets the status of the order to a new value.
          *
          * @param statusP The new status to set, represented as an integer.
          * @return The updated status as a Status enum.
@@ -0,0 +1,617 @@
+/**
+ * @file OrderHistory.cpp
+ * @brief This file contains the OrderHistory class, hourly segment files of archived orders.
+ * @author Edward Villano
+ */
+
+#include "OrderHistory.h"
+#include "ShiftClock.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * One entry of a .idx file, describing a sealed block.
+ */
+struct IndexEntry {
+    uint64_t offset; // Offset of the block in the .seg file
+    uint32_t bytes; // Bytes of the block as stored
+    uint32_t packedBytes; // Bytes of the packed block before the LZ pass, 0 if it was stored uncompressed
+    uint32_t records; // Records in the block
+    int32_t firstOrderID; // ID of the block's first record, to recognize a tail already sealed
+    int64_t minPlaced; // Earliest placement time in the block
+    int64_t maxPlaced; // Latest placement time in the block
+};
+
+static const size_t ITEM_BYTES = HistoryRecord::ITEM_BYTES;
+
+/**
+ * Retrieves the code of an item of the meal.
+ *
+ * @param i Position of the item.
+ * @return The item's FOOD code.
+ */
+FOOD HistoryEntry::itemCode(int i) const{
+    return static_cast<FOOD>((uint8_t)meal[i * ITEM_BYTES]);
+}
+
+/**
+ * Retrieves the price an item of the meal was charged.
+ *
+ * @param i Position of the item.
+ * @return The price in cents.
+ */
+int32_t HistoryEntry::itemCents(int i) const{
+    int32_t cents;
+    memcpy(&cents, meal + i * ITEM_BYTES + 1, sizeof(cents));
+    return cents;
+}
+
+/**
+ * Retrieves the amount the order was charged, service fee included.
+ * Rounds the fee the same way as Order::getFeeCents.
+ *
+ * @return The total in cents.
+ */
+long HistoryEntry::getTotalCents() const{
+    long net = subtotalCents - discountCents;
+    return net + (net * feePercent + 50) / 100;
+}
+
+/**
+ * Destructor for the OrderHistory class.
+ * Closes the segments being appended to; their open blocks stay in the .tail files for the next open.
+ */
+OrderHistory::~OrderHistory(){
+    for (auto& [hour, segment] : appending) {
+        closeSegment(segment);
+    }
+}
+
+/**
+ * Closes the files of a segment.
+ *
+ * @param segment The segment to close.
+ */
+void OrderHistory::closeSegment(Segment& segment){
+    close(segment.data);
+    close(segment.index);
+    close(segment.tail);
+}
+
+/**
+ * Opens a history directory, creating it if it does not exist.
+ * No segment is read until an order is appended or a query asks for it.
+ *
+ * @param path The history directory.
+ * @return True if the directory can be used.
+ */
+bool OrderHistory::open(const string& path){
+    if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+        cerr << "History directory " << path << " cannot be created: " << strerror(errno) << endl;
+        return false;
+    }
+    directory = path;
+    return true;
+}
+
+/**
+ * Chooses whether sealed blocks are LZ compressed after packing.
+ *
+ * @param enabled True to compress blocks sealed from now on.
+ */
+void OrderHistory::setCompression(bool enabled){
+    compression = enabled;
+}
+
+/**
+ * Checks whether a history directory is open.
+ *
+ * @return True if orders are being archived.
+ */
+bool OrderHistory::isOpen() const{
+    return !directory.empty();
+}
+
+/**
+ * Builds the path of a segment file from its UTC hour.
+ *
+ * @param hour Hours since the epoch.
+ * @param extension ".seg", ".idx" or ".tail".
+ * @return The path in the history directory.
+ */
+string OrderHistory::segmentPath(long hour, const char* extension) const{
+    time_t start = hour * 3600;
+    tm utc;
+    gmtime_r(&start, &utc);
+    char file[32];
+    strftime(file, sizeof(file), "/%Y%m%d-%H", &utc);
+    return directory + file + extension;
+}
+
+/**
+ * Counts the whole plain records at the start of a buffer.
+ *
+ * @param records Plain records back to back.
+ * @param size Bytes in the buffer.
+ * @param count Receives the number of whole records.
+ * @return Bytes of the whole records.
+ */
+static size_t wholeRecords(const char* records, size_t size, uint32_t& count){
+    HistoryRecord header;
+    size_t at = 0;
+    count = 0;
+    while (at + sizeof(header) <= size) {
+        memcpy(&header, records + at, sizeof(header));
+        if (header.length < sizeof(header) || at + header.length > size) {
+            break;
+        }
+        at += header.length;
+        count += 1;
+    }
+    return at;
+}
+
+/**
+ * Opens the segment of an hour for appending.
+ * An existing segment is picked up after its last index entry: a block written without its entry is
+ * cut off, the open block is read back from the .tail file, a record cut short by a crash is truncated
+ * away, and a tail that was sealed but not emptied is dropped.
+ * The oldest hour open is closed when too many are open.
+ *
+ * @param hour Hours since the epoch.
+ * @return The segment, or nullptr if its files cannot be opened.
+ */
+OrderHistory::Segment* OrderHistory::openSegment(long hour){
+    auto found = appending.find(hour);
+    if (found != appending.end()) {
+        return &found->second;
+    }
+
+    if (appending.size() >= MAX_OPEN_SEGMENTS) {
+        // Orders finish roughly in placement order, so the oldest hour is the one done with
+        auto oldest = appending.begin();
+        closeSegment(oldest->second);
+        appending.erase(oldest);
+    }
+
+    Segment segment;
+    segment.data = ::open(segmentPath(hour, ".seg").c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    segment.index = ::open(segmentPath(hour, ".idx").c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    segment.tail = ::open(segmentPath(hour, ".tail").c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (segment.data < 0 || segment.index < 0 || segment.tail < 0) {
+        cerr << "History segment " << segmentPath(hour, ".seg") << " cannot be opened: " << strerror(errno) << endl;
+        closeSegment(segment);
+        return nullptr;
+    }
+
+    struct stat info;
+    fstat(segment.index, &info);
+    size_t entries = info.st_size / sizeof(IndexEntry);
+    IndexEntry last{};
+    if (entries > 0) {
+        pread(segment.index, &last, sizeof(last), (entries - 1) * sizeof(IndexEntry));
+    }
+
+    fstat(segment.data, &info);
+    segment.size = info.st_size;
+    if (segment.size > last.offset + last.bytes) {
+        cerr << "History segment " << segmentPath(hour, ".seg") << " ends in an unindexed block, truncated" << endl;
+        segment.size = last.offset + last.bytes;
+        ftruncate(segment.data, segment.size);
+    }
+
+    fstat(segment.tail, &info);
+    segment.pending.resize(info.st_size);
+    if (pread(segment.tail, segment.pending.data(), info.st_size, 0) != info.st_size) {
+        segment.pending.clear();
+    }
+    size_t whole = wholeRecords(segment.pending.data(), segment.pending.size(), segment.pendingCount);
+
+    HistoryRecord header;
+    if (whole > 0) {
+        memcpy(&header, segment.pending.data(), sizeof(header));
+    }
+    if (whole > 0 && entries > 0 && last.firstOrderID == header.orderID && last.records == segment.pendingCount) {
+        // Sealed just before the tail was emptied
+        whole = 0;
+        segment.pendingCount = 0;
+    }
+    if (whole < segment.pending.size()) {
+        if (whole > 0) {
+            cerr << "History segment " << segmentPath(hour, ".tail") << " ends in a partial record, truncated" << endl;
+        }
+        segment.pending.resize(whole);
+        ftruncate(segment.tail, whole);
+    }
+
+    for (size_t at = 0; at < segment.pending.size(); at += header.length) {
+        memcpy(&header, segment.pending.data() + at, sizeof(header));
+        segment.minPlaced = (at == 0) ? header.placedTime : min(segment.minPlaced, header.placedTime);
+        segment.maxPlaced = (at == 0) ? header.placedTime : max(segment.maxPlaced, header.placedTime);
+    }
+
+    return &appending.emplace(hour, std::move(segment)).first->second;
+}
+
+/**
+ * Packs a segment's open block into the .seg file and indexes it.
+ * The block is written before its index entry and the tail is emptied last, so a crash at any
+ * point leaves either the tail or the indexed block holding the records, and openSegment tidies up.
+ *
+ * @param segment The segment whose open block is full.
+ */
+void OrderHistory::sealBlock(Segment& segment){
+    HistoryCodec::encode(segment.pending.data(), segment.pending.size(), packed);
+
+    const vector<char>* stored = &packed;
+    uint32_t packedBytes = 0;
+    if (compression) {
+        HistoryCodec::compress(packed.data(), packed.size(), compressed);
+        if (compressed.size() < packed.size()) {
+            stored = &compressed;
+            packedBytes = packed.size();
+        }
+    }
+
+    HistoryRecord first;
+    memcpy(&first, segment.pending.data(), sizeof(first));
+    IndexEntry entry{segment.size, (uint32_t)stored->size(), packedBytes, segment.pendingCount, first.orderID,
+                     segment.minPlaced, segment.maxPlaced};
+
+    if (write(segment.data, stored->data(), stored->size()) != (ssize_t)stored->size()
+        || write(segment.index, &entry, sizeof(entry)) != sizeof(entry)) {
+        // The records are still in the tail and the next append retries; whatever part of the block
+        // or its index entry got written is cut off first, so the retry appends where this one started
+        cerr << "History block could not be sealed: " << strerror(errno) << endl;
+        struct stat info;
+        if (fstat(segment.index, &info) == 0) {
+            ftruncate(segment.index, info.st_size - info.st_size % sizeof(IndexEntry));
+        }
+        ftruncate(segment.data, segment.size);
+        return;
+    }
+    segment.size += stored->size();
+
+    ftruncate(segment.tail, 0);
+    segment.pending.clear();
+    segment.pendingCount = 0;
+}
+
+/**
+ * Encodes an order's record, header, name and items, into the reused record buffer.
+ *
+ * @param order The order to archive.
+ * @param cancelled Whether the order was cancelled.
+ */
+void OrderHistory::encode(Order& order, bool cancelled){
+    string_view name = order.getName();
+    const pmr::vector<Food>& meal = order.getMeal();
+
+    HistoryRecord header{};
+    header.placedTime = order.getPlacedTime();
+    header.archivedTime = ShiftClock::now();
+    header.promisedTime = order.getPromisedTime();
+    header.length = sizeof(header) + name.size() + meal.size() * ITEM_BYTES;
+    header.orderID = order.getOrderID();
+    header.subtotalCents = order.getSubtotalCents();
+    header.discountCents = order.getDiscountCents();
+    header.type = order.getOrderType();
+    header.status = order.getOrderStatus();
+    header.cancelled = cancelled;
+    header.feePercent = order.getFeePercent();
+    header.nameLength = name.size();
+    header.mealSize = meal.size();
+
+    record.resize(header.length);
+    char* at = record.data();
+    memcpy(at, &header, sizeof(header));
+    at += sizeof(header);
+    memcpy(at, name.data(), name.size());
+    at += name.size();
+    for (const Food& item : meal) {
+        int32_t cents = item.getPriceCents();
+        *at = (char)item.getFood();
+        memcpy(at + 1, &cents, sizeof(cents));
+        at += ITEM_BYTES;
+    }
+}
+
+/**
+ * Adds the encoded record to a segment's open block and widens the block's time range.
+ *
+ * @param segment The segment.
+ */
+void OrderHistory::addPending(Segment& segment){
+    int64_t placedTime;
+    memcpy(&placedTime, record.data() + offsetof(HistoryRecord, placedTime), sizeof(placedTime));
+    segment.minPlaced = (segment.pendingCount == 0) ? placedTime : min(segment.minPlaced, placedTime);
+    segment.maxPlaced = (segment.pendingCount == 0) ? placedTime : max(segment.maxPlaced, placedTime);
+    segment.pending.insert(segment.pending.end(), record.begin(), record.end());
+    segment.pendingCount += 1;
+}
+
+/**
+ * Writes the last records of a segment's open block to its tail in one append.
+ * If the write fails the records are taken back out of the block, as if never archived.
+ *
+ * @param segment The segment.
+ * @param bytes Bytes at the end of the open block not yet in the tail.
+ * @param records Records in those bytes.
+ * @return True if the records were written.
+ */
+bool OrderHistory::writeTail(Segment& segment, size_t bytes, uint32_t records){
+    if (bytes == 0) {
+        return true;
+    }
+    const char* first = segment.pending.data() + segment.pending.size() - bytes;
+    if (write(segment.tail, first, bytes) != (ssize_t)bytes) {
+        cerr << records << " orders could not be archived: " << strerror(errno) << endl;
+        segment.pending.resize(segment.pending.size() - bytes);
+        segment.pendingCount -= records;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Archives an order in the segment of the hour it was placed in.
+ * The record is encoded into a reused buffer and written to the tail with a single append;
+ * every BLOCK_RECORDS records the tail is sealed into a packed block.
+ *
+ * @param order The order to archive.
+ * @param cancelled Whether the order was cancelled.
+ * @return True if the record was written.
+ */
+bool OrderHistory::append(Order& order, bool cancelled){
+    if (!isOpen()) {
+        return false;
+    }
+    Segment* segment = openSegment(order.getPlacedTime() / 3600);
+    if (segment == nullptr) {
+        return false;
+    }
+
+    encode(order, cancelled);
+    if (write(segment->tail, record.data(), record.size()) != (ssize_t)record.size()) {
+        cerr << "Order #" << order.getOrderID() << " could not be archived: " << strerror(errno) << endl;
+        return false;
+    }
+    addPending(*segment);
+
+    // Past a full block only when a seal failed, which the next append retries
+    if (segment->pendingCount >= BLOCK_RECORDS) {
+        sealBlock(*segment);
+    }
+    return true;
+}
+
+/**
+ * Archives many orders, as a bulk status change does.
+ * Records gather in the open block of their segment and reach its tail in one append when the
+ * block fills, the orders move on to another hour, or the orders run out, so a batch of a rush
+ * costs a write per block rather than per order.
+ *
+ * @param orders The orders to archive.
+ * @param cancelled Whether the orders were cancelled.
+ * @return The number of records written.
+ */
+size_t OrderHistory::append(const vector<Order*>& orders, bool cancelled){
+    if (!isOpen()) {
+        return 0;
+    }
+
+    Segment* segment = nullptr;
+    long hour = -1;
+    size_t unwritten = 0; // Bytes at the end of the open block not yet in the tail
+    uint32_t unwrittenRecords = 0;
+    size_t written = 0;
+    auto flush = [&]() {
+        if (segment != nullptr && writeTail(*segment, unwritten, unwrittenRecords)) {
+            written += unwrittenRecords;
+        }
+        unwritten = 0;
+        unwrittenRecords = 0;
+    };
+
+    for (Order* order : orders) {
+        long orderHour = order->getPlacedTime() / 3600;
+        if (segment == nullptr || orderHour != hour) {
+            flush();
+            // Opening may close the least recent segment, whose records are all in its tail by now
+            segment = openSegment(orderHour);
+            hour = orderHour;
+            if (segment == nullptr) {
+                continue;
+            }
+        }
+
+        encode(*order, cancelled);
+        addPending(*segment);
+        unwritten += record.size();
+        unwrittenRecords += 1;
+
+        if (segment->pendingCount >= BLOCK_RECORDS) {
+            flush();
+            sealBlock(*segment);
+        }
+    }
+    flush();
+    return written;
+}
+
+/**
+ * Hands the records of a buffer of plain records placed in a range to a visitor.
+ *
+ * @return The number of records decoded.
+ */
+static long visitRecords(const char* bytes, size_t size, time_t from, time_t to,
+                         const function<void(const HistoryEntry&)>& visit, HistoryScan& scan){
+    HistoryRecord header;
+    size_t at = 0;
+    long records = 0;
+    while (at + sizeof(header) <= size) {
+        memcpy(&header, bytes + at, sizeof(header));
+        if (header.length < sizeof(header) || at + header.length > size) {
+            break;
+        }
+        records += 1;
+        if (header.placedTime >= from && header.placedTime < to) {
+            HistoryEntry entry;
+            entry.orderID = header.orderID;
+            entry.type = static_cast<OrderType>(header.type);
+            entry.status = static_cast<Status>(header.status);
+            entry.cancelled = header.cancelled;
+            entry.placedTime = header.placedTime;
+            entry.archivedTime = header.archivedTime;
+            entry.promisedTime = header.promisedTime;
+            entry.subtotalCents = header.subtotalCents;
+            entry.discountCents = header.discountCents;
+            entry.feePercent = header.feePercent;
+            entry.name = string_view(bytes + at + sizeof(header), header.nameLength);
+            entry.mealSize = header.mealSize;
+            entry.meal = bytes + at + sizeof(header) + header.nameLength;
+            scan.matched += 1;
+            visit(entry);
+        }
+        at += header.length;
+    }
+    scan.records += records;
+    return records;
+}
+
+/**
+ * Maps one segment and hands its records placed in the range to the visitor.
+ * Blocks whose index entry lies outside the range are skipped without touching their pages;
+ * the others are decompressed and unpacked into reused buffers one at a time.
+ *
+ * @param hour Hours since the epoch.
+ * @param from Start of the range, included.
+ * @param to End of the range, excluded.
+ * @param visit Called with each matching order.
+ * @param scan Work counters to add to.
+ */
+void OrderHistory::scanSegment(long hour, time_t from, time_t to, const function<void(const HistoryEntry&)>& visit,
+                               HistoryScan& scan) const{
+    struct stat info;
+    vector<char> plain;
+
+    int data = ::open(segmentPath(hour, ".seg").c_str(), O_RDONLY);
+    if (data >= 0) {
+        scan.segments += 1;
+        fstat(data, &info);
+        size_t size = info.st_size;
+        void* mapping = (size > 0) ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, data, 0) : MAP_FAILED;
+        close(data);
+
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, size, MADV_SEQUENTIAL);
+            const char* bytes = static_cast<const char*>(mapping);
+            scan.bytesMapped += size;
+
+            // The index is small; read it whole
+            vector<IndexEntry> entries;
+            int index = ::open(segmentPath(hour, ".idx").c_str(), O_RDONLY);
+            if (index >= 0) {
+                fstat(index, &info);
+                entries.resize(info.st_size / sizeof(IndexEntry));
+                ssize_t wanted = entries.size() * sizeof(IndexEntry);
+                if (pread(index, entries.data(), wanted, 0) != wanted) {
+                    entries.clear();
+                }
+                close(index);
+            }
+
+            vector<char> unpacked;
+            for (const IndexEntry& entry : entries) {
+                if (entry.maxPlaced < from || entry.minPlaced >= to) {
+                    scan.blocksSkipped += 1;
+                    continue;
+                }
+                if (entry.offset + entry.bytes > size) {
+                    break;
+                }
+                const char* block = bytes + entry.offset;
+                size_t blockSize = entry.bytes;
+                if (entry.packedBytes > 0) {
+                    if (!HistoryCodec::decompress(block, blockSize, entry.packedBytes, unpacked)) {
+                        cerr << "History block at " << entry.offset << " of " << segmentPath(hour, ".seg")
+                             << " is damaged" << endl;
+                        continue;
+                    }
+                    block = unpacked.data();
+                    blockSize = unpacked.size();
+                }
+                if (!HistoryCodec::decode(block, blockSize, entry.records, plain)) {
+                    cerr << "History block at " << entry.offset << " of " << segmentPath(hour, ".seg")
+                         << " is damaged" << endl;
+                    continue;
+                }
+                scan.blocksRead += 1;
+                scan.packedBytes += entry.bytes;
+                scan.plainBytes += plain.size();
+                visitRecords(plain.data(), plain.size(), from, to, visit, scan);
+            }
+            munmap(mapping, size);
+        }
+    }
+
+    // Records of the block still being filled
+    int tail = ::open(segmentPath(hour, ".tail").c_str(), O_RDONLY);
+    if (tail >= 0) {
+        fstat(tail, &info);
+        plain.resize(info.st_size);
+        if (info.st_size > 0 && pread(tail, plain.data(), plain.size(), 0) == info.st_size) {
+            if (data < 0) {
+                scan.segments += 1;
+            }
+            scan.packedBytes += plain.size();
+            scan.plainBytes += plain.size();
+            visitRecords(plain.data(), plain.size(), from, to, visit, scan);
+        }
+        close(tail);
+    }
+}
+
+/**
+ * Hands every archived order placed in a time range to a visitor.
+ * Only the segments of the hours the range covers are opened.
+ *
+ * @param from Start of the range, included.
+ * @param to End of the range, excluded.
+ * @param visit Called with each matching order.
+ * @return The work done by the query.
+ */
+HistoryScan OrderHistory::query(time_t from, time_t to, const function<void(const HistoryEntry&)>& visit) const{
+    HistoryScan scan;
+    auto start = chrono::steady_clock::now();
+
+    if (isOpen() && from < to) {
+        for (long hour = from / 3600; hour <= (to - 1) / 3600; hour++) {
+            scanSegment(hour, from, to, visit, scan);
+        }
+    }
+
+    scan.nanoseconds = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    return scan;
+}
+
+/**
+ * Retrieves the memory held by the open blocks and encoding buffers; sealed blocks are only on disk.
+ *
+ * @return The approximate footprint in bytes.
+ */
+size_t OrderHistory::bytesUsed() const{
+    size_t bytes = record.capacity() + packed.capacity() + compressed.capacity();
+    for (const auto& [hour, segment] : appending) {
+        bytes += sizeof(Segment) + segment.pending.capacity();
+    }
+    return bytes;
+}
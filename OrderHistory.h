@@ -0,0 +1,238 @@
+/**
+ * @file OrderHistory.h
+ * @brief Defines the OrderHistory class, an archive of finished orders in hourly segment files
+ *        with a sparse time index, queried by placement time through memory-mapped reads.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_ORDERHISTORY_H
+#define RESTAURANTREAL_ORDERHISTORY_H
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Order.h"
+#include "HistoryCodec.h"
+
+using namespace std;
+
+/**
+ * One archived order, viewing the bytes of a mapped segment. Only valid during the visit.
+ */
+struct HistoryEntry {
+    int orderID = 0;
+    OrderType type = DRIVE_THROUGH;
+    Status status = PLACED; // Status when archived
+    bool cancelled = false; // Whether the order was cancelled rather than finished
+    time_t placedTime = 0;
+    time_t archivedTime = 0;
+    time_t promisedTime = 0;
+    long subtotalCents = 0;
+    long discountCents = 0;
+    int feePercent = 0;
+    string_view name;
+    int mealSize = 0;
+    const char* meal = nullptr; // Packed items, see itemCode and itemCents
+
+    /**
+     * Retrieves the code of an item of the meal.
+     *
+     * @param i Position of the item.
+     * @return The item's FOOD code.
+     */
+    FOOD itemCode(int i) const;
+
+    /**
+     * Retrieves the price an item of the meal was charged.
+     *
+     * @param i Position of the item.
+     * @return The price in cents.
+     */
+    int32_t itemCents(int i) const;
+
+    /**
+     * Retrieves the amount the order was charged, service fee included.
+     *
+     * @return The total in cents.
+     */
+    long getTotalCents() const;
+};
+
+/**
+ * Work done by a history query.
+ */
+struct HistoryScan {
+    long segments = 0; // Segment files opened
+    long blocksRead = 0; // Index blocks overlapping the range, scanned
+    long blocksSkipped = 0; // Index blocks outside the range, never touched
+    long records = 0; // Records decoded
+    long matched = 0; // Records in the range handed to the visitor
+    long bytesMapped = 0; // Size of the segments mapped
+    long packedBytes = 0; // Stored bytes of the blocks scanned, open blocks included
+    long plainBytes = 0; // Bytes of the same records unpacked
+    long nanoseconds = 0; // Wall time of the query
+};
+
+/**
+ * @class OrderHistory
+ * @brief Appends finished and cancelled orders to the segment of the UTC hour they were placed in.
+ *
+ * Each segment is three files in the history directory, named after the hour (20240607-18.seg, .idx and
+ * .tail). Records are appended plain to the .tail file until BLOCK_RECORDS have gathered; the block is
+ * then packed by HistoryCodec, optionally LZ compressed, appended to the .seg file, and given an entry in
+ * the .idx file with its offset, sizes and earliest and latest placement time. The tail is emptied once
+ * the entry is written, and a tail whose records already made it into a block is recognized on reopen.
+ *
+ * A query only opens the segments of the hours it covers, maps each one, and skips every block whose
+ * times fall outside the range, so the cost follows the range asked for rather than the size of the
+ * history. Blocks that are read are unpacked one at a time into a reused buffer.
+ */
+class OrderHistory {
+    private:
+        static const uint32_t BLOCK_RECORDS = 128;
+        static const size_t MAX_OPEN_SEGMENTS = 4;
+
+        /**
+         * A segment being appended to.
+         */
+        struct Segment {
+            int data = -1; // Descriptor of the .seg file
+            int index = -1; // Descriptor of the .idx file
+            int tail = -1; // Descriptor of the .tail file
+            uint64_t size = 0; // Bytes in the .seg file
+            vector<char> pending; // Plain records of the open block, as in the .tail file
+            uint32_t pendingCount = 0; // Records in the open block
+            int64_t minPlaced = 0; // Earliest placement time in the open block
+            int64_t maxPlaced = 0; // Latest placement time in the open block
+        };
+
+        string directory; // Where the segment files live, empty while closed
+        bool compression = true; // Whether sealed blocks get the LZ pass
+        map<long, Segment> appending; // Segments being appended to, by hour since the epoch
+        vector<char> record; // Encoding buffer reused by every append
+        vector<char> packed; // Packed block being sealed
+        vector<char> compressed; // Compressed block being sealed
+
+        /**
+         * Builds the path of a segment file.
+         */
+        string segmentPath(long hour, const char* extension) const;
+
+        /**
+         * Opens the segment of an hour for appending, finding where its unindexed block starts.
+         */
+        Segment* openSegment(long hour);
+
+        /**
+         * Packs a segment's open block into the .seg file and indexes it.
+         */
+        void sealBlock(Segment& segment);
+
+        /**
+         * Encodes an order's record into the reused buffer.
+         */
+        void encode(Order& order, bool cancelled);
+
+        /**
+         * Adds the encoded record to a segment's open block.
+         */
+        void addPending(Segment& segment);
+
+        /**
+         * Writes the last records of a segment's open block to its tail in one append.
+         */
+        bool writeTail(Segment& segment, size_t bytes, uint32_t records);
+
+        /**
+         * Closes the files of a segment.
+         */
+        static void closeSegment(Segment& segment);
+
+        /**
+         * Maps one segment and hands its records in the range to the visitor.
+         */
+        void scanSegment(long hour, time_t from, time_t to, const function<void(const HistoryEntry&)>& visit,
+                         HistoryScan& scan) const;
+
+    public:
+        /**
+         * Default constructor for the OrderHistory class.
+         * The history stays closed until open is called.
+         */
+        OrderHistory() = default;
+
+        /**
+         * Destructor for the OrderHistory class.
+         * Closes the segments being appended to.
+         */
+        ~OrderHistory();
+
+        OrderHistory(const OrderHistory&) = delete;
+        OrderHistory& operator=(const OrderHistory&) = delete;
+
+        /**
+         * Opens a history directory, creating it if it does not exist.
+         * No segment is read until an order is appended or a query asks for it.
+         *
+         * @param path The history directory.
+         * @return True if the directory can be used.
+         */
+        bool open(const string& path);
+
+        /**
+         * Chooses whether sealed blocks are LZ compressed after packing.
+         * Blocks record how they were stored, so a history may mix both.
+         *
+         * @param enabled True to compress blocks sealed from now on.
+         */
+        void setCompression(bool enabled);
+
+        /**
+         * Checks whether a history directory is open.
+         *
+         * @return True if orders are being archived.
+         */
+        bool isOpen() const;
+
+        /**
+         * Archives an order in the segment of the hour it was placed in.
+         *
+         * @param order The order to archive.
+         * @param cancelled Whether the order was cancelled.
+         * @return True if the record was written.
+         */
+        bool append(Order& order, bool cancelled);
+
+        /**
+         * Archives many orders, with one append to a segment's tail per block instead of one per order.
+         *
+         * @param orders The orders to archive.
+         * @param cancelled Whether the orders were cancelled.
+         * @return The number of records written.
+         */
+        size_t append(const vector<Order*>& orders, bool cancelled);
+
+        /**
+         * Hands every archived order placed in a time range to a visitor.
+         * Segments are visited hour by hour; records within a segment come in the order they were archived.
+         *
+         * @param from Start of the range, included.
+         * @param to End of the range, excluded.
+         * @param visit Called with each matching order.
+         * @return The work done by the query.
+         */
+        HistoryScan query(time_t from, time_t to, const function<void(const HistoryEntry&)>& visit) const;
+
+        /**
+         * Retrieves the memory held by the open blocks and encoding buffers; sealed blocks are only on disk.
+         *
+         * @return The approximate footprint in bytes.
+         */
+        size_t bytesUsed() const;
+};
+
+#endif //RESTAURANTREAL_ORDERHISTORY_H
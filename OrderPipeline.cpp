@@ -0,0 +1,407 @@
+/**
+ * @file OrderPipeline.cpp
+ * @brief This file contains the OrderPipeline class, coroutine tasks for the orders in the kitchen
+ *        with per-type cook queues and a single-threaded executor.
+ * @author Edward Villano
+ */
+
+#include "OrderPipeline.h"
+#include "ShiftClock.h"
+#include <iostream>
+#include <iomanip>
+
+/**
+ * Allocates a task's frame from the pipeline's frame pool.
+ * The pipeline is kept in front of the frame, where operator delete finds it.
+ *
+ * @param size Bytes of the frame.
+ * @param pipeline The pipeline running the task.
+ * @return The frame.
+ */
+void* OrderPipeline::Task::promise_type::operator new(size_t size, OrderPipeline& pipeline, int, OrderType, Status){
+    char* block = static_cast<char*>(pipeline.frames.allocate(size + FRAME_HEADER));
+    *reinterpret_cast<OrderPipeline**>(block) = &pipeline;
+    pipeline.frameBytes += size;
+    return block + FRAME_HEADER;
+}
+
+/**
+ * Gives a task's frame back to the pool of the pipeline that allocated it.
+ *
+ * @param frame The frame.
+ * @param size Bytes of the frame.
+ */
+void OrderPipeline::Task::promise_type::operator delete(void* frame, size_t size){
+    char* block = static_cast<char*>(frame) - FRAME_HEADER;
+    OrderPipeline* pipeline = *reinterpret_cast<OrderPipeline**>(block);
+    pipeline->frameBytes -= size;
+    pipeline->frames.deallocate(block, size + FRAME_HEADER);
+}
+
+/**
+ * Parks the task on its node until the order's status changes.
+ * A placed order's task joins its type's cook queue.
+ *
+ * @param handle The suspended task.
+ */
+void OrderPipeline::StatusChange::await_suspend(coroutine_handle<> handle) noexcept {
+    Node& node = pipeline.nodes[task];
+    node.handle = handle;
+    node.status = status;
+    if (status == PLACED) {
+        pipeline.link(task);
+    }
+}
+
+/**
+ * Retrieves the status the task was resumed with.
+ *
+ * @return The new status, or nothing if the order left the system.
+ */
+optional<Status> OrderPipeline::StatusChange::await_resume() const noexcept {
+    return pipeline.nodes[task].delivered;
+}
+
+/**
+ * Body of a task. Waits for each change of its order's status and adds the time spent in the
+ * old status to the stage waits, until the order is ready for pickup or leaves the system.
+ *
+ * @param pipeline The pipeline running the task.
+ * @param task The task's node.
+ * @param type The order's type.
+ * @param status The order's status when the task starts.
+ * @return The task.
+ */
+OrderPipeline::Task OrderPipeline::lifecycle(OrderPipeline& pipeline, int task, OrderType type, Status status){
+    time_t since = ShiftClock::now();
+    while (status != READY_FOR_PICKUP) {
+        optional<Status> next = co_await StatusChange{pipeline, task, status};
+        if (!next) {
+            co_return;
+        }
+        time_t at = pipeline.nodes[task].signalledAt;
+        pipeline.waits[status].orders[type] += 1;
+        pipeline.waits[status].seconds[type] += max<time_t>(0, at - since);
+        since = at;
+        status = *next;
+    }
+}
+
+/**
+ * Constructor for the OrderPipeline class.
+ * Starts with no tasks and every cook queue empty.
+ */
+OrderPipeline::OrderPipeline(){
+}
+
+/**
+ * Destructor for the OrderPipeline class.
+ * Destroys the frames of the tasks still running before the frame pool goes.
+ */
+OrderPipeline::~OrderPipeline(){
+    clear();
+}
+
+/**
+ * Links a task into its type's cook queue in ID order.
+ * Orders are placed with increasing IDs, so the task almost always goes at the tail.
+ *
+ * @param task Node to link.
+ */
+void OrderPipeline::link(int task){
+    Node& node = nodes[task];
+    int before = tails[node.type];
+    while (before >= 0 && nodes[before].orderID > node.orderID) {
+        before = nodes[before].prev;
+    }
+
+    node.prev = before;
+    node.next = (before >= 0) ? nodes[before].next : heads[node.type];
+    if (node.next >= 0) {
+        nodes[node.next].prev = task;
+    } else {
+        tails[node.type] = task;
+    }
+    if (before >= 0) {
+        nodes[before].next = task;
+    } else {
+        heads[node.type] = task;
+    }
+    node.queued = true;
+}
+
+/**
+ * Unlinks a task from its cook queue.
+ *
+ * @param task Node to unlink.
+ */
+void OrderPipeline::unlink(int task){
+    Node& node = nodes[task];
+    if (node.prev >= 0) {
+        nodes[node.prev].next = node.next;
+    } else {
+        heads[node.type] = node.next;
+    }
+    if (node.next >= 0) {
+        nodes[node.next].prev = node.prev;
+    } else {
+        tails[node.type] = node.prev;
+    }
+    node.prev = -1;
+    node.next = -1;
+    node.queued = false;
+}
+
+/**
+ * Frees a task's frame and puts its node on the free list.
+ *
+ * @param task Node of the task.
+ */
+void OrderPipeline::release(int task){
+    Node& node = nodes[task];
+    if (node.queued) {
+        unlink(task);
+    }
+    coroutine_handle<> handle = node.handle;
+    node.handle = nullptr;
+    node.signalled = false;
+    node.next = freeList;
+    freeList = task;
+    live -= 1;
+    handle.destroy();
+}
+
+/**
+ * Starts the task of an order. The task runs up to its first wait before this returns,
+ * so a placed order is in its cook queue at once.
+ *
+ * @param orderID The order's ID.
+ * @param type The order's type.
+ * @param status The order's status.
+ * @return The task handle, or -1 if the order is ready for pickup and needs no task.
+ */
+int OrderPipeline::start(int orderID, OrderType type, Status status){
+    if (status == READY_FOR_PICKUP) {
+        return -1;
+    }
+
+    int task = freeList;
+    if (task >= 0) {
+        freeList = nodes[task].next;
+    } else {
+        task = static_cast<int>(nodes.size());
+        nodes.emplace_back();
+    }
+    nodes[task] = Node{};
+    nodes[task].orderID = orderID;
+    nodes[task].type = type;
+    live += 1;
+
+    lifecycle(*this, task, type, status);
+    return task;
+}
+
+/**
+ * Tells a task its order's status changed. The task leaves its cook queue at once, so the next
+ * dispatch no longer sees it, and is resumed by the next run. A task signalled twice before a
+ * run is resumed for the first change right away, so no change goes unrecorded.
+ *
+ * @param task Handle returned by start; -1 is ignored.
+ * @param status The new status.
+ */
+void OrderPipeline::signal(int task, Status status){
+    if (task < 0) {
+        return;
+    }
+    if (nodes[task].signalled) {
+        coroutine_handle<> handle = nodes[task].handle;
+        nodes[task].signalled = false;
+        handle.resume();
+        resumes += 1;
+        if (handle.done()) {
+            release(task);
+            return;
+        }
+    }
+
+    Node& node = nodes[task];
+    if (node.queued) {
+        unlink(task);
+    }
+    node.delivered = status;
+    node.signalledAt = ShiftClock::now();
+    node.signalled = true;
+    runnable.push_back(task);
+}
+
+/**
+ * Tells a task its order left the system. The task is taken out of its cook queue at once
+ * and finishes on the next run without recording the status it was in.
+ *
+ * @param task Handle returned by start; -1 is ignored.
+ */
+void OrderPipeline::close(int task){
+    if (task < 0) {
+        return;
+    }
+    Node& node = nodes[task];
+    if (node.queued) {
+        unlink(task);
+    }
+    node.delivered.reset();
+    if (!node.signalled) {
+        node.signalled = true;
+        runnable.push_back(task);
+    }
+}
+
+/**
+ * Resumes every signalled task in the order its status changed, and frees the tasks that finish.
+ * Entries left by a task that was already resumed by a second signal are skipped.
+ */
+void OrderPipeline::run(){
+    while (!runnable.empty()) {
+        running.swap(runnable);
+        for (int task : running) {
+            if (!nodes[task].signalled) {
+                continue;
+            }
+            coroutine_handle<> handle = nodes[task].handle;
+            nodes[task].signalled = false;
+            handle.resume();
+            resumes += 1;
+            if (handle.done()) {
+                release(task);
+            }
+        }
+        running.clear();
+    }
+}
+
+/**
+ * Finishes every task at once, destroying their frames where they wait, as when a checkpoint
+ * replaces the orders. The stage waits recorded so far stay.
+ */
+void OrderPipeline::clear(){
+    for (Node& node : nodes) {
+        if (node.handle) {
+            node.handle.destroy();
+        }
+    }
+    nodes.clear();
+    freeList = -1;
+    fill(begin(heads), end(heads), -1);
+    fill(begin(tails), end(tails), -1);
+    runnable.clear();
+    live = 0;
+}
+
+/**
+ * Retrieves the first order waiting for a cook of a type.
+ *
+ * @param type The order type.
+ * @param skipID An order passed over if it is first, -1 for none.
+ * @return The order's ID, or -1 if none is waiting.
+ */
+int OrderPipeline::firstWaiting(OrderType type, int skipID){
+    int task = heads[type];
+    if (task >= 0 && nodes[task].orderID == skipID) {
+        task = nodes[task].next;
+    }
+    return (task >= 0) ? nodes[task].orderID : -1;
+}
+
+/**
+ * Takes an order's task out of a cook queue because the order is no longer placed. A task that is
+ * still its order's is only unlinked, as its order's next status change moves it on; any other,
+ * such as one left behind by a replaced or lost order, is finished on the next run.
+ *
+ * @param type The order type.
+ * @param orderID The order's ID.
+ * @param keepTask The order's current task, -1 if the order is gone.
+ */
+void OrderPipeline::discard(OrderType type, int orderID, int keepTask){
+    int task = heads[type];
+    while (task >= 0 && nodes[task].orderID != orderID) {
+        task = nodes[task].next;
+    }
+    if (task < 0) {
+        return;
+    }
+    if (task == keepTask) {
+        unlink(task);
+    } else {
+        close(task);
+    }
+}
+
+/**
+ * Retrieves the orders waiting for a cook of a type ahead of an order, in ID order.
+ *
+ * @param type The order type.
+ * @param beforeID Only orders with a lower ID are listed.
+ * @param out Receives the orders' IDs.
+ */
+void OrderPipeline::waitingBefore(OrderType type, int beforeID, vector<int>& out){
+    for (int task = heads[type]; task >= 0 && nodes[task].orderID < beforeID; task = nodes[task].next) {
+        out.push_back(nodes[task].orderID);
+    }
+}
+
+/**
+ * Retrieves the number of unfinished tasks.
+ *
+ * @return The number of tasks.
+ */
+int OrderPipeline::size(){
+    return live;
+}
+
+/**
+ * Retrieves the time spent in a status by the orders that left it.
+ *
+ * @param status PLACED, COOKING or COMPLETE.
+ * @return The waits per order type.
+ */
+const StageWaits& OrderPipeline::getWaits(Status status){
+    return waits[status];
+}
+
+/**
+ * Prints the tasks in flight per status, the frame memory, the executor's resumes and
+ * the mean time orders spent in each status before they left it.
+ */
+void OrderPipeline::printStatus(){
+    long waiting[3] = {};
+    for (Node& node : nodes) {
+        if (node.handle && node.status < READY_FOR_PICKUP) {
+            waiting[node.status] += 1;
+        }
+    }
+
+    cout << "\nOrder tasks: " << live << " in flight, " << (frameBytes + 1023) / 1024 << " KB of frames, "
+         << resumes << " resumes" << endl;
+    cout << "-----STATUS-----|-WAITING-|---LEFT-|-MEAN WAIT-" << endl;
+    for (int status = PLACED; status <= COMPLETE; status++) {
+        long finished = 0;
+        long seconds = 0;
+        for (int type = 0; type < 4; type++) {
+            finished += waits[status].orders[type];
+            seconds += waits[status].seconds[type];
+        }
+        long mean = (finished > 0) ? seconds / finished : 0;
+        cout << setw(15) << left << StatusList[status] << " | " << right << setw(7) << waiting[status] << " | "
+             << setw(6) << finished << " | " << setw(6) << mean / 60 << ":" << setfill('0') << setw(2)
+             << mean % 60 << setfill(' ') << left << endl;
+    }
+}
+
+/**
+ * Retrieves the memory held by the tasks: the task pool, the executor's queues and the frames.
+ *
+ * @return The approximate footprint in bytes.
+ */
+size_t OrderPipeline::bytesUsed(){
+    return nodes.capacity() * sizeof(Node) + (runnable.capacity() + running.capacity()) * sizeof(int)
+           + frameBytes + live * FRAME_HEADER;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file OrderPipeline.h
+ * @brief Defines the OrderPipeline class, which runs each order in the kitchen as a coroutine task that
+ *        waits in its type's cook queue and is resumed by a single-threaded executor as its status changes.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_ORDERPIPELINE_H
+#define RESTAURANTREAL_ORDERPIPELINE_H
+
+#include <coroutine>
+#include <cstddef>
+#include <ctime>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+#include "Order.h"
+
+using namespace std;
+
+/**
+ * How long orders spent in one status, added up by the tasks as they leave it.
+ */
+struct StageWaits {
+    long orders[4] = {}; // Orders that left the status, per OrderType
+    long seconds[4] = {}; // Seconds they spent in it, per OrderType
+};
+
+/**
+ * @class OrderPipeline
+ * @brief Coroutine tasks for the orders on their way through the kitchen, with one cook queue per order type.
+ *
+ * An order gets a task when it is placed. The task suspends until the order's status changes, and while the
+ * order is placed it waits in its type's cook queue, kept in ID order, so the next order of a type is the
+ * head of its queue instead of the result of a scan of every order. A status change takes the task out of
+ * its queue at once and queues it for the executor, which resumes it on the system's thread to record the
+ * time spent in the old status and wait for the next one. The task ends when the order is ready for pickup
+ * or leaves the system.
+ *
+ * Tasks live in a pooled array like the timer wheel's, and orders hold the handle of theirs. The coroutine
+ * frames come from a pool owned by the pipeline, so a task costs its frame and one pool entry.
+ */
+class OrderPipeline {
+    private:
+        /**
+         * Coroutine type of a task. The frame is released by the executor once the task finishes.
+         */
+        struct Task {
+            struct promise_type {
+                Task get_return_object() noexcept {
+                    return {};
+                }
+                suspend_never initial_suspend() noexcept {
+                    return {};
+                }
+                suspend_always final_suspend() noexcept {
+                    return {};
+                }
+                void return_void() noexcept {
+                }
+                void unhandled_exception() noexcept {
+                }
+
+                /**
+                 * Allocates the frame from the pipeline's frame pool, keeping the pipeline in front of it.
+                 */
+                static void* operator new(size_t size, OrderPipeline& pipeline, int, OrderType, Status);
+
+                /**
+                 * Gives the frame back to the pool of the pipeline that allocated it.
+                 */
+                static void operator delete(void* frame, size_t size);
+            };
+        };
+
+        /**
+         * A task in the pool; free nodes are chained through next.
+         */
+        struct Node {
+            coroutine_handle<> handle; // The task's coroutine, null while the node is free
+            int orderID; // Order the task runs
+            OrderType type; // Order type, choosing the cook queue
+            Status status; // Status the task is waiting to leave
+            optional<Status> delivered; // Status the task is resumed with, empty when the order left
+            time_t signalledAt = 0; // Time the status changed
+            int prev = -1; // Previous node in the cook queue, -1 at the head
+            int next = -1; // Next node in the cook queue or free list, -1 at the tail
+            bool queued = false; // Whether the node is linked into its type's cook queue
+            bool signalled = false; // Whether the node waits for the executor
+        };
+
+        /**
+         * Awaitable the task suspends on until its order's status changes.
+         */
+        struct StatusChange {
+            OrderPipeline& pipeline;
+            int task;
+            Status status; // Status the order is in while the task waits
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+            void await_suspend(coroutine_handle<> handle) noexcept;
+            optional<Status> await_resume() const noexcept;
+        };
+
+        static const size_t FRAME_HEADER = alignof(max_align_t); // Room for the pipeline in front of a frame
+
+        vector<Node> nodes; // Task pool
+        int freeList = -1; // First free node in the pool
+        int heads[4] = {-1, -1, -1, -1}; // First task of each type's cook queue
+        int tails[4] = {-1, -1, -1, -1}; // Last task of each type's cook queue
+        vector<int> runnable; // Signalled tasks, in the order their statuses changed
+        vector<int> running; // Tasks being resumed by run, kept to reuse its memory
+        pmr::unsynchronized_pool_resource frames; // Memory of the coroutine frames
+        size_t frameBytes = 0; // Bytes of frames in use
+        int live = 0; // Number of unfinished tasks
+        long resumes = 0; // Tasks resumed by the executor
+        StageWaits waits[3]; // Time spent per status before ready for pickup
+
+        /**
+         * Body of a task: waits out each status of its order and records how long it took.
+         */
+        static Task lifecycle(OrderPipeline& pipeline, int task, OrderType type, Status status);
+
+        /**
+         * Links a task into its type's cook queue in ID order.
+         */
+        void link(int task);
+
+        /**
+         * Unlinks a task from its cook queue.
+         */
+        void unlink(int task);
+
+        /**
+         * Frees a finished task's frame and pool node.
+         */
+        void release(int task);
+
+    public:
+        /**
+         * Constructor for the OrderPipeline class.
+         */
+        OrderPipeline();
+
+        OrderPipeline(const OrderPipeline&) = delete;
+        OrderPipeline& operator=(const OrderPipeline&) = delete;
+
+        /**
+         * Destructor for the OrderPipeline class.
+         * Destroys the frames of the tasks still running.
+         */
+        ~OrderPipeline();
+
+        /**
+         * Starts the task of an order, which runs up to its first wait.
+         *
+         * @param orderID The order's ID.
+         * @param type The order's type.
+         * @param status The order's status.
+         * @return The task handle, or -1 if the order is ready for pickup and needs no task.
+         */
+        int start(int orderID, OrderType type, Status status);
+
+        /**
+         * Tells a task its order's status changed. The task leaves its cook queue at once
+         * and is resumed by the next run.
+         *
+         * @param task Handle returned by start; -1 is ignored.
+         * @param status The new status.
+         */
+        void signal(int task, Status status);
+
+        /**
+         * Tells a task its order left the system. The task finishes on the next run.
+         *
+         * @param task Handle returned by start; -1 is ignored.
+         */
+        void close(int task);
+
+        /**
+         * Resumes every signalled task in the order its status changed.
+         */
+        void run();
+
+        /**
+         * Finishes every task at once, as when the orders are replaced.
+         */
+        void clear();
+
+        /**
+         * Retrieves the first order waiting for a cook of a type.
+         *
+         * @param type The order type.
+         * @param skipID An order passed over if it is first, -1 for none.
+         * @return The order's ID, or -1 if none is waiting.
+         */
+        int firstWaiting(OrderType type, int skipID);
+
+        /**
+         * Takes an order's task out of a cook queue because the order is no longer placed.
+         * The task is finished unless it is still the order's.
+         *
+         * @param type The order type.
+         * @param orderID The order's ID.
+         * @param keepTask The order's current task, -1 if the order is gone.
+         */
+        void discard(OrderType type, int orderID, int keepTask);
+
+        /**
+         * Retrieves the orders waiting for a cook of a type, in ID order.
+         *
+         * @param type The order type.
+         * @param beforeID Only orders with a lower ID are listed.
+         * @param out Receives the orders' IDs.
+         */
+        void waitingBefore(OrderType type, int beforeID, vector<int>& out);
+
+        /**
+         * Retrieves the number of unfinished tasks.
+         *
+         * @return The number of tasks.
+         */
+        int size();
+
+        /**
+         * Retrieves the time spent in a status by the orders that left it.
+         *
+         * @param status PLACED, COOKING or COMPLETE.
+         * @return The waits per order type.
+         */
+        const StageWaits& getWaits(Status status);
+
+        /**
+         * Prints the tasks in flight, the executor's resumes and the mean time spent per status.
+         */
+        void printStatus();
+
+        /**
+         * Retrieves the memory held by the tasks, including their frames.
+         *
+         * @return The approximate footprint in bytes.
+         */
+        size_t bytesUsed();
+};
+
+#endif //RESTAURANTREAL_ORDERPIPELINE_H
@@ -0,0 +1,258 @@
+/**
+ * @file PricingRules.cpp
+ * @brief This file contains the PricingRules class, a rules file compiler and table-driven order pricer.
+ * @author Edward Villano
+ */
+
+#include "PricingRules.h"
+#include "ShiftClock.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+/**
+ * Looks up a FOOD code by its enum name.
+ *
+ * @return The code, or -1 if there is no such food.
+ */
+static int parseFood(const string& word){
+    for (int food = 0; food < 17; food++) {
+        if (foodCodeList[food] == word) {
+            return food;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Looks up an OrderType by its enum name.
+ *
+ * @return The type, 4 for '*' meaning every type, or -1 if there is no such type.
+ */
+static int parseType(const string& word){
+    if (word == "*") {
+        return 4;
+    }
+    for (int type = DRIVE_THROUGH; type <= DOORDASH; type++) {
+        if (OrderTypeList[type] == word) {
+            return type;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Constructor for the PricingRules class.
+ * Starts from menu prices and the standard service fees, with no promotions.
+ */
+PricingRules::PricingRules(){
+    for (int type = DRIVE_THROUGH; type <= DOORDASH; type++) {
+        feePercent[type] = serviceFeePercent[type];
+        for (int hour = 0; hour < 24; hour++) {
+            for (int food = 0; food < 17; food++) {
+                keptBasis[type][hour][food] = 10000;
+            }
+        }
+    }
+}
+
+/**
+ * Replaces the rules with the ones in a file.
+ * Discounts on the same food and hour stack by applying each to the already discounted price.
+ * Lines that cannot be parsed are reported and skipped.
+ *
+ * @param path The rules file.
+ * @return The number of rules loaded, or -1 if the file could not be opened.
+ */
+int PricingRules::load(const string& path){
+    ifstream file(path);
+    if (!file) {
+        cerr << "Pricing rules " << path << " not found, using menu prices" << endl;
+        return -1;
+    }
+
+    *this = PricingRules();
+
+    string line;
+    int lineNumber = 0;
+    int loaded = 0;
+
+    while (getline(file, line)) {
+        lineNumber += 1;
+        line = line.substr(0, line.find('#'));
+
+        istringstream words(line);
+        string kind;
+        if (!(words >> kind)) {
+            continue;
+        }
+
+        bool ok = false;
+        if (kind == "discount") {
+            string foodWord, typeWord;
+            int fromHour, toHour, percent;
+            if (words >> foodWord >> typeWord >> fromHour >> toHour >> percent) {
+                int food = parseFood(foodWord);
+                int type = parseType(typeWord);
+                ok = food >= 0 && type >= 0 && fromHour >= 0 && fromHour < 24 && toHour >= 0 && toHour <= 24
+                     && percent >= 0 && percent <= 100;
+                for (int t = DRIVE_THROUGH; ok && t <= DOORDASH; t++) {
+                    if (type != 4 && type != t) {
+                        continue;
+                    }
+                    // A window like 22 2 wraps past midnight, and one like 0 24 is all day
+                    int hours = (toHour > fromHour) ? toHour - fromHour : toHour + 24 - fromHour;
+                    for (int h = 0; h < hours; h++) {
+                        int32_t& kept = keptBasis[t][(fromHour + h) % 24][food];
+                        kept -= (kept * percent + 50) / 100;
+                    }
+                }
+            }
+        } else if (kind == "combo") {
+            string firstWord, secondWord;
+            double dollars;
+            if (words >> firstWord >> secondWord >> dollars) {
+                int first = parseFood(firstWord);
+                int second = parseFood(secondWord);
+                ok = first >= 0 && second >= 0 && dollars >= 0 && comboCount < MAX_COMBOS;
+                if (ok) {
+                    combos[comboCount++] = Combo{(uint8_t)first, (uint8_t)second, (int32_t)lround(dollars * 100)};
+                }
+            }
+        } else if (kind == "fee") {
+            string typeWord;
+            int percent;
+            if (words >> typeWord >> percent) {
+                int type = parseType(typeWord);
+                ok = type >= 0 && percent >= 0 && percent <= 100;
+                for (int t = DRIVE_THROUGH; ok && t <= DOORDASH; t++) {
+                    if (type == 4 || type == t) {
+                        feePercent[t] = percent;
+                    }
+                }
+            }
+        }
+
+        if (ok) {
+            loaded += 1;
+        } else {
+            cerr << path << ":" << lineNumber << ": invalid pricing rule skipped" << endl;
+        }
+    }
+    return loaded;
+}
+
+/**
+ * Prices an order at the hour it was placed.
+ *
+ * @param order The order to price.
+ * @return The order's price under the rules.
+ */
+PriceQuote PricingRules::price(Order& order) const{
+    time_t placed = order.getPlacedTime();
+    tm local;
+    localtime_r(&placed, &local);
+    return priceAt(order, local.tm_hour);
+}
+
+/**
+ * Prices an order as if it was placed at the given hour.
+ * Each item's own price is scaled by the share kept in the table row of the order's type and hour,
+ * so items ordered from an older menu are repriced from what they cost then. Combos are then matched greedily
+ * in file order, each item counting toward at most one combo, and the fee is charged on what is left.
+ *
+ * @param order The order to price.
+ * @param hour The local hour of day.
+ * @return The order's price under the rules.
+ */
+PriceQuote PricingRules::priceAt(Order& order, int hour) const{
+    PriceQuote quote;
+    const int32_t* row = keptBasis[order.getOrderType()][hour];
+    int counts[17] = {};
+    long subtotal = 0;
+
+    for (const Food& item : order.getMeal()) {
+        FOOD food = item.getFood();
+        subtotal += (item.getPriceCents() * row[food] + 5000) / 10000;
+        counts[food] += 1;
+    }
+
+    long comboCents = 0;
+    for (int i = 0; i < comboCount; i++) {
+        const Combo& combo = combos[i];
+        int pairs = (combo.first == combo.second) ? counts[combo.first] / 2
+                                                  : min(counts[combo.first], counts[combo.second]);
+        counts[combo.first] -= pairs;
+        counts[combo.second] -= pairs;
+        comboCents += (long)pairs * combo.cents;
+    }
+
+    long net = max(0L, subtotal - comboCents);
+    quote.listCents = order.getSubtotalCents();
+    quote.discountCents = quote.listCents - net;
+    quote.feePercent = feePercent[order.getOrderType()];
+    quote.feeCents = (net * quote.feePercent + 50) / 100;
+    quote.totalCents = net + quote.feeCents;
+    return quote;
+}
+
+/**
+ * Reprices every order and compares it with what the order was charged.
+ * The orders are split into contiguous chunks priced on separate threads; pricing only reads
+ * the orders and the compiled tables, so the threads share nothing but their results.
+ * The local time offset is taken once for the whole batch instead of converting every placement time.
+ *
+ * @param orders The orders to reprice.
+ * @param threads Number of threads to use, at least one.
+ * @return The totals of the reprice.
+ */
+Reconciliation PricingRules::reconcile(pmr::vector<Order>& orders, int threads) const{
+    const size_t minChunk = 1024;
+    auto start = chrono::steady_clock::now();
+
+    time_t now = ShiftClock::now();
+    tm local;
+    localtime_r(&now, &local);
+    long offset = local.tm_gmtoff;
+
+    threads = max(1, min<int>(threads, (orders.size() + minChunk - 1) / minChunk));
+    vector<Reconciliation> partial(threads);
+    vector<thread> workers;
+    size_t chunk = (orders.size() + threads - 1) / max(threads, 1);
+
+    auto work = [&](int worker) {
+        Reconciliation& result = partial[worker];
+        size_t end = min(orders.size(), (worker + 1) * chunk);
+        for (size_t i = worker * chunk; i < end; i++) {
+            long charged = orders[i].getTotalCents();
+            int hour = ((orders[i].getPlacedTime() + offset) / 3600) % 24;
+            long expected = priceAt(orders[i], hour).totalCents;
+            result.orders += 1;
+            result.chargedCents += charged;
+            result.expectedCents += expected;
+            result.mismatched += (charged != expected);
+        }
+    };
+
+    for (int worker = 1; worker < threads; worker++) {
+        workers.emplace_back(work, worker);
+    }
+    work(0);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    Reconciliation total;
+    for (const Reconciliation& result : partial) {
+        total.orders += result.orders;
+        total.mismatched += result.mismatched;
+        total.chargedCents += result.chargedCents;
+        total.expectedCents += result.expectedCents;
+    }
+    total.nanoseconds = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    return total;
+}
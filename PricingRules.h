@@ -0,0 +1,112 @@
+/**
+ * @file PricingRules.h
+ * @brief Defines the PricingRules class, which compiles promotion, combo and fee rules into flat
+ *        price tables and prices orders against them.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_PRICINGRULES_H
+#define RESTAURANTREAL_PRICINGRULES_H
+
+#include <cstdint>
+#include <string>
+#include <memory_resource>
+#include <vector>
+#include "Order.h"
+
+using namespace std;
+
+/**
+ * The price of one order under the rules.
+ */
+struct PriceQuote {
+    long listCents = 0; // Meal at menu prices
+    long discountCents = 0; // Taken off by promotions and combos
+    int feePercent = 0; // Service fee for the order's type
+    long feeCents = 0; // Service fee on the discounted meal
+    long totalCents = 0; // Amount to charge
+};
+
+/**
+ * Totals of a batch reprice.
+ */
+struct Reconciliation {
+    long orders = 0; // Orders repriced
+    long mismatched = 0; // Orders charged differently from what the rules give
+    long chargedCents = 0; // Sum of what the orders were charged
+    long expectedCents = 0; // Sum of what the rules give
+    long nanoseconds = 0; // Wall time of the reprice
+};
+
+/**
+ * @class PricingRules
+ * @brief Rules compiled into a discount table indexed by OrderType, hour of day and FOOD code.
+ *
+ * Rules file, one rule per line, '#' starts a comment:
+ *   discount FOOD TYPE|* fromHour toHour percent   percent off a food between the hours, fromHour included
+ *   combo FOOD FOOD dollars                           taken off for each pair of the two foods in an order
+ *   fee TYPE percent                                  service fee charged for an order type
+ *
+ * Foods and types are written as their enum names (BEER, LAVA_CAKE, DOORDASH). Discounts are folded into
+ * the table at load time as the share of the item's price kept, so pricing an order is one table lookup
+ * per item plus one pass over the combos, whatever the number of rules or the menu version.
+ */
+class PricingRules {
+    private:
+        static const int MAX_COMBOS = 32;
+
+        /**
+         * A combo compiled to FOOD codes and cents.
+         */
+        struct Combo {
+            uint8_t first;
+            uint8_t second;
+            int32_t cents;
+        };
+
+        int32_t keptBasis[4][24][17]; // Share of each food's price kept per OrderType and hour, in 1/10000
+        int feePercent[4]; // Service fee per OrderType
+        Combo combos[MAX_COMBOS];
+        int comboCount = 0;
+
+        /**
+         * Prices an order as if it was placed at the given hour.
+         */
+        PriceQuote priceAt(Order& order, int hour) const;
+
+    public:
+        /**
+         * Constructor for the PricingRules class.
+         * Starts from menu prices and the standard service fees, with no promotions.
+         */
+        PricingRules();
+
+        /**
+         * Replaces the rules with the ones in a file.
+         * Lines that cannot be parsed are reported and skipped.
+         *
+         * @param path The rules file.
+         * @return The number of rules loaded, or -1 if the file could not be opened.
+         */
+        int load(const string& path);
+
+        /**
+         * Prices an order at the hour it was placed.
+         *
+         * @param order The order to price.
+         * @return The order's price under the rules.
+         */
+        PriceQuote price(Order& order) const;
+
+        /**
+         * Reprices every order and compares it with what the order was charged.
+         * The orders are split into chunks priced on separate threads.
+         *
+         * @param orders The orders to reprice.
+         * @param threads Number of threads to use, at least one.
+         * @return The totals of the reprice.
+         */
+        Reconciliation reconcile(pmr::vector<Order>& orders, int threads) const;
+};
+
+#endif //RESTAURANTREAL_PRICINGRULES_H
@@ -0,0 +1,261 @@
+/**
+ * @file ReceiptFormatter.cpp
+ * @brief This file contains the ReceiptFormatter class, an allocation-free receipt renderer driven
+ *        by templates compiled per OrderType.
+ * @author Edward Villano
+ */
+
+#include "ReceiptFormatter.h"
+#include <charconv>
+#include <cstring>
+#include <cctype>
+#include <cerrno>
+#include <unistd.h>
+
+const string_view customerSource =
+        "\n---------------------------------\n"
+        "    THANK YOU {name}!\n"
+        "---------------------------------\n\n"
+        "{items}\n"
+        "{discount}{fee}{total}\n"
+        "---------------------------------\n";
+
+const string_view kitchenSource =
+        "\n{name}   {id}\n"
+        "{items}\n"
+        "{discount}{fee}{total}";
+
+const string_view feeLabels[4] = {"Drive Through", "Onsite", "Phone", "Doordash"};
+
+const int nameWidth = 10; // Width the customer name is right aligned to
+const int itemWidth = 15; // Width item names are right aligned to
+
+/**
+ * Bounded output position in a caller's buffer. Once something does not fit,
+ * every further write is dropped and the cursor reports failure.
+ */
+struct ReceiptCursor {
+    char* at;
+    char* end;
+    bool ok = true;
+
+    void put(const char* data, size_t length){
+        if (!ok || (size_t)(end - at) < length) {
+            ok = false;
+            return;
+        }
+        memcpy(at, data, length);
+        at += length;
+    }
+
+    void put(string_view text){
+        put(text.data(), text.size());
+    }
+
+    void spaces(int count){
+        if (count <= 0) {
+            return;
+        }
+        if (!ok || end - at < count) {
+            ok = false;
+            return;
+        }
+        memset(at, ' ', count);
+        at += count;
+    }
+
+    void number(long value){
+        char digits[24];
+        put(digits, to_chars(digits, digits + sizeof(digits), value).ptr - digits);
+    }
+
+    void cents(long amount){
+        char digits[3] = {'.', char('0' + amount % 100 / 10), char('0' + amount % 10)};
+        number(amount / 100);
+        put(digits, 3);
+    }
+};
+
+/**
+ * Constructor for the ReceiptFormatter class.
+ * Compiles the customer and kitchen templates for every order type.
+ */
+ReceiptFormatter::ReceiptFormatter(){
+    for (int type = DRIVE_THROUGH; type <= DOORDASH; type++) {
+        compile(templates[CUSTOMER_COPY][type], customerSource, static_cast<OrderType>(type));
+        compile(templates[KITCHEN_COPY][type], kitchenSource, static_cast<OrderType>(type));
+    }
+}
+
+/**
+ * Compiles a template source for one order type.
+ * Literal text is copied into the pool once. The fee line's label is the type's, so it is
+ * compiled into the fee operation's literal and only the percentage is formatted per order.
+ *
+ * @param compiled Receives the operations.
+ * @param source Template text with {name}, {id}, {items}, {discount}, {fee} and {total} placeholders.
+ * @param type The order type the template is compiled for.
+ */
+void ReceiptFormatter::compile(Template& compiled, string_view source, OrderType type){
+    auto literal = [&](string_view text) {
+        if (text.empty()) {
+            return;
+        }
+        memcpy(literals + literalsUsed, text.data(), text.size());
+        compiled.ops[compiled.count++] = Op{LITERAL, (uint16_t)literalsUsed, (uint16_t)text.size()};
+        literalsUsed += text.size();
+    };
+
+    size_t position = 0;
+    while (position < source.size()) {
+        size_t open = source.find('{', position);
+        if (open == string_view::npos) {
+            literal(source.substr(position));
+            break;
+        }
+        literal(source.substr(position, open - position));
+
+        size_t close = source.find('}', open);
+        string_view placeholder = source.substr(open + 1, close - open - 1);
+        if (placeholder == "name") {
+            compiled.ops[compiled.count++] = Op{NAME, 0, (uint16_t)nameWidth};
+        } else if (placeholder == "id") {
+            compiled.ops[compiled.count++] = Op{ORDER_ID, 0, 0};
+        } else if (placeholder == "items") {
+            compiled.ops[compiled.count++] = Op{ITEMS, 0, 0};
+        } else if (placeholder == "total") {
+            compiled.ops[compiled.count++] = Op{TOTAL, 0, 0};
+        } else if (placeholder == "discount") {
+            compiled.ops[compiled.count++] = Op{DISCOUNT, 0, 0};
+        } else if (placeholder == "fee") {
+            string_view label = feeLabels[type];
+            memcpy(literals + literalsUsed, label.data(), label.size());
+            compiled.ops[compiled.count++] = Op{FEE, (uint16_t)literalsUsed, (uint16_t)label.size()};
+            literalsUsed += label.size();
+        }
+        position = close + 1;
+    }
+}
+
+/**
+ * Renders one receipt into a buffer.
+ *
+ * @param order The order to render; it is not modified.
+ * @param copy Which layout to render.
+ * @param buffer Receives the receipt text.
+ * @param capacity Size of buffer.
+ * @return Bytes written, or 0 if the receipt did not fit.
+ */
+size_t ReceiptFormatter::format(Order& order, ReceiptCopy copy, char* buffer, size_t capacity){
+    const Template& compiled = templates[copy][order.getOrderType()];
+    ReceiptCursor cursor{buffer, buffer + capacity};
+
+    for (int i = 0; i < compiled.count; i++) {
+        const Op& op = compiled.ops[i];
+        switch (op.field) {
+            case LITERAL:
+                cursor.put(literals + op.offset, op.length);
+                break;
+
+            case NAME: {
+                string_view name = order.getName();
+                cursor.spaces(op.length - (int)name.size());
+                if (cursor.ok && (size_t)(cursor.end - cursor.at) >= name.size()) {
+                    for (char c : name) {
+                        *cursor.at++ = toupper((unsigned char)c);
+                    }
+                } else {
+                    cursor.ok = false;
+                }
+                break;
+            }
+
+            case ORDER_ID:
+                cursor.number(order.getOrderID());
+                break;
+
+            case ITEMS:
+                for (const Food& item : order.getMeal()) {
+                    string_view itemName = item.getName();
+                    cursor.spaces(itemWidth - (int)itemName.size());
+                    cursor.put(itemName);
+                    cursor.put("    $");
+                    cursor.cents(item.getPriceCents());
+                    cursor.put("\n", 1);
+                }
+                break;
+
+            case DISCOUNT:
+                if (order.getDiscountCents() > 0) {
+                    cursor.put(" Discounts: -$");
+                    cursor.cents(order.getDiscountCents());
+                    cursor.put("\n", 1);
+                }
+                break;
+
+            case FEE:
+                if (order.getFeePercent() > 0) {
+                    cursor.put(literals + op.offset, op.length);
+                    cursor.put(" Service Fee = ");
+                    cursor.number(order.getFeePercent());
+                    cursor.put("%\n");
+                }
+                break;
+
+            case TOTAL:
+                cursor.put(" Total Price: $");
+                cursor.cents(order.getTotalCents());
+                cursor.put("\n", 1);
+                break;
+        }
+    }
+
+    return cursor.ok ? cursor.at - buffer : 0;
+}
+
+/**
+ * Renders many receipts through one buffer, writing it to a file descriptor whenever it fills.
+ * Receipts that are larger than the whole buffer are skipped.
+ *
+ * @param orders The orders in the system.
+ * @param indexes Indexes of the orders to reprint.
+ * @param copy Which layout to render.
+ * @param buffer Scratch buffer, at least as large as one receipt.
+ * @param capacity Size of buffer.
+ * @param fd File descriptor the receipts are written to.
+ * @return The number of receipts written.
+ */
+int ReceiptFormatter::formatBatch(pmr::vector<Order>& orders, const vector<int>& indexes, ReceiptCopy copy,
+                                  char* buffer, size_t capacity, int fd){
+    size_t used = 0;
+    int written = 0;
+
+    auto flush = [&]() {
+        size_t done = 0;
+        while (done < used) {
+            ssize_t result = write(fd, buffer + done, used - done);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                break;
+            }
+            done += result;
+        }
+        used = 0;
+    };
+
+    for (int index : indexes) {
+        size_t length = format(orders[index], copy, buffer + used, capacity - used);
+        if (length == 0 && used > 0) {
+            flush();
+            length = format(orders[index], copy, buffer, capacity);
+        }
+        if (length > 0) {
+            used += length;
+            written += 1;
+        }
+    }
+    flush();
+    return written;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file ReceiptFormatter.h
+ * @brief Defines the ReceiptFormatter class, which renders order receipts into caller-provided
+ *        buffers from templates compiled once per OrderType, without heap allocation.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_RECEIPTFORMATTER_H
+#define RESTAURANTREAL_RECEIPTFORMATTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "Order.h"
+
+using namespace std;
+
+/**
+ * The two receipt layouts.
+ */
+enum ReceiptCopy {
+    CUSTOMER_COPY, // Thank-you header, handed to the customer
+    KITCHEN_COPY   // Name and order ID header, for the kitchen
+};
+
+/**
+ * @class ReceiptFormatter
+ * @brief Compiles the receipt templates into flat operation lists at construction and renders
+ *        orders with them into fixed buffers.
+ *
+ * Rendering never allocates and never modifies the order: the name is upper-cased while it is copied
+ * and money is formatted from the order's cached totals in integer cents.
+ */
+class ReceiptFormatter {
+    private:
+        /**
+         * What a template operation emits.
+         */
+        enum Field : uint8_t {
+            LITERAL,  // Fixed text from the literal pool
+            NAME,     // Customer name, upper-cased, right aligned to the operation's width
+            ORDER_ID, // Order ID
+            ITEMS,    // One line per food item
+            DISCOUNT, // Discount line, when the pricing rules gave one
+            FEE,      // Service fee line, when the order is charged one
+            TOTAL     // Total price line, discount and service fee included
+        };
+
+        /**
+         * One step of a compiled template.
+         */
+        struct Op {
+            Field field;
+            uint16_t offset; // Start of the text in the literal pool, for LITERAL and the FEE label
+            uint16_t length; // Length of the text for LITERAL and FEE, field width for NAME
+        };
+
+        static const int MAX_OPS = 16;
+
+        /**
+         * A template compiled for one OrderType and copy.
+         */
+        struct Template {
+            Op ops[MAX_OPS];
+            int count = 0;
+        };
+
+        char literals[1024]; // Literal pool shared by every template
+        size_t literalsUsed = 0;
+        Template templates[2][4]; // Compiled templates per ReceiptCopy and OrderType
+
+        /**
+         * Compiles a template source for one order type.
+         * Placeholders are {name}, {id}, {items}, {discount}, {fee} and {total}.
+         */
+        void compile(Template& compiled, string_view source, OrderType type);
+
+    public:
+        /**
+         * Constructor for the ReceiptFormatter class.
+         * Compiles the customer and kitchen templates for every order type.
+         */
+        ReceiptFormatter();
+
+        /**
+         * Renders one receipt into a buffer.
+         *
+         * @param order The order to render; it is not modified.
+         * @param copy Which layout to render.
+         * @param buffer Receives the receipt text.
+         * @param capacity Size of buffer.
+         * @return Bytes written, or 0 if the receipt did not fit.
+         */
+        size_t format(Order& order, ReceiptCopy copy, char* buffer, size_t capacity);
+
+        /**
+         * Renders many receipts through one buffer, writing it to a file descriptor whenever it fills.
+         *
+         * @param orders The orders in the system.
+         * @param indexes Indexes of the orders to reprint.
+         * @param copy Which layout to render.
+         * @param buffer Scratch buffer, at least as large as one receipt.
+         * @param capacity Size of buffer.
+         * @param fd File descriptor the receipts are written to.
+         * @return The number of receipts written.
+         */
+        int formatBatch(pmr::vector<Order>& orders, const vector<int>& indexes, ReceiptCopy copy,
+                        char* buffer, size_t capacity, int fd);
+};
+
+#endif //RESTAURANTREAL_RECEIPTFORMATTER_H
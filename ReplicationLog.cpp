@@ -0,0 +1,324 @@
+/**
+ * @file ReplicationLog.cpp
+ * @brief This file contains the ReplicationLog class, the change log shipped to followers.
+ * @author Edward Villano
+ */
+
+#include "ReplicationLog.h"
+#include <cstring>
+
+/**
+ * Appends a field to the pending operations in host byte order.
+ *
+ * @param value The field.
+ */
+template <typename Field>
+void ReplicationLog::put(Field value){
+    pending.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * Reads a field written by put, if the batch has room for it.
+ */
+template <typename Field>
+static bool get(const char*& at, const char* end, Field& value){
+    if (end - at < (ptrdiff_t)sizeof(value)) {
+        return false;
+    }
+    memcpy(&value, at, sizeof(value));
+    at += sizeof(value);
+    return true;
+}
+
+/**
+ * Starts or stops recording.
+ * A follower taking over continues from the last sequence number it applied, so the followers
+ * that join it see one sequence across leaders.
+ *
+ * @param enabled True to record.
+ * @param lastLSN Sequence number to continue from.
+ */
+void ReplicationLog::setRecording(bool enabled, uint64_t lastLSN){
+    recording = enabled;
+    lsn = lastLSN;
+    pending.clear();
+}
+
+/**
+ * Checks whether changes are recorded.
+ *
+ * @return True while recording.
+ */
+bool ReplicationLog::isRecording() const{
+    return recording;
+}
+
+/**
+ * Retrieves the sequence number of the last operation recorded.
+ *
+ * @return The last LSN, 0 before any.
+ */
+uint64_t ReplicationLog::lastLSN() const{
+    return lsn;
+}
+
+/**
+ * Checks for operations not yet taken.
+ *
+ * @return True if there are none.
+ */
+bool ReplicationLog::empty() const{
+    return pending.empty();
+}
+
+/**
+ * Takes the pending operations for a batch.
+ *
+ * @return The operations, back to back; the log is left empty.
+ */
+string ReplicationLog::take(){
+    string batch;
+    batch.swap(pending);
+    return batch;
+}
+
+/**
+ * Records a new or edited order whole: its fields, name and every item with the price it was charged.
+ *
+ * @param order The order.
+ */
+void ReplicationLog::place(Order& order){
+    if (!recording) {
+        return;
+    }
+    lsn += 1;
+    put<uint8_t>(OP_PLACE);
+    put<int32_t>(order.getOrderID());
+    put<int32_t>(order.getSkipCount());
+    put<uint8_t>(order.getOrderStatus());
+    put<uint8_t>(order.getOrderType());
+    put<int64_t>(order.getPlacedTime());
+    put<int64_t>(order.getPromisedTime());
+    put<int64_t>(order.getDiscountCents());
+    put<int32_t>(order.getFeePercent());
+
+    string_view name = order.getName();
+    put<uint16_t>(name.size());
+    pending.append(name);
+
+    const pmr::vector<Food>& meal = order.getMeal();
+    put<uint16_t>(meal.size());
+    for (const Food& item : meal) {
+        put<uint8_t>(item.getFood());
+        put<int32_t>(item.getPriceCents());
+    }
+}
+
+/**
+ * Records a status change.
+ *
+ * @param orderID The order.
+ * @param status Its new status.
+ */
+void ReplicationLog::status(int orderID, Status status){
+    if (!recording) {
+        return;
+    }
+    lsn += 1;
+    put<uint8_t>(OP_STATUS);
+    put<int32_t>(orderID);
+    put<uint8_t>(status);
+}
+
+/**
+ * Records that the orders ahead of an order were skipped.
+ * The order is named rather than its position, so a follower finds the same boundary by ID.
+ *
+ * @param orderID The order dispatched past them.
+ */
+void ReplicationLog::skip(int orderID){
+    if (!recording) {
+        return;
+    }
+    lsn += 1;
+    put<uint8_t>(OP_SKIP);
+    put<int32_t>(orderID);
+}
+
+/**
+ * Records an order escalated past its service level.
+ *
+ * @param orderID The order.
+ */
+void ReplicationLog::escalate(int orderID){
+    if (!recording) {
+        return;
+    }
+    lsn += 1;
+    put<uint8_t>(OP_ESCALATE);
+    put<int32_t>(orderID);
+}
+
+/**
+ * Records an order flagged as cold on the pickup shelf.
+ *
+ * @param orderID The order.
+ */
+void ReplicationLog::cold(int orderID){
+    if (!recording) {
+        return;
+    }
+    lsn += 1;
+    put<uint8_t>(OP_COLD);
+    put<int32_t>(orderID);
+}
+
+/**
+ * Records a cancelled order.
+ *
+ * @param orderID The order.
+ */
+void ReplicationLog::cancel(int orderID){
+    if (!recording) {
+        return;
+    }
+    lsn += 1;
+    put<uint8_t>(OP_CANCEL);
+    put<int32_t>(orderID);
+}
+
+/**
+ * Records the portions left of a food.
+ *
+ * @param food The food.
+ * @param count Portions left, -1 for unlimited.
+ * @param lowAt Portions at or below which it runs low.
+ */
+void ReplicationLog::stock(FOOD food, int count, int lowAt){
+    if (!recording) {
+        return;
+    }
+    lsn += 1;
+    put<uint8_t>(OP_STOCK);
+    put<int32_t>(food);
+    put<int32_t>(count);
+    put<int32_t>(lowAt);
+}
+
+/**
+ * Records a bulk status transition as one operation with one sequence number: the new status,
+ * the number of orders and their IDs.
+ *
+ * @param orderIDs The orders moved, in ID order.
+ * @param status Their new status.
+ */
+void ReplicationLog::statusBatch(const vector<int>& orderIDs, Status status){
+    if (!recording || orderIDs.empty()) {
+        return;
+    }
+    lsn += 1;
+    put<uint8_t>(OP_STATUS_BATCH);
+    put<int32_t>(orderIDs.size());
+    put<uint8_t>(status);
+    putIDs(orderIDs);
+}
+
+/**
+ * Records ready orders spilled out of memory as one operation with one sequence number:
+ * the number of orders and their IDs.
+ *
+ * @param orderIDs The orders spilled, in ID order.
+ */
+void ReplicationLog::spill(const vector<int>& orderIDs){
+    if (!recording || orderIDs.empty()) {
+        return;
+    }
+    lsn += 1;
+    put<uint8_t>(OP_SPILL);
+    put<int32_t>(orderIDs.size());
+    putIDs(orderIDs);
+}
+
+/**
+ * Appends a list of order IDs to the pending operations.
+ *
+ * @param orderIDs The IDs.
+ */
+void ReplicationLog::putIDs(const vector<int>& orderIDs){
+    size_t at = pending.size();
+    pending.resize(at + orderIDs.size() * sizeof(int32_t));
+    for (int orderID : orderIDs) {
+        int32_t id = orderID;
+        memcpy(&pending[at], &id, sizeof(id));
+        at += sizeof(id);
+    }
+}
+
+/**
+ * Decodes the next operation of a batch.
+ *
+ * @param at Position in the batch, moved past the operation.
+ * @param end End of the batch.
+ * @param op Receives the operation; its name views the batch.
+ * @return False at the end of the batch or if the operation is cut short.
+ */
+bool ReplicationLog::decode(const char*& at, const char* end, ReplicatedOp& op){
+    uint8_t kind;
+    if (!get(at, end, kind) || kind > OP_SPILL || !get(at, end, op.orderID)) {
+        return false;
+    }
+    op.kind = static_cast<ReplicationOpKind>(kind);
+
+    switch (op.kind) {
+        case OP_PLACE: {
+            uint16_t nameLength, mealSize;
+            if (!get(at, end, op.value) || !get(at, end, op.status) || !get(at, end, op.type)
+                || !get(at, end, op.placedTime) || !get(at, end, op.promisedTime)
+                || !get(at, end, op.discountCents) || !get(at, end, op.feePercent)
+                || !get(at, end, nameLength) || end - at < nameLength) {
+                return false;
+            }
+            op.name = string_view(at, nameLength);
+            at += nameLength;
+
+            if (!get(at, end, mealSize)) {
+                return false;
+            }
+            op.items.resize(mealSize);
+            for (ReplicatedItem& item : op.items) {
+                if (!get(at, end, item.code) || !get(at, end, item.cents) || item.code >= 17) {
+                    return false;
+                }
+            }
+            return op.status <= READY_FOR_PICKUP && op.type <= DOORDASH;
+        }
+        case OP_STATUS:
+            return get(at, end, op.status) && op.status <= READY_FOR_PICKUP;
+        case OP_STOCK:
+            return get(at, end, op.value) && get(at, end, op.lowAt) && op.orderID >= 0 && op.orderID < 17;
+        case OP_STATUS_BATCH:
+            if (!get(at, end, op.status) || op.status > READY_FOR_PICKUP) {
+                return false;
+            }
+            [[fallthrough]];
+        case OP_SPILL:
+            if (op.orderID < 0 || (end - at) / (ptrdiff_t)sizeof(int32_t) < op.orderID) {
+                return false;
+            }
+            op.orderIDs.resize(op.orderID);
+            memcpy(op.orderIDs.data(), at, op.orderID * sizeof(int32_t));
+            at += op.orderID * sizeof(int32_t);
+            return true;
+        default:
+            return true;
+    }
+}
+
+/**
+ * Retrieves the memory held by the operations not yet taken for a batch.
+ *
+ * @return The approximate footprint in bytes.
+ */
+size_t ReplicationLog::bytesUsed(){
+    return pending.capacity();
+}
@@ -0,0 +1,215 @@
+/**
+ * @file ReplicationLog.h
+ * @brief Defines the ReplicationLog class, which records the changes made to a system's orders as
+ *        operations a follower can apply to its own copy.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_REPLICATIONLOG_H
+#define RESTAURANTREAL_REPLICATIONLOG_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Order.h"
+
+using namespace std;
+
+/**
+ * Kinds of change in the log.
+ */
+enum ReplicationOpKind : uint8_t {
+    OP_PLACE, // A new order, or a placed order whose meal was edited, carried whole
+    OP_STATUS, // An order moved to a new status
+    OP_SKIP, // Orders ahead of an order were skipped over by a dispatch
+    OP_ESCALATE, // A placed order waited past its service level
+    OP_COLD, // A ready order waited past its pickup service level
+    OP_CANCEL, // A placed order was cancelled
+    OP_STOCK, // The portions left of a food were set
+    OP_STATUS_BATCH, // Many orders moved to one status by a bulk transition
+    OP_SPILL // Ready orders dropped from memory to stay under the memory budget, kept in the history
+};
+
+/**
+ * One item of a replicated order.
+ */
+struct ReplicatedItem {
+    uint8_t code; // FOOD code
+    int32_t cents; // Price the item was charged
+};
+
+/**
+ * One decoded operation. Only the fields of its kind are set; name and items belong to OP_PLACE,
+ * orderIDs to OP_STATUS_BATCH and OP_SPILL, whose orderID is the number of orders.
+ */
+struct ReplicatedOp {
+    ReplicationOpKind kind;
+    int32_t orderID; // The order, or the FOOD for OP_STOCK
+    int32_t value; // Skip count for OP_PLACE, portions for OP_STOCK
+    int32_t lowAt; // Running low threshold for OP_STOCK
+    uint8_t status; // Status for OP_PLACE and OP_STATUS
+    uint8_t type;
+    int64_t placedTime;
+    int64_t promisedTime;
+    int64_t discountCents;
+    int32_t feePercent;
+    string_view name; // Views the decoded batch
+    vector<ReplicatedItem> items;
+    vector<int32_t> orderIDs; // Orders of OP_STATUS_BATCH and OP_SPILL, in ID order
+};
+
+/**
+ * @class ReplicationLog
+ * @brief Records order changes as compact operations, numbered by a log sequence number (LSN).
+ *
+ * The system calls the recorder at every point its orders change: placement, edit, status change,
+ * bulk status change, skip, escalation, cold flag, cancel and restock. While recording is off the
+ * calls return at once, so a standalone system pays a branch per change. Operations accumulate until
+ * the system flushes them to its followers as one batch.
+ *
+ * Operations are written back to back, a kind byte followed by the fields of that kind in host
+ * byte order; leader and followers run on the same machine. Whole orders are carried, never deltas
+ * of them, so applying an operation twice or after a checkpoint that already includes it is harmless.
+ */
+class ReplicationLog {
+    private:
+        string pending; // Operations not yet taken for a batch
+        uint64_t lsn = 0; // Sequence number of the last operation recorded
+        bool recording = false;
+
+        /**
+         * Appends a field to the pending operations.
+         */
+        template <typename Field>
+        void put(Field value);
+
+        /**
+         * Appends a list of order IDs to the pending operations.
+         */
+        void putIDs(const vector<int>& orderIDs);
+
+    public:
+        /**
+         * Starts or stops recording.
+         *
+         * @param enabled True to record.
+         * @param lastLSN Sequence number to continue from, as after taking over from a leader.
+         */
+        void setRecording(bool enabled, uint64_t lastLSN);
+
+        /**
+         * Checks whether changes are recorded.
+         *
+         * @return True while recording.
+         */
+        bool isRecording() const;
+
+        /**
+         * Retrieves the sequence number of the last operation recorded.
+         *
+         * @return The last LSN, 0 before any.
+         */
+        uint64_t lastLSN() const;
+
+        /**
+         * Checks for operations not yet taken.
+         *
+         * @return True if there are none.
+         */
+        bool empty() const;
+
+        /**
+         * Takes the pending operations for a batch.
+         *
+         * @return The operations, back to back; the log is left empty.
+         */
+        string take();
+
+        /**
+         * Records a new or edited order whole.
+         *
+         * @param order The order.
+         */
+        void place(Order& order);
+
+        /**
+         * Records a status change.
+         *
+         * @param orderID The order.
+         * @param status Its new status.
+         */
+        void status(int orderID, Status status);
+
+        /**
+         * Records that the orders ahead of an order were skipped.
+         *
+         * @param orderID The order dispatched past them.
+         */
+        void skip(int orderID);
+
+        /**
+         * Records an order escalated past its service level.
+         *
+         * @param orderID The order.
+         */
+        void escalate(int orderID);
+
+        /**
+         * Records an order flagged as cold on the pickup shelf.
+         *
+         * @param orderID The order.
+         */
+        void cold(int orderID);
+
+        /**
+         * Records a cancelled order.
+         *
+         * @param orderID The order.
+         */
+        void cancel(int orderID);
+
+        /**
+         * Records the portions left of a food.
+         *
+         * @param food The food.
+         * @param count Portions left, -1 for unlimited.
+         * @param lowAt Portions at or below which it runs low.
+         */
+        void stock(FOOD food, int count, int lowAt);
+
+        /**
+         * Records a bulk status transition as one operation.
+         *
+         * @param orderIDs The orders moved, in ID order.
+         * @param status Their new status.
+         */
+        void statusBatch(const vector<int>& orderIDs, Status status);
+
+        /**
+         * Records ready orders spilled out of memory as one operation.
+         *
+         * @param orderIDs The orders spilled, in ID order.
+         */
+        void spill(const vector<int>& orderIDs);
+
+        /**
+         * Decodes the next operation of a batch.
+         *
+         * @param at Position in the batch, moved past the operation.
+         * @param end End of the batch.
+         * @param op Receives the operation; its name views the batch.
+         * @return False at the end of the batch or if the operation is cut short.
+         */
+        static bool decode(const char*& at, const char* end, ReplicatedOp& op);
+
+        /**
+         * Retrieves the memory held by the operations not yet taken for a batch.
+         *
+         * @return The approximate footprint in bytes.
+         */
+        size_t bytesUsed();
+};
+
+#endif //RESTAURANTREAL_REPLICATIONLOG_H
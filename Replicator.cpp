@@ -0,0 +1,506 @@
+/**
+ * @file Replicator.cpp
+ * @brief This file contains the ReplicationLeader and ReplicationFollower classes, the two ends of
+ *        log shipping between terminals.
+ * @author Edward Villano
+ */
+
+#include "Replicator.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const size_t MIN_CHECKPOINT_BATCH_BYTES = 4 * 1024 * 1024;
+static const int SEND_TIMEOUT_SECONDS = 2;
+
+/**
+ * Reads the steady clock, which is the same clock in every process of the machine.
+ */
+static int64_t steadyNanos(){
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Builds a frame: its header followed by the payload.
+ */
+static string makeFrame(ReplicationFrameKind kind, const string& payload, uint64_t lastLSN){
+    ReplicationFrame header{static_cast<uint32_t>(payload.size()), kind, lastLSN, steadyNanos()};
+    string frame;
+    frame.reserve(sizeof(header) + payload.size());
+    frame.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    frame.append(payload);
+    return frame;
+}
+
+/**
+ * Fills in the address of a socket path.
+ */
+static bool socketAddress(const string& path, sockaddr_un& address){
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    memcpy(address.sun_path, path.data(), path.size());
+    return true;
+}
+
+/**
+ * Writes frames to a socket with as few calls as the kernel allows, resuming after partial writes.
+ *
+ * @return False if the socket broke or stayed full past the send timeout.
+ */
+static bool sendFrames(int socket, const vector<shared_ptr<const string>>& frames){
+    const size_t maxVectors = 64;
+    size_t next = 0, offset = 0;
+
+    while (next < frames.size()) {
+        iovec vectors[maxVectors];
+        size_t count = 0;
+        for (size_t k = next; k < frames.size() && count < maxVectors; k++, count++) {
+            size_t skip = (k == next) ? offset : 0;
+            vectors[count].iov_base = const_cast<char*>(frames[k]->data() + skip);
+            vectors[count].iov_len = frames[k]->size() - skip;
+        }
+
+        msghdr message{};
+        message.msg_iov = vectors;
+        message.msg_iovlen = count;
+        ssize_t sent = sendmsg(socket, &message, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        while (sent > 0) {
+            size_t left = frames[next]->size() - offset;
+            if ((size_t)sent >= left) {
+                sent -= left;
+                next += 1;
+                offset = 0;
+            } else {
+                offset += sent;
+                sent = 0;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Destructor for the ReplicationLeader class.
+ * Stops leading, telling the followers it was a normal exit.
+ */
+ReplicationLeader::~ReplicationLeader(){
+    stop();
+}
+
+/**
+ * Claims a socket path and starts accepting followers on it.
+ * The claim is a lock on path.lock, held until stop or until the process dies. A socket file left
+ * at the path by a leader that died is replaced.
+ *
+ * @param path The socket path.
+ * @return False if another process leads the path or the socket cannot be bound.
+ */
+bool ReplicationLeader::start(const string& path){
+    sockaddr_un address;
+    if (isRunning() || !socketAddress(path, address)) {
+        return false;
+    }
+
+    lockFile = open((path + ".lock").c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (lockFile < 0 || flock(lockFile, LOCK_EX | LOCK_NB) != 0) {
+        if (lockFile >= 0) {
+            ::close(lockFile);
+            lockFile = -1;
+        }
+        return false;
+    }
+
+    unlink(path.c_str());
+    listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(listener, 16) != 0 || pipe2(wakePipe, O_NONBLOCK | O_CLOEXEC) != 0) {
+        cerr << "Replication socket " << path << " cannot be opened: " << strerror(errno) << endl;
+        if (listener >= 0) {
+            ::close(listener);
+            listener = -1;
+        }
+        ::close(lockFile);
+        lockFile = -1;
+        return false;
+    }
+
+    socketPath = path;
+    stopping = false;
+    sender = thread(&ReplicationLeader::run, this);
+    return true;
+}
+
+/**
+ * Sends the followers everything published, tells them the leader is shutting down and
+ * gives up the socket path.
+ */
+void ReplicationLeader::stop(){
+    if (!isRunning()) {
+        return;
+    }
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake();
+    sender.join();
+
+    ::close(listener);
+    listener = -1;
+    ::close(wakePipe[0]);
+    ::close(wakePipe[1]);
+    wakePipe[0] = wakePipe[1] = -1;
+    // The path goes before the lock, so whoever claims it next binds a fresh socket
+    unlink(socketPath.c_str());
+    ::close(lockFile);
+    lockFile = -1;
+
+    checkpoint.reset();
+    frames.clear();
+    frameBytes = 0;
+}
+
+/**
+ * Checks whether the leader is running.
+ *
+ * @return True between start and stop.
+ */
+bool ReplicationLeader::isRunning() const{
+    return listener >= 0;
+}
+
+/**
+ * Replaces the checkpoint new followers start from and drops the batches it includes.
+ * A follower already sent every dropped batch carries on with the next one; any other
+ * follower is sent the new checkpoint.
+ *
+ * @param state The whole state as a state file, including everything published so far.
+ * @param lastLSN Sequence number of the last operation it includes.
+ */
+void ReplicationLeader::setCheckpoint(const string& state, uint64_t lastLSN){
+    auto frame = make_shared<const string>(makeFrame(FRAME_CHECKPOINT, state, lastLSN));
+    {
+        lock_guard<mutex> guard(lock);
+        checkpoint = frame;
+        firstFrame += frames.size();
+        frames.clear();
+        frameBytes = 0;
+        publishedLSN = lastLSN;
+    }
+    wake();
+}
+
+/**
+ * Checks whether the batches since the checkpoint have grown enough for a new one:
+ * past MIN_CHECKPOINT_BATCH_BYTES and past the checkpoint itself.
+ *
+ * @return True if a new checkpoint is due.
+ */
+bool ReplicationLeader::wantsCheckpoint(){
+    lock_guard<mutex> guard(lock);
+    return checkpoint == nullptr
+           || (frameBytes > MIN_CHECKPOINT_BATCH_BYTES && frameBytes > checkpoint->size());
+}
+
+/**
+ * Publishes a batch of operations to every follower.
+ *
+ * @param operations The operations, as taken from the log.
+ * @param lastLSN Sequence number of the last of them.
+ */
+void ReplicationLeader::publish(const string& operations, uint64_t lastLSN){
+    auto frame = make_shared<const string>(makeFrame(FRAME_BATCH, operations, lastLSN));
+    {
+        lock_guard<mutex> guard(lock);
+        frameBytes += frame->size();
+        frames.push_back(std::move(frame));
+        publishedLSN = lastLSN;
+    }
+    wake();
+}
+
+/**
+ * Retrieves the last sequence number published.
+ *
+ * @return The LSN.
+ */
+uint64_t ReplicationLeader::lastLSN(){
+    lock_guard<mutex> guard(lock);
+    return publishedLSN;
+}
+
+/**
+ * Retrieves the replication state of every connected follower.
+ *
+ * @return One entry per follower.
+ */
+vector<FollowerStatus> ReplicationLeader::status(){
+    lock_guard<mutex> guard(lock);
+    vector<FollowerStatus> result;
+    for (const Follower& follower : followers) {
+        result.push_back(follower.status);
+    }
+    return result;
+}
+
+/**
+ * Retrieves the memory held for followers: the checkpoint and the batches published since.
+ * Followers still being sent a frame share it, so it is counted once.
+ *
+ * @return The approximate footprint in bytes.
+ */
+size_t ReplicationLeader::bytesUsed(){
+    lock_guard<mutex> guard(lock);
+    return (checkpoint ? checkpoint->size() : 0) + frameBytes;
+}
+
+/**
+ * Wakes the sender. The pipe is non-blocking; if it is full the sender is already due to wake.
+ */
+void ReplicationLeader::wake(){
+    char byte = 1;
+    if (write(wakePipe[1], &byte, 1) < 0) {
+        return;
+    }
+}
+
+/**
+ * Sends a follower everything it has not seen: the checkpoint if it was never sent one or has
+ * fallen behind the batches kept, then the batches after it, all in one gathered write.
+ *
+ * @param follower The follower.
+ * @return False if the follower broke off or is too slow to keep.
+ */
+bool ReplicationLeader::sendPending(Follower& follower){
+    vector<shared_ptr<const string>> pending;
+    {
+        lock_guard<mutex> guard(lock);
+        if (checkpoint == nullptr) {
+            return true;
+        }
+        if (!follower.synced || follower.nextFrame < firstFrame) {
+            pending.push_back(checkpoint);
+            follower.nextFrame = firstFrame;
+            follower.synced = true;
+        }
+        pending.insert(pending.end(), frames.begin() + (follower.nextFrame - firstFrame), frames.end());
+        follower.nextFrame = firstFrame + frames.size();
+    }
+    return pending.empty() || sendFrames(follower.socket, pending);
+}
+
+/**
+ * Reads a follower's acknowledgements and updates its lag.
+ *
+ * @param follower The follower.
+ * @return False if the follower closed the connection.
+ */
+bool ReplicationLeader::readAcks(Follower& follower){
+    char buffer[4096];
+    ssize_t got = recv(follower.socket, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (got == 0) {
+        return false;
+    }
+    if (got < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    follower.acks.append(buffer, got);
+
+    int64_t now = steadyNanos();
+    size_t used = 0;
+    lock_guard<mutex> guard(lock);
+    for (; follower.acks.size() - used >= sizeof(ReplicationAck); used += sizeof(ReplicationAck)) {
+        ReplicationAck ack;
+        memcpy(&ack, follower.acks.data() + used, sizeof(ack));
+        double lagMs = (now - ack.sentNanos) / 1e6;
+        FollowerStatus& status = follower.status;
+        status.ackedLSN = ack.appliedLSN;
+        status.lagMs = lagMs;
+        status.maxLagMs = max(status.maxLagMs, lagMs);
+        status.meanLagMs += (lagMs - status.meanLagMs) / (follower.ackCount + 1);
+        follower.ackCount += 1;
+    }
+    follower.acks.erase(0, used);
+    return true;
+}
+
+/**
+ * Accepts followers, sends them frames and reads their acknowledgements until stopped.
+ * The thread sleeps in poll until a batch is published, a follower connects or acknowledges.
+ * When stopped, every follower is sent what it is missing and then the shutdown frame.
+ */
+void ReplicationLeader::run(){
+    vector<pollfd> polls;
+
+    while (true) {
+        polls.assign({{wakePipe[0], POLLIN, 0}, {listener, POLLIN, 0}});
+        for (const Follower& follower : followers) {
+            polls.push_back({follower.socket, POLLIN, 0});
+        }
+        if (poll(polls.data(), polls.size(), -1) < 0 && errno != EINTR) {
+            break;
+        }
+
+        char drain[64];
+        while (read(wakePipe[0], drain, sizeof(drain)) > 0) {
+        }
+        {
+            lock_guard<mutex> guard(lock);
+            if (stopping) {
+                break;
+            }
+        }
+
+        if (polls[1].revents & POLLIN) {
+            int socket = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+            if (socket >= 0) {
+                timeval timeout{SEND_TIMEOUT_SECONDS, 0};
+                setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                lock_guard<mutex> guard(lock);
+                followers.emplace_back(socket);
+            }
+        }
+
+        vector<bool> alive(followers.size(), true);
+        for (size_t k = 0; k < followers.size(); k++) {
+            if (k + 2 < polls.size() && (polls[k + 2].revents & (POLLIN | POLLHUP | POLLERR))) {
+                alive[k] = readAcks(followers[k]);
+            }
+            alive[k] = alive[k] && sendPending(followers[k]);
+        }
+
+        lock_guard<mutex> guard(lock);
+        size_t kept = 0;
+        for (size_t k = 0; k < followers.size(); k++) {
+            if (alive[k]) {
+                followers[kept++] = std::move(followers[k]);
+            } else {
+                ::close(followers[k].socket);
+            }
+        }
+        followers.erase(followers.begin() + kept, followers.end());
+    }
+
+    auto shutdownFrame = make_shared<const string>(makeFrame(FRAME_SHUTDOWN, "", lastLSN()));
+    for (Follower& follower : followers) {
+        if (sendPending(follower)) {
+            sendFrames(follower.socket, {shutdownFrame});
+        }
+        ::close(follower.socket);
+    }
+    lock_guard<mutex> guard(lock);
+    followers.clear();
+}
+
+/**
+ * Destructor for the ReplicationFollower class.
+ * Closes the connection.
+ */
+ReplicationFollower::~ReplicationFollower(){
+    close();
+}
+
+/**
+ * Connects to the leader of a socket path.
+ *
+ * @param path The socket path.
+ * @return False if no leader accepted the connection.
+ */
+bool ReplicationFollower::connect(const string& path){
+    sockaddr_un address;
+    close();
+    if (!socketAddress(path, address)) {
+        return false;
+    }
+    socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (socket < 0 || ::connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Reads exactly size bytes, unless the connection breaks first.
+ */
+static bool receiveAll(int socket, char* data, size_t size){
+    while (size > 0) {
+        ssize_t got = recv(socket, data, size, MSG_WAITALL);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        data += got;
+        size -= got;
+    }
+    return true;
+}
+
+/**
+ * Waits for the next frame.
+ *
+ * @param header Receives the frame's header.
+ * @param payload Receives its payload.
+ * @return False if the connection broke.
+ */
+bool ReplicationFollower::receive(ReplicationFrame& header, string& payload){
+    if (socket < 0 || !receiveAll(socket, reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    payload.resize(header.bytes);
+    return receiveAll(socket, payload.data(), payload.size());
+}
+
+/**
+ * Checks whether another frame has already arrived, so acknowledgements can wait for the last
+ * frame of a burst.
+ *
+ * @return True if receive would not wait.
+ */
+bool ReplicationFollower::hasPending(){
+    pollfd ready{socket, POLLIN, 0};
+    return poll(&ready, 1, 0) > 0 && (ready.revents & POLLIN);
+}
+
+/**
+ * Acknowledges the frames applied.
+ *
+ * @param header Header of the last frame applied.
+ */
+void ReplicationFollower::acknowledge(const ReplicationFrame& header){
+    ReplicationAck ack{header.lastLSN, header.sentNanos};
+    if (send(socket, &ack, sizeof(ack), MSG_NOSIGNAL) < 0) {
+        return;
+    }
+}
+
+/**
+ * Closes the connection.
+ */
+void ReplicationFollower::close(){
+    if (socket >= 0) {
+        ::close(socket);
+        socket = -1;
+    }
+}
@@ -0,0 +1,270 @@
+/**
+ * @file Replicator.h
+ * @brief Defines the ReplicationLeader and ReplicationFollower classes, which ship a system's change
+ *        log over a local socket from the terminal that takes orders to standby terminals.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_REPLICATOR_H
+#define RESTAURANTREAL_REPLICATOR_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Kinds of frame sent from a leader to its followers.
+ */
+enum ReplicationFrameKind : uint32_t {
+    FRAME_CHECKPOINT, // The whole state, as a state file; replaces the follower's orders
+    FRAME_BATCH, // Operations recorded since the frame before
+    FRAME_SHUTDOWN // The leader is exiting normally; followers stop rather than take over
+};
+
+/**
+ * Header of every frame, followed by bytes of payload.
+ */
+struct ReplicationFrame {
+    uint32_t bytes; // Payload size
+    uint32_t kind; // ReplicationFrameKind
+    uint64_t lastLSN; // Sequence number the follower is at once the frame is applied
+    int64_t sentNanos; // Steady clock when the leader published the frame
+};
+
+/**
+ * Sent back by a follower once it has applied everything it was sent.
+ */
+struct ReplicationAck {
+    uint64_t appliedLSN;
+    int64_t sentNanos; // Of the last frame applied
+};
+
+/**
+ * How a follower's replication ended.
+ */
+enum FollowEnd {
+    LEADER_SHUT_DOWN, // The leader exited normally
+    LEADER_LOST, // The connection broke without a shutdown frame
+    NO_LEADER // Nothing accepted the connection
+};
+
+/**
+ * Replication state of one follower, as seen by the leader.
+ */
+struct FollowerStatus {
+    uint64_t ackedLSN; // Last sequence number the follower applied
+    double lagMs; // Publish to acknowledgement of the follower's last acknowledged frame
+    double maxLagMs; // Largest lag since the follower joined
+    double meanLagMs; // Mean lag over the follower's acknowledgements
+};
+
+/**
+ * @class ReplicationLeader
+ * @brief Streams the change log to every follower connected to a Unix domain socket.
+ *
+ * Leadership of a socket path is an exclusive lock on a file beside it, which the kernel drops when
+ * the process dies, so exactly one process can lead a path and a follower may claim it as soon as
+ * its leader is gone.
+ *
+ * The log is kept as the latest checkpoint, a state file of everything up to some LSN, followed by
+ * the batch frames published since. A follower that joins gets the checkpoint and the batches after
+ * it, then every new batch as it is published. Frames are shared, immutable and sent on a thread of
+ * the leader's own, so publishing only appends a pointer; the sender writes everything a follower
+ * has not seen in one gathered write per wake, so a follower that falls behind catches up in large
+ * writes instead of many small ones, and it never waits for acknowledgements before sending more.
+ * Once the batches outgrow the checkpoint the system takes a new one, and a follower still behind
+ * the old batches then starts over from it.
+ */
+class ReplicationLeader {
+    private:
+        /**
+         * One connected follower.
+         */
+        struct Follower {
+            int socket = -1; // Connection to the follower
+            bool synced = false; // Whether it was sent a checkpoint
+            uint64_t nextFrame = 0; // Frame number of the first batch it has not been sent
+            string acks; // Acknowledgement bytes not yet complete
+            FollowerStatus status{};
+            long ackCount = 0;
+
+            explicit Follower(int socketP) : socket(socketP) {
+            }
+        };
+
+        string socketPath;
+        int lockFile = -1;
+        int listener = -1;
+        int wakePipe[2] = {-1, -1};
+        thread sender;
+
+        mutex lock; // Guards everything below
+        shared_ptr<const string> checkpoint; // Frame of the latest checkpoint
+        vector<shared_ptr<const string>> frames; // Batch frames published since the checkpoint
+        uint64_t firstFrame = 0; // Frame number of frames[0]
+        size_t frameBytes = 0; // Bytes of frames
+        uint64_t publishedLSN = 0;
+        vector<Follower> followers;
+        bool stopping = false;
+
+        /**
+         * Accepts followers, sends them frames and reads their acknowledgements until stopped.
+         */
+        void run();
+
+        /**
+         * Sends a follower everything it has not seen.
+         */
+        bool sendPending(Follower& follower);
+
+        /**
+         * Reads a follower's acknowledgements.
+         */
+        bool readAcks(Follower& follower);
+
+        /**
+         * Wakes the sender.
+         */
+        void wake();
+
+    public:
+        ReplicationLeader() = default;
+
+        /**
+         * Destructor for the ReplicationLeader class.
+         * Stops leading, telling the followers it was a normal exit.
+         */
+        ~ReplicationLeader();
+
+        ReplicationLeader(const ReplicationLeader&) = delete;
+        ReplicationLeader& operator=(const ReplicationLeader&) = delete;
+
+        /**
+         * Claims a socket path and starts accepting followers on it.
+         *
+         * @param path The socket path.
+         * @return False if another process leads the path or the socket cannot be bound.
+         */
+        bool start(const string& path);
+
+        /**
+         * Sends the followers everything published, tells them the leader is shutting down and
+         * gives up the socket path.
+         */
+        void stop();
+
+        /**
+         * Checks whether the leader is running.
+         *
+         * @return True between start and stop.
+         */
+        bool isRunning() const;
+
+        /**
+         * Replaces the checkpoint new followers start from.
+         *
+         * @param state The whole state as a state file, including everything published so far.
+         * @param lastLSN Sequence number of the last operation it includes.
+         */
+        void setCheckpoint(const string& state, uint64_t lastLSN);
+
+        /**
+         * Checks whether the batches since the checkpoint have grown enough for a new one.
+         *
+         * @return True if a new checkpoint is due.
+         */
+        bool wantsCheckpoint();
+
+        /**
+         * Publishes a batch of operations to every follower.
+         *
+         * @param operations The operations, as taken from the log.
+         * @param lastLSN Sequence number of the last of them.
+         */
+        void publish(const string& operations, uint64_t lastLSN);
+
+        /**
+         * Retrieves the last sequence number published.
+         *
+         * @return The LSN.
+         */
+        uint64_t lastLSN();
+
+        /**
+         * Retrieves the replication state of every connected follower.
+         *
+         * @return One entry per follower.
+         */
+        vector<FollowerStatus> status();
+
+        /**
+         * Retrieves the memory held for followers: the checkpoint and the batches published since.
+         *
+         * @return The approximate footprint in bytes.
+         */
+        size_t bytesUsed();
+};
+
+/**
+ * @class ReplicationFollower
+ * @brief Receives the frames of a leader over its socket and acknowledges them.
+ */
+class ReplicationFollower {
+    private:
+        int socket = -1;
+
+    public:
+        ReplicationFollower() = default;
+
+        /**
+         * Destructor for the ReplicationFollower class.
+         * Closes the connection.
+         */
+        ~ReplicationFollower();
+
+        ReplicationFollower(const ReplicationFollower&) = delete;
+        ReplicationFollower& operator=(const ReplicationFollower&) = delete;
+
+        /**
+         * Connects to the leader of a socket path.
+         *
+         * @param path The socket path.
+         * @return False if no leader accepted the connection.
+         */
+        bool connect(const string& path);
+
+        /**
+         * Waits for the next frame.
+         *
+         * @param header Receives the frame's header.
+         * @param payload Receives its payload.
+         * @return False if the connection broke.
+         */
+        bool receive(ReplicationFrame& header, string& payload);
+
+        /**
+         * Checks whether another frame has already arrived.
+         *
+         * @return True if receive would not wait.
+         */
+        bool hasPending();
+
+        /**
+         * Acknowledges the frames applied.
+         *
+         * @param header Header of the last frame applied.
+         */
+        void acknowledge(const ReplicationFrame& header);
+
+        /**
+         * Closes the connection.
+         */
+        void close();
+};
+
+#endif //RESTAURANTREAL_REPLICATOR_H
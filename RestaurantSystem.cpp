@@ -5,43 +5,59 @@
 
 #include "Order.h"
 #include "RestaurantSystem.h"
+#include "ShiftClock.h"
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <vector>
 #include <limits>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <charconv>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
 
 /**
  * Adds a skip count to all phone and Doordash orders.
  * This function iterates through the orders and increases the skip count for each.
+ * Skip counts only grow and stop at three, so the leading orders already there are passed over.
  *
  * @param index The number of orders to process.
  */
 void RestaurantSystem::addSkipCountToAll(int index) {
-    for (int i = 0; i < index; i++){
+    if (index > 0 && index < Orders.size()) {
+        replication.skip(Orders[index].getOrderID());
+    }
+    int end = min<int>(index, Orders.size());
+    for (int i = min(saturatedSkips, end); i < end; i++){
         Orders[i].increaseSkipCount();
     }
+    while (saturatedSkips < end && Orders[saturatedSkips].getSkipCount() == 3) {
+        saturatedSkips += 1;
+    }
 }
 
 /**
  * Checks for lower priority orders based on specific criteria.
- * It iterates through orders to find the first order that matches the criteria:
- * Order status is PLACED, skip count is 3, and order type is either PHONE or DOORDASH.
+ * It walks the phone and then the Doordash cook queue to find the first order that matches the criteria:
+ * Order status is PLACED, skip count is 3, and it was placed before the order at index.
  *
- * @param index The number of orders to check.
+ * @param index The index of the order that would be dispatched.
  * @return The index of the first order that matches the criteria or the passed index if no match is found.
  */
 int RestaurantSystem::checkLowerPriority(int index) {
-    for (int i = 0; i < index; i++) {
-        if ((Orders[i].getOrderStatus() == PLACED) && (Orders[i].getSkipCount() == 3)
-            && (Orders[i].getOrderType() == PHONE)) {
-            return i;
-        }
-    }
-    for (int i = 0; i < index; i++) {
-        if ((Orders[i].getOrderStatus() == PLACED) && (Orders[i].getSkipCount() == 3)
-            && (Orders[i].getOrderType() == DOORDASH)) {
-            return i;
+    int beforeID = (index < Orders.size()) ? Orders[index].getOrderID() : nextID;
+    vector<int> waiting;
+    for (OrderType type : {PHONE, DOORDASH}) {
+        waiting.clear();
+        pipeline.waitingBefore(type, beforeID, waiting);
+        for (int orderID : waiting) {
+            int i = findOrderIndex(orderID);
+            if (i >= 0 && Orders[i].getOrderStatus() == PLACED && Orders[i].getSkipCount() == 3) {
+                return i;
+            }
         }
     }
     return index;
@@ -49,49 +65,450 @@ int RestaurantSystem::checkLowerPriority(int index) {
 
 /**
  * Checks the queue for a specific type of order.
- * This function looks for the next order of a given type that is placed, and updates its status to cooking.
+ * This function takes the next placed order of a given type from its cook queue, and updates its status to cooking.
  * It also handles the logic for adding skip counts and printing the order.
+ * A queued task whose order is gone or no longer placed is taken out of the queue and passed over.
  *
  * @param type The type of order to look for.
  * @return True if a matching order is found and processed, false otherwise.
  */
 bool RestaurantSystem::checkQueueForType(OrderType type){
     int tempIndex = 0;
-    for (int i = 0; i < Orders.size(); i++){
-        if (Orders[i].getOrderStatus() == PLACED && Orders[i].getOrderType() == type
-            && ( (Orders.size() == 1) || (i != currentOrderIndex) ) ) {
-            if (type == DRIVE_THROUGH || type == ONSITE ) {
-                tempIndex = checkLowerPriority(i);
-                //Add skip count to skipped orders
-                addSkipCountToAll(i);
-            } else {
-                tempIndex = i;
+    int skipID = (Orders.size() > 1 && currentOrderIndex < Orders.size()) ? Orders[currentOrderIndex].getOrderID() : -1;
+    int orderID = pipeline.firstWaiting(type, skipID);
+    int i = (orderID >= 0) ? findOrderIndex(orderID) : -1;
+    while (orderID >= 0 && (i < 0 || Orders[i].getOrderStatus() != PLACED)) {
+        pipeline.discard(type, orderID, (i >= 0) ? Orders[i].getTask() : -1);
+        orderID = pipeline.firstWaiting(type, skipID);
+        i = (orderID >= 0) ? findOrderIndex(orderID) : -1;
+    }
+    if (i < 0) {
+        return false;
+    }
+    if (type == DRIVE_THROUGH || type == ONSITE ) {
+        tempIndex = checkLowerPriority(i);
+        //Add skip count to skipped orders
+        addSkipCountToAll(i);
+    } else {
+        tempIndex = i;
+    }
+    dispatchOrder(tempIndex);
+
+    return true;
+};
+
+/**
+ * Sends an order to the kitchen.
+ * Prints the order unless echo is off and marks it as cooking, which takes it out of the placed queue aggregates
+ * and the deadline heap.
+ *
+ * @param index Index of the order to dispatch.
+ */
+void RestaurantSystem::dispatchOrder(int index){
+    if (echo) {
+        Orders[index].print(false);
+    }
+    clearSlaTimer(Orders[index]);
+    // set status to cooking
+
+    changeStatus(Orders[index], 0);
+    currentOrderIndex = index;
+    lastDispatchedID = Orders[index].getOrderID();
+}
+
+/**
+ * Finds an order by its ID.
+ * Orders are appended with increasing IDs, so the list is searched with a binary search.
+ *
+ * @param orderID The ID to look for.
+ * @return The index of the order, or -1 if it is not in the system.
+ */
+int RestaurantSystem::findOrderIndex(int orderID){
+    auto it = lower_bound(Orders.begin(), Orders.end(), orderID,
+                          [](Order& order, int id) { return order.getOrderID() < id; });
+    if (it == Orders.end() || it->getOrderID() != orderID){
+        return -1;
+    }
+    return static_cast<int>(it - Orders.begin());
+}
+
+/**
+ * Registers an order loaded from file with the queue aggregates it belongs to.
+ *
+ * @param order The loaded order.
+ */
+void RestaurantSystem::trackOrder(Order& order){
+    nameIndex.insert(order.getName(), order.getOrderID(), order.getOrderStatus());
+    trackQueues(order);
+}
+
+/**
+ * Registers an order with the queue aggregates, timers and deadlines of its status.
+ * Loading a file indexes the names of all its orders at once instead.
+ *
+ * @param order The loaded order.
+ */
+void RestaurantSystem::trackQueues(Order& order){
+    order.setTask(pipeline.start(order.getOrderID(), order.getOrderType(), order.getOrderStatus()));
+    if (order.getOrderStatus() == PLACED){
+        batcher.addOrder(order);
+        estimator.orderPlaced(order);
+        deadlines.add(order);
+        armSlaTimer(order, PLACED_SLA);
+    } else if (order.getOrderStatus() == READY_FOR_PICKUP){
+        armSlaTimer(order, PICKUP_SLA);
+    } else if (order.getOrderStatus() == COOKING){
+        estimator.orderPlaced(order);
+        estimator.orderDispatched(order);
+    }
+}
+
+/**
+ * Arms the service level timer of an order, replacing any timer it already has.
+ * The threshold comes from the order's type.
+ *
+ * @param order The order to guard.
+ * @param kind Which service level to guard.
+ */
+void RestaurantSystem::armSlaTimer(Order& order, TimerKind kind){
+    int seconds = (kind == PLACED_SLA) ? placedSlaSeconds[order.getOrderType()]
+                                       : pickupSlaSeconds[order.getOrderType()];
+    clearSlaTimer(order);
+    order.setSlaTimer(timers.arm(ShiftClock::now() + seconds, order.getOrderID(), kind));
+}
+
+/**
+ * Cancels the service level timer of an order, if one is armed.
+ *
+ * @param order The order whose timer is cancelled.
+ */
+void RestaurantSystem::clearSlaTimer(Order& order){
+    timers.cancel(order.getSlaTimer());
+    order.setSlaTimer(-1);
+}
+
+/**
+ * Moves the task of an order on to the order's new status. An order whose task already ended,
+ * as when a follower is told to move a ready order back, gets a new one.
+ *
+ * @param order The order whose status changed.
+ */
+void RestaurantSystem::advanceTask(Order& order){
+    if (order.getTask() < 0) {
+        order.setTask(pipeline.start(order.getOrderID(), order.getOrderType(), order.getOrderStatus()));
+        return;
+    }
+    pipeline.signal(order.getTask(), order.getOrderStatus());
+    if (order.getOrderStatus() == READY_FOR_PICKUP) {
+        // The task ends on its next resume
+        order.setTask(-1);
+    }
+}
+
+/**
+ * Publishes an event about an order on the event bus.
+ *
+ * @param kind What happened to the order.
+ * @param order The order the event is about.
+ * @param fromStatus The order's status before the event.
+ */
+void RestaurantSystem::publishEvent(EventKind kind, Order& order, Status fromStatus){
+    OrderEvent event{};
+    event.timestamp = ShiftClock::now();
+    event.orderID = order.getOrderID();
+    event.kind = kind;
+    event.type = order.getOrderType();
+    event.fromStatus = fromStatus;
+    event.toStatus = order.getOrderStatus();
+    events.publish(event);
+}
+
+/**
+ * Keeps the kitchen's demand, the wait aggregates and the deadlines in step with a change of an order's status.
+ * An order leaving the placed queue takes its items and queued work with it: into the kitchen when it
+ * is dispatched, out of the estimator altogether when it skips cooking. It leaves the deadline heap either
+ * way. Leaving the kitchen completes its work and records whether its promise was met, once per cooking.
+ * An order moved back to placed joins the queue and the deadline heap again.
+ *
+ * @param order The order, already at its new status.
+ * @param fromStatus The order's status before the change.
+ */
+void RestaurantSystem::updateQueues(Order& order, Status fromStatus){
+    Status status = order.getOrderStatus();
+    if (status == fromStatus) {
+        return;
+    }
+    if (fromStatus == PLACED) {
+        // leaving the placed queue, so its items no longer count as demand
+        batcher.removeOrder(order);
+        deadlines.remove(order.getOrderID());
+        if (status == COOKING) {
+            estimator.orderDispatched(order);
+        } else {
+            estimator.orderCancelled(order);
+        }
+    } else if (fromStatus == COOKING) {
+        estimator.orderCompleted(order);
+        if (status != PLACED) {
+            deadlines.recordCompletion(order, ShiftClock::now());
+        }
+    }
+    if (status == PLACED) {
+        batcher.addOrder(order);
+        estimator.orderPlaced(order);
+        deadlines.add(order);
+    }
+}
+
+/**
+ * Moves an order to a new status and publishes the transition.
+ *
+ * @param order The order to update.
+ * @param statusP The new status, in the offset form taken by Order::setOrderStatus.
+ */
+void RestaurantSystem::changeStatus(Order& order, int statusP){
+    Status fromStatus = order.getOrderStatus();
+    order.setOrderStatus(statusP);
+    if (order.getOrderStatus() != fromStatus) {
+        updateQueues(order, fromStatus);
+        advanceTask(order);
+    }
+    nameIndex.setStatus(order.getName(), order.getOrderID(), order.getOrderStatus());
+    publishEvent(STATUS_CHANGED, order, fromStatus);
+    replication.status(order.getOrderID(), order.getOrderStatus());
+
+    // Ready orders are done with the kitchen and go to the history
+    if (order.getOrderStatus() == READY_FOR_PICKUP && fromStatus != READY_FOR_PICKUP) {
+        history.append(order, false);
+    }
+}
+
+/**
+ * Drains the console display's subscription and prints status changes and cancels.
+ * With echo off the events are drained without printing.
+ */
+void RestaurantSystem::drainDisplay(){
+    OrderEvent batch[64];
+    int count;
+
+    while ((count = events.poll(displaySubscriber, batch, 64)) > 0) {
+        for (int i = 0; i < count && echo; i++) {
+            if (batch[i].kind == STATUS_CHANGED) {
+                cout << "Order #" << batch[i].orderID << " marked as " << StatusList[batch[i].toStatus] << endl;
+            } else if (batch[i].kind == ORDER_CANCELLED) {
+                cout << "Order #" << batch[i].orderID << " cancelled" << endl;
+            } else if (batch[i].kind == STATUS_BATCH) {
+                cout << batch[i].orderID << " orders marked as " << StatusList[batch[i].toStatus] << endl;
             }
-            Orders[tempIndex].print(false);
-            // set status to cooking
+        }
+    }
+}
 
-            Orders[tempIndex].setOrderStatus(0);
-            currentOrderIndex = tempIndex;
+/**
+ * Counts the events waiting for the metrics subscription by kind.
+ * Drained every tick like the display, so the counts stay whole and its lag on the bus shows
+ * a slow consumer rather than one nobody polled.
+ */
+void RestaurantSystem::drainMetrics(){
+    OrderEvent batch[64];
+    int count;
 
-            return true;
+    while ((count = events.poll(metricsSubscriber, batch, 64)) > 0) {
+        for (int i = 0; i < count; i++) {
+            eventCounts[batch[i].kind] += 1;
         }
     }
-    return false;
-};
+}
+
+/**
+ * Counts the events since the last tick and resumes the order tasks whose orders changed status.
+ * Advances the service level timers to the current time and escalates every order that crossed one.
+ * Orders waiting too long to be cooked are moved ahead of the type priorities,
+ * orders waiting too long to be picked up are flagged as cold on the pickup list.
+ * Ready orders are spilled when the store is over its memory budget.
+ * Finishes by bringing the shared-memory order board up to date and shipping the changes
+ * since the last tick to the followers.
+ */
+void RestaurantSystem::tick(){
+    drainDisplay();
+    drainMetrics();
+    pipeline.run();
+
+    vector<TimerEvent> fired;
+    timers.advance(ShiftClock::now(), fired);
+
+    for (const TimerEvent& event : fired) {
+        int index = findOrderIndex(event.orderID);
+        if (index < 0) {
+            continue;
+        }
+        Order& order = Orders[index];
+        order.setSlaTimer(-1);
+
+        if (event.kind == PLACED_SLA && order.getOrderStatus() == PLACED) {
+            order.escalate();
+            replication.escalate(order.getOrderID());
+            cout << "ALERT: Order #" << order.getOrderID() << " (" << OrderTypeList[order.getOrderType()]
+                 << ") has waited past its service level, moved up the queue" << endl;
+        } else if (event.kind == PICKUP_SLA && order.getOrderStatus() == READY_FOR_PICKUP) {
+            order.markCold();
+            replication.cold(order.getOrderID());
+            boardDirty = true;
+            cout << "ALERT: Order #" << order.getOrderID() << " for " << order.getName()
+                 << " is getting cold on the pickup shelf" << endl;
+        }
+    }
+
+    reportStock();
+    enforceMemoryBudget();
+    refreshBoard();
+    flushReplication();
+}
+
+/**
+ * Prints foods that started running low, sold out or came back since the last report.
+ * Only runs when the inventory's masks changed, which a single load tells.
+ */
+void RestaurantSystem::reportStock(){
+    uint32_t version = inventory.getVersion();
+    if (version == stockVersion) {
+        return;
+    }
+    stockVersion = version;
+
+    uint32_t low = inventory.getLowMask();
+    uint32_t available = inventory.getAvailableMask();
+    const MenuSnapshot& menu = catalog.snapshot();
+
+    for (int i = 0; i < 17; i++) {
+        FOOD food = static_cast<FOOD>(i);
+        uint32_t bit = 1u << i;
+        if ((reportedAvailable & bit) && !(available & bit)) {
+            cout << "STOCK: " << menu.items[food].name << " is sold out" << endl;
+        } else if (!(reportedAvailable & bit) && (available & bit)) {
+            cout << "STOCK: " << menu.items[food].name << " is available again" << endl;
+        } else if (!(reportedLow & bit) && (low & bit)) {
+            cout << "STOCK: " << menu.items[food].name << " is running low, " << inventory.getStock(food) << " left" << endl;
+        }
+    }
+    reportedLow = low;
+    reportedAvailable = available;
+}
+
+/**
+ * Republishes the shared-memory order board if any order changed since the last refresh.
+ * Changes are picked up from the board's own event bus subscription.
+ */
+void RestaurantSystem::refreshBoard(){
+    OrderEvent batch[64];
+    while (events.poll(boardSubscriber, batch, 64) > 0) {
+        boardDirty = true;
+    }
+
+    if (boardDirty) {
+        board.publish(Orders);
+        renderKitchenDisplay();
+        boardDirty = false;
+    }
+}
+
+/**
+ * Redraws the kitchen display with the orders waiting to be cooked or cooking.
+ * Only rows that changed since the previous redraw are sent to the display.
+ */
+void RestaurantSystem::renderKitchenDisplay(){
+    const int maxRows = 40;
+
+    if (!kitchenRenderer.isEnabled()) {
+        return;
+    }
+
+    kitchenRenderer.beginFrame();
+    kitchenRenderer.text("KITCHEN  --ID--|----NAME----|-----TYPE-----|-STATUS-");
+    kitchenRenderer.endRow();
+
+    int rows = 0;
+    int waiting = 0;
+    for (Order& order : Orders) {
+        if (order.getOrderStatus() != PLACED && order.getOrderStatus() != COOKING) {
+            continue;
+        }
+        waiting += 1;
+        if (rows == maxRows) {
+            continue;
+        }
+        kitchenRenderer.text("         ");
+        kitchenRenderer.number(order.getOrderID(), 6, false);
+        kitchenRenderer.text(" | ");
+        kitchenRenderer.padded(order.getName(), 10);
+        kitchenRenderer.text(" | ");
+        kitchenRenderer.padded(OrderTypeList[order.getOrderType()], 12);
+        kitchenRenderer.text(" | ");
+        kitchenRenderer.text(StatusList[order.getOrderStatus()]);
+        kitchenRenderer.endRow();
+        rows += 1;
+    }
+
+    kitchenRenderer.number(waiting);
+    kitchenRenderer.text(" orders in the kitchen queue");
+    kitchenRenderer.endRow();
+    kitchenRenderer.endFrameDiff();
+}
+
+/**
+ * Sends the kitchen display to a terminal or serial device.
+ *
+ * @param path The device or file to draw the kitchen display on.
+ * @return True if the display could be opened.
+ */
+bool RestaurantSystem::setKitchenDisplay(const string& path){
+    int fd = open(path.c_str(), O_WRONLY | O_NOCTTY);
+    if (fd < 0) {
+        cerr << "Kitchen display " << path << " could not be opened" << endl;
+        return false;
+    }
+    kitchenRenderer.setOutput(fd);
+    boardDirty = true;
+    return true;
+}
 
 // Constructor and destructor
-RestaurantSystem::RestaurantSystem() = default;
-RestaurantSystem::~RestaurantSystem(){};
+/**
+ * Constructor for the RestaurantSystem class.
+ * Stores hosted in the same process each need a board of their own.
+ *
+ * @param boardName Shared-memory object the order board is published in.
+ */
+RestaurantSystem::RestaurantSystem(const string& boardName) : board(boardName){
+    displaySubscriber = events.subscribe("display");
+    metricsSubscriber = events.subscribe("metrics");
+    boardSubscriber = events.subscribe("board");
+    // A busy shift fits without regrowing, so little of the arena is left behind by growth
+    Orders.reserve(256);
+}
+RestaurantSystem::~RestaurantSystem(){
+    flushReplication();
+    leader.stop();
+};
 
 /**
  * Prints orders based on their status and type.
  * This function iterates through all orders and prints those matching the specified status and type.
+ * The table is formatted into the list renderer's buffer and written with a single call.
  *
  * @param statusP The status of orders to print.
  * @param typePs A vector of order types to include in the printout.
  */
 void RestaurantSystem::printOrders(int statusP, const vector<int>& typePs) {
-    cout << "\n----NAME-----|--ID--|---TYPE---|-STATUS-" << endl;
+    // Anything still buffered in cout has to come out before the frame
+    cout << flush;
+
+    listRenderer.beginFrame();
+    listRenderer.text("");
+    listRenderer.endRow();
+    listRenderer.text("----NAME-----|--ID--|---TYPE---|-STATUS-");
+    listRenderer.endRow();
+
     for(int i = 0; i < Orders.size(); i++){
         bool typeMatch = false;
         for (int typeP : typePs) {
@@ -102,19 +519,30 @@ void RestaurantSystem::printOrders(int statusP, const vector<int>& typePs) {
         }
 
         if(Orders[i].getOrderStatus() == statusP && typeMatch) {
-            cout << setw(12) << left << Orders[i].getName()
-                 << " | " << setw(4) << Orders[i].getOrderID()
-                 << " | " << setw(6) << OrderTypeList[Orders[i].getOrderType()]
-                 << " | " << setw(8) << StatusList[Orders[i].getOrderStatus()] << endl;
+            listRenderer.padded(Orders[i].getName(), 12);
+            listRenderer.text(" | ");
+            listRenderer.number(Orders[i].getOrderID(), 4);
+            listRenderer.text(" | ");
+            listRenderer.padded(OrderTypeList[Orders[i].getOrderType()], 6);
+            listRenderer.text(" | ");
+            listRenderer.padded(StatusList[Orders[i].getOrderStatus()], 8);
+            if (Orders[i].isCold()) {
+                listRenderer.text(" | COLD");
+            }
+            listRenderer.endRow();
         }
     }
+    listRenderer.endFrame();
 }
 
 /**
  * Prompts the user to place an order and adds it to the system.
  * The function collects order details from the user, including order type and name, and adds a new order to the system.
+ * The wait time is quoted from the running queue aggregates before the order joins the queue.
+ *
+ * @return Quoted wait time in seconds, or -1 if nothing was ordered.
  */
-void RestaurantSystem::placeOrder() {
+int RestaurantSystem::placeOrder() {
     nextID += 1;
     int type = -1;
     string name;
@@ -149,223 +577,1840 @@ void RestaurantSystem::placeOrder() {
         }
     }
 
-    Order newOrder = Order(nextID, name, static_cast<OrderType>(type -1));
+    uint32_t nameID = names.intern(name);
+    Order newOrder = Order(nextID, nameID, names.get(nameID), static_cast<OrderType>(type -1));
+
+    if (newOrder.addMeal(catalog.snapshot(), inventory, meals)){
+        PriceQuote price = pricing.price(newOrder);
+        newOrder.setPricing(price.discountCents, price.feePercent);
+
+        int quote = estimator.quote(newOrder.getOrderType(), newOrder.getPrepTime());
+
+        cout << "\nEstimated wait: " << (quote + 59) / 60 << " minutes" << endl;
+
+        if (newOrder.getOrderType() == PHONE || newOrder.getOrderType() == DOORDASH) {
+            int promisedMinutes = -1;
+            while (promisedMinutes < 0) {
+                cout << "Promised pickup in minutes (0 for no promise): ";
+                cin >> promisedMinutes;
+
+                if (cin.fail()) {
+                    cin.clear();
+                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                    promisedMinutes = -1;
+                }
+            }
+            if (promisedMinutes > 0) {
+                newOrder.setPromisedTime(newOrder.getPlacedTime() + promisedMinutes * 60);
+            }
+        }
 
-    if (newOrder.addMeal()){
-        Orders.push_back(newOrder);
-        newOrder.print(true);
+        enqueueOrder(newOrder);
+        Orders.back().print(true);
+        return quote;
     } else {
         cout << "Nothing was added to the order"
                 "\nCanceling and returning to menu\n" << endl;
+        return -1;
     }
 }
 
 /**
- * Processes the next order in the queue based on a set priority.
- * The function checks the queue in a predefined order (DRIVE_THROUGH, ONSITE, PHONE, DOORDASH) and processes the next available order.
+ * Adds a priced order to the placed queue, the kitchen's demand, the wait aggregates and the deadlines,
+ * and announces it on the event bus.
+ *
+ * @param order The new order, moved into the system.
  */
-void RestaurantSystem::getNextOrderToCook() {
+void RestaurantSystem::enqueueOrder(Order& order){
+    Orders.push_back(std::move(order));
+    Orders.back().setTask(pipeline.start(Orders.back().getOrderID(), Orders.back().getOrderType(), PLACED));
+    nameIndex.insert(Orders.back().getName(), Orders.back().getOrderID(), PLACED);
+    batcher.addOrder(Orders.back());
+    estimator.orderPlaced(Orders.back());
+    deadlines.add(Orders.back());
+    armSlaTimer(Orders.back(), PLACED_SLA);
+    publishEvent(ORDER_PLACED, Orders.back(), PLACED);
+    replication.place(Orders.back());
+}
 
-    if (checkQueueForType(DRIVE_THROUGH)){
-        return;
-    } else if (checkQueueForType(ONSITE)){
-        return;
-    } else if (checkQueueForType(PHONE)){
-        return;
-    } else if (checkQueueForType(DOORDASH)) {
-        return;
-    } else {
-        cout << "No orders found!" << endl;
-        return;
+/**
+ * Places an order without prompting, as when a shard drives the store.
+ * Items are taken from the current menu and the inventory like an order taken at the counter;
+ * items that are off the menu or sold out are left out.
+ *
+ * @param name The customer name.
+ * @param type The order type.
+ * @param items The foods ordered.
+ * @param promisedMinutes Minutes until the promised pickup, 0 for no promise.
+ * @return The ID of the order, or -1 if none of its items could be added.
+ */
+int RestaurantSystem::submitOrder(string_view name, OrderType type, const vector<FOOD>& items, int promisedMinutes) {
+    const MenuSnapshot& menu = catalog.snapshot();
+    uint32_t nameID = names.intern(name);
+    Order newOrder = Order(nextID + 1, nameID, names.get(nameID), type);
+
+    vector<Food> meal;
+    for (FOOD food : items) {
+        if (menu.isListed(food) && inventory.reserve(food)) {
+            meal.push_back(Food(menu.items[food]));
+        }
+    }
+    if (meal.empty()) {
+        return -1;
     }
+    newOrder.setMeal(meals.intern(meal));
+    nextID += 1;
+
+    PriceQuote price = pricing.price(newOrder);
+    newOrder.setPricing(price.discountCents, price.feePercent);
+    if (promisedMinutes > 0) {
+        newOrder.setPromisedTime(newOrder.getPlacedTime() + promisedMinutes * 60);
+    }
+    enqueueOrder(newOrder);
+    return nextID;
 }
 
 /**
- * Prints the details of the current order.
- * The function displays information about the order that is currently being processed.
+ * Dispatches the next order to cook by the same priorities as getNextOrderToCook, without printing it.
+ *
+ * @return The ID of the dispatched order, or -1 if no order is waiting.
  */
-void RestaurantSystem::getOrderDetails() {
-    Orders[currentOrderIndex].print(false);
+int RestaurantSystem::cookNextOrder() {
+    bool echoBefore = echo;
+    echo = false;
+    lastDispatchedID = -1;
+    getNextOrderToCook();
+    echo = echoBefore;
+    return lastDispatchedID;
 }
 
 /**
- * Marks the current order as complete.
- * The function updates the status of the current order to indicate it is completed.
+ * Quotes the wait for a new order from the running queue aggregates, as placeOrder does, without placing it.
+ *
+ * @param type The new order's type.
+ * @param prepTime Expected preparation seconds of the new order.
+ * @return The quoted wait in seconds.
  */
-void RestaurantSystem::markOrderComplete() {
-    Orders[currentOrderIndex].setOrderStatus(1);
+int RestaurantSystem::quoteWait(OrderType type, int prepTime) {
+    return estimator.quote(type, prepTime);
 }
 
 /**
- * Lists all orders that are waiting to be picked up.
- * The function displays orders with a specific status (waiting for pickup).
+ * Marks a cooking order as complete, as markOrderComplete does for the current order.
+ *
+ * @param orderID The order's ID.
+ * @return Whether the order was cooking.
  */
-void RestaurantSystem::listAllOrders() {
-    string trash;
-
-    RestaurantSystem::printOrders(3, {2,3});
-
-    cout << "\nPress enter to continue...";
-    cin.ignore();
-    cin.clear();
-    getline(cin,trash);
+bool RestaurantSystem::completeOrder(int orderID) {
+    int index = findOrderIndex(orderID);
+    if (index < 0 || Orders[index].getOrderStatus() != COOKING) {
+        return false;
+    }
+    changeStatus(Orders[index], 1);
+    return true;
 }
 
 /**
- * Marks an order as ready for pickup based on the order ID provided by the user.
- * The function prompts the user for an order ID, then changes the status of the specified order to indicate it is ready for pickup.
+ * Marks an order ready for pickup, as markOrderForPickup does for the ID it prompts for.
+ *
+ * @param orderID The order's ID.
+ * @return Whether the order was found.
  */
-void RestaurantSystem::markOrderForPickup() {
-    RestaurantSystem::printOrders(2, {2,3});
-
-    int markOrderID = -1;
+bool RestaurantSystem::readyOrder(int orderID) {
+    int index = findOrderIndex(orderID);
+    if (index < 0) {
+        return false;
+    }
+    changeStatus(Orders[index], 2);
+    armSlaTimer(Orders[index], PICKUP_SLA);
+    return true;
+}
 
-    while(markOrderID < 0) {
-        cout << endl << "Input order ID number that you would like to change status: ";
-        cin >> markOrderID;
+/**
+ * Moves many orders to complete or ready for pickup, as after a rush.
+ * The IDs are sorted and looked up in one forward pass over the orders, which are kept in ID order.
+ *
+ * @param orderIDs The orders' IDs, in any order; duplicates count once.
+ * @param status COMPLETE or READY_FOR_PICKUP.
+ * @return The number of orders moved; orders missing or not behind that status are left alone.
+ */
+int RestaurantSystem::transitionOrders(vector<int> orderIDs, Status status) {
+    sort(orderIDs.begin(), orderIDs.end());
+    orderIDs.erase(unique(orderIDs.begin(), orderIDs.end()), orderIDs.end());
 
-        if(markOrderID < 0) {
-            cout << "Please enter a valid order id" << endl;
+    vector<int> indexes;
+    indexes.reserve(orderIDs.size());
+    auto it = Orders.begin();
+    for (int orderID : orderIDs) {
+        it = lower_bound(it, Orders.end(), orderID, [](Order& order, int id) { return order.getOrderID() < id; });
+        if (it == Orders.end()) {
+            break;
+        }
+        if (it->getOrderID() == orderID) {
+            indexes.push_back(static_cast<int>(it - Orders.begin()));
         }
     }
+    return transitionAt(indexes, status);
+}
 
-    bool isFound = false;
-
-    for (auto& order : Orders) {
-        if (order.getOrderID() == markOrderID) {
-            order.setOrderStatus( 2); // Mark the order as complete
-            isFound = true;
-            break; // Break out of the loop once the order is found and updated
-        }
+/**
+ * Moves every order with a status and one of some types to a later status.
+ *
+ * @param from The status of the orders to move.
+ * @param types The types of the orders to move, empty for every type.
+ * @param status COMPLETE or READY_FOR_PICKUP.
+ * @return The number of orders moved.
+ */
+int RestaurantSystem::transitionMatching(Status from, const vector<OrderType>& types, Status status) {
+    unsigned typeMask = types.empty() ? 0xf : 0;
+    for (OrderType type : types) {
+        typeMask |= 1u << type;
     }
 
-    if (!isFound) {
-        cout << "ID # not found" << endl;
+    vector<int> indexes;
+    for (int i = 0; i < Orders.size(); i++) {
+        if (Orders[i].getOrderStatus() == from && (typeMask >> Orders[i].getOrderType() & 1)) {
+            indexes.push_back(i);
+        }
     }
+    return transitionAt(indexes, status);
 }
 
 /**
- * Prompts the user for an order ID and cancels the corresponding order.
- * The function lists all cancellable orders, then allows the user to select one for cancellation based on its ID.
+ * Moves the orders at indexes to a later status as one batch.
+ * Each order gets what a single change gives it: completion updates the estimator and deadlines,
+ * including for cooking orders going straight to pickup, and pickup arms the pickup timer. The
+ * rest happens once for the whole batch: one event on the bus, one operation in the change log and
+ * the ready orders archived with one history write per block.
+ *
+ * @param indexes Indexes of the orders.
+ * @param status COMPLETE or READY_FOR_PICKUP.
+ * @return The number of orders moved; orders not behind the status are left alone.
  */
-void RestaurantSystem::cancelOrder() {
-    int cancelOrderId = -1;
-    string trash;
-
-    if (Orders.empty()) {
-        cout << "There are no orders available to cancel." << endl;
-
-        cout << "\nPress enter to continue...";
-        cin.ignore();
-        cin.clear();
-        getline(cin,trash);
-
-        return;
+int RestaurantSystem::transitionAt(const vector<int>& indexes, Status status) {
+    if (status != COMPLETE && status != READY_FOR_PICKUP) {
+        return 0;
     }
 
-    else{
-        RestaurantSystem::printOrders(0, {1,2,3,4});
-
-    while(cancelOrderId < 0) {
-        cout << endl << "Input order ID number that you would like to cancel: ";
-        cin >> cancelOrderId;
+    time_t now = ShiftClock::now();
+    vector<int> moved;
+    vector<Order*> archived;
+    moved.reserve(indexes.size());
+    for (int index : indexes) {
+        Order& order = Orders[index];
+        Status fromStatus = order.getOrderStatus();
+        if (fromStatus != COOKING && (fromStatus != COMPLETE || status != READY_FOR_PICKUP)) {
+            continue;
+        }
 
-        if(cancelOrderId < 0) {
-            cout << "Please enter a valid order id" << endl;
+        order.setOrderStatus(status - 1);
+        updateQueues(order, fromStatus);
+        advanceTask(order);
+        nameIndex.setStatus(order.getName(), order.getOrderID(), status);
+        if (status == READY_FOR_PICKUP) {
+            armSlaTimer(order, PICKUP_SLA);
+            archived.push_back(&order);
         }
+        moved.push_back(order.getOrderID());
+    }
+    if (moved.empty()) {
+        return 0;
     }
-        vector<Order>::iterator it;
 
-        bool isFound = false;
+    history.append(archived, false);
+    replication.statusBatch(moved, status);
 
-        for (it = Orders.begin(); it != Orders.end() ; it++) {
-            if (it->getOrderID() == cancelOrderId){
-                if(it->getOrderStatus() == PLACED) {
-                    it = Orders.erase(it);
-                    --it;
-                    isFound = true;
-                }
+    OrderEvent event{};
+    event.timestamp = now;
+    event.orderID = static_cast<int32_t>(moved.size());
+    event.kind = STATUS_BATCH;
+    event.toStatus = status;
+    events.publish(event);
+    return static_cast<int>(moved.size());
+}
+
+/**
+ * Drops ready orders from memory. They were archived when they became ready, so the history keeps
+ * them, and they come back on the pickup list at startup while they are recent. Their timers and
+ * name index entries go with them, and the order list is compacted in one pass; the room freed in
+ * the list is taken by the next orders rather than given back to the arena.
+ *
+ * @param indexes Indexes of ready orders, in ascending order.
+ * @return The number of orders spilled.
+ */
+int RestaurantSystem::spillAt(const vector<int>& indexes) {
+    if (indexes.empty()) {
+        return 0;
+    }
+    int currentID = Orders[currentOrderIndex].getOrderID();
+    int saturatedSpilled = 0;
+    vector<int> spilled;
+    spilled.reserve(indexes.size());
+    for (int index : indexes) {
+        clearSlaTimer(Orders[index]);
+        pipeline.close(Orders[index].getTask());
+        spilled.push_back(Orders[index].getOrderID());
+        if (index < saturatedSkips) {
+            saturatedSpilled += 1;
+        }
+    }
+    saturatedSkips -= saturatedSpilled;
+    nameIndex.eraseAll(spilled);
+
+    size_t kept = 0;
+    size_t next = 0;
+    for (size_t i = 0; i < Orders.size(); i++) {
+        if (next < indexes.size() && indexes[next] == (int)i) {
+            next++;
+        } else {
+            if (kept != i) {
+                Orders[kept] = std::move(Orders[i]);
+            }
+            kept++;
+        }
+    }
+    Orders.erase(Orders.begin() + kept, Orders.end());
+    currentOrderIndex = max(0, findOrderIndex(currentID));
+
+    replication.spill(spilled);
+    spilledOrders += spilled.size();
+    boardDirty = true;
+    return static_cast<int>(spilled.size());
+}
+
+/**
+ * Spills the oldest ready orders when the footprint is over the memory budget, down to three
+ * quarters of it so the room freed is reused for a while before the next spill. Without a history
+ * the orders have nowhere to go, and being over budget is reported once.
+ * Spilling frees orders and what is kept for them only: names and meals stay interned for the rest
+ * of the shift, and the order list and the arena keep the room they took, so a budget smaller than
+ * those can stay exceeded with nothing left to spill.
+ */
+void RestaurantSystem::enforceMemoryBudget() {
+    if (memoryBudget == 0) {
+        return;
+    }
+    MemoryFootprint footprint = memoryFootprint();
+    if (footprint.total <= memoryBudget) {
+        budgetWarned = false;
+        return;
+    }
+
+    vector<int> indexes;
+    if (history.isOpen()) {
+        size_t perOrder = sizeof(Order) + sizeof(NameEntry);
+        size_t wanted = (footprint.total - memoryBudget * 3 / 4 + perOrder - 1) / perOrder;
+        for (int i = 0; i < Orders.size() && indexes.size() < wanted; i++) {
+            if (Orders[i].getOrderStatus() == READY_FOR_PICKUP && i != currentOrderIndex) {
+                indexes.push_back(i);
+            }
+        }
+    }
+    if (indexes.empty()) {
+        if (!budgetWarned) {
+            cout << "WARNING: " << footprint.total / 1024 << " KB in use, over the memory budget of "
+                 << memoryBudget / 1024 << " KB" << (history.isOpen() ? ", with no ready orders left to spill"
+                                                                     : "; start with -H <directory> to spill ready orders")
+                 << endl;
+            budgetWarned = true;
+        }
+        return;
+    }
+
+    int spilled = spillAt(indexes);
+    if (echo) {
+        cout << spilled << " ready orders spilled to the history to stay under the memory budget" << endl;
+    }
+}
+
+/**
+ * Summarizes the orders and queues of the store for reports across stores.
+ *
+ * @return The store's report.
+ */
+StoreReport RestaurantSystem::report() {
+    StoreReport result;
+    for (Order& order : Orders) {
+        result.orders += 1;
+        result.byStatus[order.getOrderStatus()] += 1;
+        result.byType[order.getOrderType()] += 1;
+        result.chargedCents += order.getTotalCents();
+    }
+    for (int type = 0; type < 4; type++) {
+        result.waitSeconds[type] = estimator.quote(static_cast<OrderType>(type), 0);
+    }
+    return result;
+}
+
+/**
+ * Adds up the memory held by the orders and everything kept for them.
+ * Orders count by how many there are; the order list's spare room is shown apart, since it is taken
+ * by the next orders and spilling cannot give it back. The arena's heap chunks are also left out of
+ * the total: they back the orders, the list and the meals already counted, and are only freed when
+ * the shift ends. Names and meals are counted, but stay until the shift ends as well.
+ *
+ * @return The store's footprint.
+ */
+MemoryFootprint RestaurantSystem::memoryFootprint() {
+    MemoryFootprint footprint;
+    footprint.orderBytes = Orders.size() * sizeof(Order);
+    footprint.orderSlackBytes = (Orders.capacity() - Orders.size()) * sizeof(Order);
+    footprint.mealBytes = meals.bytesUsed();
+    footprint.nameBytes = names.bytesUsed();
+    footprint.indexBytes = nameIndex.bytesUsed() + timers.bytesUsed() + deadlines.bytesUsed()
+                           + estimator.bytesUsed() + batcher.bytesUsed() + pipeline.bytesUsed();
+    footprint.archiveBytes = history.bytesUsed();
+    footprint.replicationBytes = replication.bytesUsed() + leader.bytesUsed();
+    footprint.total = footprint.orderBytes + footprint.mealBytes + footprint.nameBytes + footprint.indexBytes
+                      + footprint.archiveBytes + footprint.replicationBytes;
+
+    ArenaStats arena = shift.getStats();
+    footprint.arenaReserved = arena.bytesReserved;
+    footprint.arenaInUse = arena.bytesInUse;
+    return footprint;
+}
+
+/**
+ * Sets the footprint the store is held under. Every tick over it spills the oldest ready orders,
+ * which needs a history to spill them to.
+ *
+ * @param bytes The budget in bytes, 0 for no budget.
+ */
+void RestaurantSystem::setMemoryBudget(size_t bytes) {
+    memoryBudget = bytes;
+    budgetWarned = false;
+}
+
+/**
+ * Prints the footprint by what holds it, the shift arena behind the orders and meals, and the
+ * memory budget with the ready orders spilled to stay under it.
+ */
+void RestaurantSystem::memoryReport() {
+    MemoryFootprint footprint = memoryFootprint();
+    const pair<const char*, size_t> rows[8] = {
+            {"Orders", footprint.orderBytes},
+            {"Meals", footprint.mealBytes},
+            {"Names", footprint.nameBytes},
+            {"Indexes", footprint.indexBytes},
+            {"History buffers", footprint.archiveBytes},
+            {"Replication", footprint.replicationBytes},
+            {"Total", footprint.total},
+            {"Order list room", footprint.orderSlackBytes},
+    };
+
+    cout << "\n-----MEMORY------|------KB-|-SHARE-" << endl;
+    cout << fixed << setprecision(1);
+    for (const auto& [label, bytes] : rows) {
+        cout << setw(16) << left << label << " | " << setw(8) << right << bytes / 1024.0 << " | "
+             << setw(4) << 100.0 * bytes / max<size_t>(1, footprint.total) << "%" << left << endl;
+    }
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+    cout << Orders.size() << " orders, " << meals.size() << " distinct meals, " << names.size() << " names" << endl;
+    cout << "Shift arena: " << footprint.arenaReserved / 1024 << " KB taken from the heap, "
+         << footprint.arenaInUse / 1024 << " KB in use" << endl;
+    cout << "Not in the total: the order list room and the arena's chunks, kept until the shift ends" << endl;
+    cout << "Names and meals stay for the shift too; spilling frees only orders and their indexes" << endl;
+
+    if (memoryBudget == 0) {
+        cout << "No memory budget, start with -M <megabytes> to set one" << endl;
+    } else {
+        cout << "Memory budget: " << memoryBudget / 1024 << " KB, " << footprint.total * 100 / memoryBudget
+             << "% used, " << spilledOrders << " ready orders spilled to the history" << endl;
+    }
+}
+
+/**
+ * Chooses whether dispatched orders and status changes are printed.
+ * Stores driven by a shard run with echo off so their threads do not flood the console.
+ *
+ * @param enabled True to print.
+ */
+void RestaurantSystem::setEcho(bool enabled) {
+    echo = enabled;
+}
+
+/**
+ * Processes the next order in the queue based on a set priority.
+ * The function checks the queue in a predefined order (DRIVE_THROUGH, ONSITE, PHONE, DOORDASH) and processes the next available order.
+ * In deadline mode a promised order that is about to miss its time goes first, but never more than
+ * a few times in a row, so drive through and onsite orders keep moving.
+ * Signalled order tasks are resumed first, so an order moved back to placed is in its cook queue again.
+ */
+void RestaurantSystem::getNextOrderToCook() {
+    const int deadlineSlackSeconds = 5 * 60;
+    const int maxConsecutiveDeadlineDispatches = 2;
+
+    pipeline.run();
+
+    if (deadlineMode && consecutiveDeadlineDispatches < maxConsecutiveDeadlineDispatches) {
+        int dueID = deadlines.nextDue(ShiftClock::now(), deadlineSlackSeconds);
+        int dueIndex = findOrderIndex(dueID);
+        // only a placed order can be sent to the kitchen; anything else left the queue without its deadline
+        while (dueID >= 0 && (dueIndex < 0 || Orders[dueIndex].getOrderStatus() != PLACED)) {
+            deadlines.remove(dueID);
+            dueID = deadlines.nextDue(ShiftClock::now(), deadlineSlackSeconds);
+            dueIndex = findOrderIndex(dueID);
+        }
+        if (dueIndex >= 0) {
+            consecutiveDeadlineDispatches += 1;
+            dispatchOrder(dueIndex);
+            return;
+        }
+    }
+    consecutiveDeadlineDispatches = 0;
+
+    if (checkQueueForType(DRIVE_THROUGH)){
+        return;
+    } else if (checkQueueForType(ONSITE)){
+        return;
+    } else if (checkQueueForType(PHONE)){
+        return;
+    } else if (checkQueueForType(DOORDASH)) {
+        return;
+    } else {
+        if (echo) {
+            cout << "No orders found!" << endl;
+        }
+        return;
+    }
+}
+
+/**
+ * Prints the details of the current order.
+ * The function displays information about the order that is currently being processed.
+ */
+void RestaurantSystem::getOrderDetails() {
+    Orders[currentOrderIndex].print(false);
+}
+
+/**
+ * Marks the current order as complete.
+ * The function updates the status of the current order to indicate it is completed.
+ */
+void RestaurantSystem::markOrderComplete() {
+    changeStatus(Orders[currentOrderIndex], 1);
+}
+
+/**
+ * Lists all orders that are waiting to be picked up.
+ * The function displays orders with a specific status (waiting for pickup).
+ */
+void RestaurantSystem::listAllOrders() {
+    string trash;
+
+    RestaurantSystem::printOrders(3, {2,3});
+
+    cout << "\nPress enter to continue...";
+    cin.ignore();
+    cin.clear();
+    getline(cin,trash);
+}
+
+/**
+ * Marks an order as ready for pickup based on the order ID provided by the user.
+ * The function prompts the user for an order ID, then changes the status of the specified order to indicate it is ready for pickup.
+ */
+void RestaurantSystem::markOrderForPickup() {
+    RestaurantSystem::printOrders(2, {2,3});
+
+    int markOrderID = -1;
+
+    while(markOrderID < 0) {
+        cout << endl << "Input order ID number that you would like to change status: ";
+        cin >> markOrderID;
+
+        if(markOrderID < 0) {
+            cout << "Please enter a valid order id" << endl;
+        }
+    }
+
+    int index = findOrderIndex(markOrderID);
+
+    if (index >= 0) {
+        changeStatus(Orders[index], 2); // Mark the order as ready for pickup
+        armSlaTimer(Orders[index], PICKUP_SLA);
+    } else {
+        cout << "ID # not found" << endl;
+    }
+}
+
+/**
+ * Moves many orders to complete or ready for pickup at once, for the end of a rush.
+ * The orders are given as IDs and ranges of IDs on one line, such as "12 15 20-40", or as every
+ * order with a status and optionally of one type. The change is printed once for the whole batch.
+ */
+void RestaurantSystem::bulkStatusChange() {
+    int target = -1;
+    while (target < 0 || target > 2) {
+        cout << "\nMark orders as:\n"
+                " 1. Complete\n"
+                " 2. Ready for pickup\n"
+                " 0. Back" << endl;
+        cin >> target;
+
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            target = -1;
+        }
+    }
+    if (target == 0) {
+        return;
+    }
+    Status status = (target == 1) ? COMPLETE : READY_FOR_PICKUP;
+
+    int mode = -1;
+    while (mode < 1 || mode > 2) {
+        cout << "\nWhich orders:\n"
+                " 1. By order ID\n"
+                " 2. Every order with a status" << endl;
+        cin >> mode;
+
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            mode = -1;
+        }
+    }
+
+    int requested = 0;
+    int moved = 0;
+    if (mode == 1) {
+        string line;
+        cout << "Order IDs and ranges, such as 12 15 20-40: ";
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        getline(cin, line);
+
+        vector<int> orderIDs;
+        istringstream words(line);
+        string word;
+        while (words >> word) {
+            int first = -1, last = -1;
+            size_t dash = word.find('-', 1);
+            const char* end = word.data() + word.size();
+            if (dash == string::npos) {
+                if (from_chars(word.data(), end, first).ec == errc()) {
+                    orderIDs.push_back(first);
+                }
+            } else if (from_chars(word.data(), word.data() + dash, first).ec == errc()) {
+                from_chars(word.data() + dash + 1, end, last);
+                // Every ID ever given is below the next one
+                for (int id = max(first, 0); id <= min(last, nextID - 1); id++) {
+                    orderIDs.push_back(id);
+                }
+            }
+        }
+        requested = static_cast<int>(orderIDs.size());
+        moved = transitionOrders(orderIDs, status);
+    } else {
+        int from = -1;
+        while (from < 1 || from > 2) {
+            cout << "From status:\n"
+                    " 1. Cooking\n"
+                    " 2. Complete" << endl;
+            cin >> from;
+
+            if (cin.fail()) {
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                from = -1;
             }
         }
-        if(!isFound || it->getOrderStatus() != 0) {
-            cout << "ID # not found" << endl;
+        int type = -1;
+        while (type < 0 || type > 4) {
+            cout << "Order type (0 for every type):\n"
+                    " 1. Drive Through\n"
+                    " 2. Onsite\n"
+                    " 3. Phone\n"
+                    " 4. Doordash" << endl;
+            cin >> type;
+
+            if (cin.fail()) {
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                type = -1;
+            }
+        }
+        vector<OrderType> types;
+        if (type > 0) {
+            types.push_back(static_cast<OrderType>(type - 1));
+        }
+        Status fromStatus = (from == 1) ? COOKING : COMPLETE;
+        for (Order& order : Orders) {
+            requested += order.getOrderStatus() == fromStatus && (types.empty() || order.getOrderType() == types[0]);
+        }
+        moved = transitionMatching(fromStatus, types, status);
+    }
+
+    if (moved < requested) {
+        cout << (requested - moved) << " orders were not found or not ready to be marked as "
+             << StatusList[status] << endl;
+    } else if (moved == 0) {
+        cout << "No orders to mark" << endl;
+    }
+}
+
+/**
+ * Prompts the user for an order ID and cancels the corresponding order.
+ * The function lists all cancellable orders, then allows the user to select one for cancellation based on its ID.
+ */
+void RestaurantSystem::cancelOrder() {
+    int cancelOrderId = -1;
+    string trash;
+
+    if (Orders.empty()) {
+        cout << "There are no orders available to cancel." << endl;
+
+        cout << "\nPress enter to continue...";
+        cin.ignore();
+        cin.clear();
+        getline(cin,trash);
+
+        return;
+    }
+
+    else{
+        RestaurantSystem::printOrders(0, {1,2,3,4});
+
+    while(cancelOrderId < 0) {
+        cout << endl << "Input order ID number that you would like to cancel: ";
+        cin >> cancelOrderId;
+
+        if(cancelOrderId < 0) {
+            cout << "Please enter a valid order id" << endl;
+        }
+    }
+        int index = findOrderIndex(cancelOrderId);
+
+        if (index >= 0 && Orders[index].getOrderStatus() == PLACED) {
+            cancelAt(index);
+        } else {
+            cout << "ID # not found" << endl;
+        }
+    }
+}
+
+/**
+ * Cancels a placed order: its items go back to the inventory, it leaves the queue aggregates and
+ * its timer, and it is archived as cancelled and taken out of the system.
+ *
+ * @param index Index of the placed order.
+ */
+void RestaurantSystem::cancelAt(int index){
+    Order& order = Orders[index];
+    batcher.removeOrder(order);
+    for (const Food& item : order.getMeal()) {
+        inventory.release(item.getFood());
+    }
+    estimator.orderCancelled(order);
+    deadlines.remove(order.getOrderID());
+    clearSlaTimer(order);
+    pipeline.close(order.getTask());
+    publishEvent(ORDER_CANCELLED, order, PLACED);
+    history.append(order, true);
+    nameIndex.erase(order.getName(), order.getOrderID());
+    replication.cancel(order.getOrderID());
+    Orders.erase(Orders.begin() + index);
+    if (index < saturatedSkips) {
+        saturatedSkips -= 1;
+    }
+}
+
+/**
+ * Prompts the user for a placed order and lets them add and remove its items.
+ * The order's cached totals, the batcher's demand, the queued work of the wait estimator
+ * and the order's deadline are all updated as the meal changes.
+ */
+void RestaurantSystem::editOrder() {
+    RestaurantSystem::printOrders(0, {1,2,3,4});
+
+    int editOrderID = -1;
+    while (editOrderID < 0) {
+        cout << endl << "Input order ID number that you would like to edit: ";
+        cin >> editOrderID;
+
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            editOrderID = -1;
+        }
+    }
+
+    int index = findOrderIndex(editOrderID);
+    if (index < 0 || Orders[index].getOrderStatus() != PLACED) {
+        cout << "ID # not found or already cooking" << endl;
+        return;
+    }
+
+    Order& order = Orders[index];
+    int prepTimeBefore = order.getPrepTime();
+    int choice = -1;
+
+    while (choice != 0) {
+        const pmr::vector<Food>& meal = order.getMeal();
+
+        cout << "\nOrder #" << order.getOrderID() << " for " << order.getName() << endl;
+        for (int i = 0; i < meal.size(); i++) {
+            cout << setw(3) << right << (i + 1) << ". " << left << meal[i].getName() << endl;
+        }
+        cout << "Total: $" << order.getTotalCents() / 100 << "."
+             << setw(2) << setfill('0') << right << order.getTotalCents() % 100 << setfill(' ') << left << endl;
+        cout << " 1. Add items\n"
+                " 2. Remove an item\n"
+                " 0. Done" << endl;
+        cin >> choice;
+
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            choice = -1;
+        }
+
+        if (choice == 1) {
+            // Items keep a canonical order, so the new ones are told apart by their counts
+            const Meal* before = order.getSharedMeal();
+            order.addMeal(catalog.snapshot(), inventory, meals);
+            for (int food = 0; food < 17; food++) {
+                for (int k = before->counts[food]; k < order.getSharedMeal()->counts[food]; k++) {
+                    batcher.addItem(order, static_cast<FOOD>(food));
+                }
+            }
+        } else if (choice == 2) {
+            int position = 0;
+            cout << "Item number to remove: ";
+            cin >> position;
+
+            if (cin.fail() || position < 1 || position > (int)meal.size()) {
+                cin.clear();
+                cin.ignore(numeric_limits<streamsize>::max(), '\n');
+                cout << "Invalid item number" << endl;
+            } else if (meal.size() == 1) {
+                cout << "An order needs at least one item, cancel it instead" << endl;
+            } else {
+                FOOD food = meal[position - 1].getFood();
+                if (order.removeItem(position - 1, meals)) {
+                    batcher.removeItem(order, food);
+                    inventory.release(food);
+                }
+            }
+        }
+    }
+
+    PriceQuote price = pricing.price(order);
+    order.setPricing(price.discountCents, price.feePercent);
+
+    if (order.getPrepTime() != prepTimeBefore) {
+        estimator.orderEdited(order, prepTimeBefore);
+        deadlines.reschedule(order);
+    }
+    replication.place(order);
+}
+
+/**
+ * Shows batches of identical items across placed orders.
+ * Batches group tickets placed within a ten minute window; the user may mark one as cooked,
+ * which fans its items out to the orders it was made for.
+ */
+void RestaurantSystem::showCookingBatches() {
+    const int windowSeconds = 10 * 60;
+    const int minBatchSize = 2;
+
+    vector<CookBatch> batches = batcher.proposeBatches(windowSeconds, minBatchSize);
+
+    if (batches.empty()) {
+        cout << "No items to batch right now." << endl;
+        return;
+    }
+
+    const MenuSnapshot& menu = catalog.snapshot();
+    cout << "\n--#--|------ITEM------|-QTY-|-ORDERS-" << endl;
+    for (int i = 0; i < batches.size(); i++) {
+        cout << setw(4) << right << (i + 1) << " | " << setw(14) << left << menu.items[batches[i].food].name
+             << " | " << setw(3) << right << batches[i].quantity << " |";
+        for (const BatchTicket& ticket : batches[i].tickets) {
+            cout << " #" << ticket.orderID;
+        }
+        cout << left << endl;
+    }
+
+    int choice = -1;
+    while (choice < 0 || choice > (int)batches.size()) {
+        cout << endl << "Input batch number that finished cooking (0 to return): ";
+        cin >> choice;
+
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            choice = -1;
+        }
+    }
+
+    if (choice > 0) {
+        batcher.finishBatch(batches[choice - 1], menu.items[batches[choice - 1].food].name);
+    }
+}
+
+/**
+ * Prints the promised time report and lets the user switch deadline scheduling on or off.
+ */
+void RestaurantSystem::deadlineReport() {
+    deadlines.printReport();
+
+    cout << "Deadline scheduling is " << (deadlineMode ? "ON" : "OFF") << endl;
+
+    int choice = -1;
+    while (choice < 0 || choice > 1) {
+        cout << endl << "Enter 1 to switch it " << (deadlineMode ? "off" : "on") << " (0 to return): ";
+        cin >> choice;
+
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            choice = -1;
+        }
+    }
+
+    if (choice == 1) {
+        deadlineMode = !deadlineMode;
+        consecutiveDeadlineDispatches = 0;
+    }
+}
+
+/**
+ * Prints event counts from the metrics subscription and the backpressure of every subscriber.
+ * The metrics subscription is drained every tick and once more here, so the counts are up to date.
+ * Ends with the order tasks in flight and the mean time orders spent in each status.
+ */
+void RestaurantSystem::eventBusStatus() {
+    events.printBackpressure();
+    drainMetrics();
+
+    cout << "\n-----EVENT------|-COUNT-" << endl;
+    for (int k = ORDER_PLACED; k <= STATUS_BATCH; k++) {
+        cout << setw(15) << left << EventKindList[k] << " | " << eventCounts[k] << endl;
+    }
+    cout << "Events lost by metrics: " << events.getDropped(metricsSubscriber) << endl;
+
+    pipeline.run();
+    pipeline.printStatus();
+}
+
+/**
+ * Prints bytes written and time spent per frame for the order lists, which are redrawn in full,
+ * and for the kitchen display, which only redraws changed rows.
+ */
+void RestaurantSystem::displayStatistics() {
+    RenderStats list = listRenderer.getFullStats();
+    RenderStats kitchen = kitchenRenderer.getDiffStats();
+
+    cout << "\n-----DISPLAY-----|-FRAMES-|-BYTES/FRAME-|-FULL REDRAW-|-USEC/FRAME-" << endl;
+    cout << fixed << setprecision(1);
+    for (int i = 0; i < 2; i++) {
+        RenderStats& stats = (i == 0) ? list : kitchen;
+        double frames = max<double>(1.0, stats.frames);
+        cout << setw(16) << left << (i == 0 ? "Order lists" : "Kitchen display") << " | "
+             << setw(6) << right << stats.frames << " | "
+             << setw(11) << stats.bytes / frames << " | "
+             << setw(11) << stats.fullRedrawBytes / frames << " | "
+             << setw(10) << stats.nanoseconds / frames / 1000.0 << left << endl;
+    }
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+    cout << "Only the kitchen display (-k) redraws changed rows; tools/RenderBench.cpp compares both"
+            " with the iostream output the order lists had before" << endl;
+}
+
+/**
+ * Prompts for the start of a customer name and lists every order under a matching name.
+ * Matching ignores case; orders ready for pickup are listed first.
+ */
+void RestaurantSystem::findOrdersByName() {
+    const size_t maxMatches = 20;
+    string prefix;
+
+    cout << "\nCustomer name or its first letters: ";
+    cin >> prefix;
+
+    vector<NameEntry> matches;
+    auto start = chrono::steady_clock::now();
+    nameIndex.findPrefix(prefix, matches, maxMatches);
+    auto found = chrono::steady_clock::now();
+
+    stable_partition(matches.begin(), matches.end(), [](const NameEntry& entry) {
+        return entry.status == READY_FOR_PICKUP;
+    });
+
+    if (matches.empty()) {
+        cout << "No orders for '" << prefix << "'" << endl;
+        return;
+    }
+
+    cout << "\n----NAME-----|--ID--|-----STATUS-----" << endl;
+    for (const NameEntry& entry : matches) {
+        cout << setw(12) << left << entry.name << " | " << setw(4) << right << entry.orderID
+             << " | " << left << StatusList[entry.status] << endl;
+    }
+    cout << matches.size() << (matches.size() == maxMatches ? "+" : "") << " of " << nameIndex.size()
+         << " orders matched in "
+         << chrono::duration_cast<chrono::nanoseconds>(found - start).count() / 1000.0 << " us" << endl;
+}
+
+/**
+ * Loads the promotion, combo and fee rules new orders are priced with.
+ *
+ * @param path The rules file.
+ * @return Whether the file was loaded.
+ */
+bool RestaurantSystem::loadPricingRules(const string& path) {
+    int loaded = pricing.load(path);
+    if (loaded >= 0) {
+        cout << loaded << " pricing rules loaded from " << path << endl;
+    }
+    return loaded >= 0;
+}
+
+/**
+ * Loads a menu file and swaps it in for new orders.
+ * Orders already placed keep the items and prices they were ordered with.
+ *
+ * @param path The menu file.
+ * @return Whether the menu was replaced.
+ */
+bool RestaurantSystem::loadMenu(const string& path) {
+    int loaded = catalog.load(path);
+    menuPath = path;
+    if (loaded >= 0) {
+        cout << "Menu version " << catalog.snapshot().version << ": " << loaded << " items loaded from " << path << endl;
+    }
+    return loaded >= 0;
+}
+
+/**
+ * Reloads the menu file, for example after its prices were edited during service.
+ * Prompts for a file if none was loaded yet.
+ */
+void RestaurantSystem::reloadMenu() {
+    string path = menuPath;
+    if (path.empty()) {
+        cout << "\nInput menu file: ";
+        if (!(cin >> path)) {
+            return;
+        }
+    }
+    loadMenu(path);
+}
+
+/**
+ * Reprices every order under the current rules for the end of day reconciliation.
+ * Orders charged differently from what the rules give now are counted, for example orders
+ * placed before the rules were changed.
+ */
+void RestaurantSystem::reconcilePrices() {
+    int threads = max(1u, thread::hardware_concurrency());
+    Reconciliation result = pricing.reconcile(Orders, threads);
+
+    auto dollars = [](long cents) {
+        char text[32];
+        snprintf(text, sizeof(text), "%s$%ld.%02ld", cents < 0 ? "-" : "", labs(cents) / 100, labs(cents) % 100);
+        return string(text);
+    };
+
+    cout << "\nOrders repriced:   " << result.orders << endl;
+    cout << "Charged:           " << dollars(result.chargedCents) << endl;
+    cout << "Under the rules:   " << dollars(result.expectedCents) << endl;
+    cout << "Difference:        " << dollars(result.chargedCents - result.expectedCents) << endl;
+    cout << "Orders that differ: " << result.mismatched << endl;
+    cout << "Repriced in " << result.nanoseconds / 1000 << " us" << endl;
+}
+
+/**
+ * Shows the portions left of every food and lets the user set one.
+ * The food is chosen by its number, or by its code or name looked up in the menu.
+ * Setting a food to 0 takes it off the menu at once; -1 stops counting it.
+ */
+void RestaurantSystem::manageInventory() {
+    const MenuSnapshot& menu = catalog.snapshot();
+    cout << "\n--#--|--------ITEM--------|-LEFT-" << endl;
+    for (int i = 0; i < 17; i++) {
+        FOOD food = static_cast<FOOD>(i);
+        int portions = inventory.getStock(food);
+        cout << setw(4) << right << (i + 1) << " | " << setw(20) << left << menu.items[food].name << " | ";
+        if (portions < 0) {
+            cout << "-";
+        } else {
+            cout << portions << (portions == 0 ? " sold out" : inventory.isLow(food) ? " low" : "");
+        }
+        cout << endl;
+    }
+
+    int choice = -1;
+    while (choice < 0 || choice > 17) {
+        string word;
+        cout << endl << "Input item number or code to restock (0 to return): ";
+        if (!(cin >> word)) {
+            return;
+        }
+
+        const MenuItem* item = menu.find(word);
+        if (item != nullptr) {
+            choice = item->code + 1;
+        } else if (from_chars(word.data(), word.data() + word.size(), choice).ec != errc()) {
+            choice = -1;
+        }
+    }
+    if (choice == 0) {
+        return;
+    }
+
+    int count = -2;
+    while (count < -1) {
+        cout << "Portions left (0 to sell out, -1 for unlimited): ";
+        cin >> count;
+
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            count = -2;
+        }
+    }
+
+    const int lowFraction = 5;
+    int lowAt = max(1, count / lowFraction);
+    inventory.setStock(static_cast<FOOD>(choice - 1), count, lowAt);
+    replication.stock(static_cast<FOOD>(choice - 1), count, lowAt);
+    reportStock();
+}
+
+/**
+ * Reprints the kitchen copies of every order with a chosen status.
+ * Receipts are rendered back to back into one buffer and written whenever it fills.
+ */
+void RestaurantSystem::reprintReceipts() {
+    int statusP = -1;
+    while (statusP < 0 || statusP > 4) {
+        cout << "\nReprint receipts for status:\n"
+                " 1. Placed\n"
+                " 2. Cooking\n"
+                " 3. Complete\n"
+                " 4. Ready for pickup\n"
+                " 0. All orders" << endl;
+        cin >> statusP;
+
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            statusP = -1;
         }
     }
+
+    vector<int> indexes;
+    for (int i = 0; i < Orders.size(); i++) {
+        if (statusP == 0 || Orders[i].getOrderStatus() == statusP - 1) {
+            indexes.push_back(i);
+        }
+    }
+
+    // One per thread, since stores hosted together run on threads of their own
+    static thread_local char buffer[64 * 1024];
+    cout << flush;
+    int printed = receipts.formatBatch(Orders, indexes, KITCHEN_COPY, buffer, sizeof(buffer), 1);
+    cout << "\n" << printed << " receipts reprinted" << endl;
 }
 
+/**
+ * Opens the history directory finished and cancelled orders are archived in.
+ *
+ * @param path The history directory.
+ * @return Whether the directory opened.
+ */
+bool RestaurantSystem::openHistory(const string& path) {
+    return history.open(path);
+}
 
 /**
- * Reads a file for orders
+ * Lists the archived orders of a type placed between two hours of a day.
+ * Only the history segments of those hours are read, so older history does not slow the report down.
  */
-void RestaurantSystem::fileRead(ifstream& inputStreamPP){
-    int currentOrderIndexFile;
-    int nextIDFile;
-    int orderIDFile;
-    string nameFile;
-    int typeFile;
-    OrderType typeFileCast;
-    int mealSize;
-    int mealFile;
-    vector <Food> mealFileCast;
-    int skipCountFile;
-    int statusFile;
-    Status statusFileCast;
+void RestaurantSystem::historyReport() {
+    if (!history.isOpen()) {
+        cout << "\nNo order history, start with -H <directory> to archive orders." << endl;
+        return;
+    }
 
+    time_t now = ShiftClock::now();
+    tm day;
+    localtime_r(&now, &day);
 
-    if (!inputStreamPP.eof()){
-        inputStreamPP >> currentOrderIndexFile;
-        currentOrderIndex = currentOrderIndexFile;
+    string dayText;
+    cout << "\nDay (YYYY-MM-DD, 0 for today): ";
+    cin >> dayText;
+    if (dayText != "0") {
+        if (sscanf(dayText.c_str(), "%d-%d-%d", &day.tm_year, &day.tm_mon, &day.tm_mday) != 3) {
+            cout << "Invalid day" << endl;
+            return;
+        }
+        day.tm_year -= 1900;
+        day.tm_mon -= 1;
     }
-    if (!inputStreamPP.eof()){
-        inputStreamPP >> nextIDFile;
-        nextID = nextIDFile;
+
+    int fromHour = -1;
+    while (fromHour < 0 || fromHour > 23) {
+        cout << "From hour (0-23): ";
+        cin >> fromHour;
+
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            fromHour = -1;
+        }
     }
 
-    while(inputStreamPP >> orderIDFile >> nameFile >> typeFile >> mealSize){
+    int toHour = -1;
+    while (toHour <= fromHour || toHour > 24) {
+        cout << "To hour (" << fromHour + 1 << "-24): ";
+        cin >> toHour;
 
-        typeFileCast = static_cast<OrderType>(typeFile);
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            toHour = -1;
+        }
+    }
 
-        for (int k = 0; k < (mealSize - 1); k++) {
-            if (inputStreamPP >> mealFile) {
-                mealFileCast.push_back(static_cast<FOOD>(mealFile));
-            } else {
-                std::cerr << "Error reading meal" << endl;
-                break;
+    int type = -1;
+    while (type < 0 || type > 4) {
+        cout << "Order type (1. Drive Through, 2. Onsite, 3. Phone, 4. Doordash, 0. All): ";
+        cin >> type;
+
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            type = -1;
+        }
+    }
+
+    // Local hours of the day, mktime works out daylight saving and an end hour of 24
+    day.tm_min = 0;
+    day.tm_sec = 0;
+    day.tm_isdst = -1;
+    tm end = day;
+    day.tm_hour = fromHour;
+    end.tm_hour = toHour;
+    time_t from = mktime(&day);
+    time_t to = mktime(&end);
+
+    const int maxRows = 50;
+    long shown = 0;
+    long orders = 0;
+    long cancelled = 0;
+    long chargedCents = 0;
+
+    cout << "\n--ID--|-PLACED-|-----TYPE------|------NAME------|--TOTAL--" << endl;
+    HistoryScan scan = history.query(from, to, [&](const HistoryEntry& entry) {
+        if (type != 0 && entry.type != type - 1) {
+            return;
+        }
+        if (entry.cancelled) {
+            cancelled += 1;
+        } else {
+            orders += 1;
+            chargedCents += entry.getTotalCents();
+        }
+        if (shown++ < maxRows) {
+            tm placed;
+            localtime_r(&entry.placedTime, &placed);
+            char row[128];
+            snprintf(row, sizeof(row), "%5d | %02d:%02d  | %-13s | %-14.*s | $%4ld.%02ld%s", entry.orderID,
+                     placed.tm_hour, placed.tm_min, OrderTypeList[entry.type].c_str(), (int)min<size_t>(entry.name.size(), 14),
+                     entry.name.data(), entry.getTotalCents() / 100, entry.getTotalCents() % 100,
+                     entry.cancelled ? " cancelled" : "");
+            cout << row << "\n";
+        }
+    });
+    if (shown > maxRows) {
+        cout << "... " << shown - maxRows << " more" << "\n";
+    }
+
+    cout << "\nOrders: " << orders << ", cancelled: " << cancelled << ", charged: $" << chargedCents / 100 << "."
+         << setw(2) << setfill('0') << right << chargedCents % 100 << setfill(' ') << left << endl;
+    cout << "Read " << scan.segments << " segments (" << scan.bytesMapped / 1024 << " KB mapped), "
+         << scan.blocksRead << " blocks scanned, " << scan.blocksSkipped << " skipped by the index, "
+         << scan.records << " records decoded in " << scan.nanoseconds / 1000 << " us" << endl;
+}
+
+/**
+ * Puts orders still waiting to be picked up back on the pickup list from the history.
+ * Only the current hour's segment and the one before it are read, so startup does not depend on
+ * how much history there is. Restored orders are merged into the list by ID.
+ */
+void RestaurantSystem::restoreFromHistory() {
+    if (!history.isOpen()) {
+        return;
+    }
+
+    time_t now = ShiftClock::now();
+    const MenuSnapshot& menu = catalog.snapshot();
+    pmr::vector<Order> restored(&shift);
+    vector<Food> meal;
+
+    history.query((now / 3600 - 1) * 3600, now + 1, [&](const HistoryEntry& entry) {
+        if (entry.cancelled || entry.status != READY_FOR_PICKUP || findOrderIndex(entry.orderID) >= 0) {
+            return;
+        }
+        meal.clear();
+        for (int i = 0; i < entry.mealSize; i++) {
+            if (entry.itemCode(i) < 17) {
+                meal.push_back(Food(menu.items[entry.itemCode(i)], entry.itemCents(i)));
             }
         }
+        uint32_t nameID = names.intern(entry.name);
+        restored.emplace_back(entry.orderID, nameID, names.get(nameID), entry.type, meals.intern(meal), 0,
+                              READY_FOR_PICKUP);
+        restored.back().setPlacedTime(entry.placedTime);
+        restored.back().setPromisedTime(entry.promisedTime);
+        restored.back().setPricing(entry.discountCents, entry.feePercent);
+    });
 
-        if (!(inputStreamPP >> skipCountFile >> statusFile)) {
-            cerr << "Error reading skip count and status" << endl;
-            break;
+    if (restored.empty()) {
+        return;
+    }
+
+    auto byID = [](Order& a, Order& b) { return a.getOrderID() < b.getOrderID(); };
+    sort(restored.begin(), restored.end(), byID);
+    restored.erase(unique(restored.begin(), restored.end(),
+                          [](Order& a, Order& b) { return a.getOrderID() == b.getOrderID(); }), restored.end());
+
+    int currentID = Orders.empty() ? -1 : Orders[currentOrderIndex].getOrderID();
+    vector<int> restoredIDs;
+    pmr::vector<Order> merged(&shift);
+    merged.reserve(max<size_t>(Orders.size() + restored.size(), 256));
+    size_t loaded = 0;
+    for (Order& order : restored) {
+        while (loaded < Orders.size() && byID(Orders[loaded], order)) {
+            merged.push_back(std::move(Orders[loaded++]));
         }
-        statusFileCast = static_cast<Status>(statusFile);
+        restoredIDs.push_back(order.getOrderID());
+        nextID = max(nextID, order.getOrderID() + 1);
+        merged.push_back(std::move(order));
+    }
+    while (loaded < Orders.size()) {
+        merged.push_back(std::move(Orders[loaded++]));
+    }
+    Orders = std::move(merged);
+    // Restored orders start over at no skips, in among the others
+    saturatedSkips = 0;
+
+    for (int orderID : restoredIDs) {
+        trackOrder(Orders[findOrderIndex(orderID)]);
+    }
+    currentOrderIndex = max(0, findOrderIndex(currentID));
+    cout << restored.size() << " orders waiting for pickup restored from the history" << endl;
+}
+
+/**
+ * Reads a file for orders
+ * The name table and the meal table come first and each order refers to its name and meal by ID.
+ * The file is parsed in chunks on several threads by a StateLoader, then the orders are built in file
+ * order and their names indexed in one parallel sort. Orders only go into the shift arena here, which
+ * is single threaded. A file whose IDs are out of order is sorted by ID, which lookups depend on.
+ * With a history open, ready orders of the latest history segments are put back on the pickup list,
+ * and ready orders from a file written without history are archived as they load.
+ *
+ * @param inputStreamPP The state file.
+ * @param threads Threads to parse and index with, 0 for one per core.
+ */
+void RestaurantSystem::fileRead(istream& inputStreamPP, int threads){
+    if (threads <= 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+
+    StateLoader state;
+    if (!state.read(inputStreamPP, threads)) {
+        currentOrderIndex = 0;
+        nextID = 0;
+        restoreFromHistory();
+        return;
+    }
+    currentOrderIndex = state.currentOrderIndex;
+    nextID = state.nextID;
+    saturatedSkips = 0;
 
+    // Name table, written once per snapshot and referenced by ID from the orders
+    vector <uint32_t> nameIDs;
+    nameIDs.reserve(state.names.size());
+    for (string_view name : state.names) {
+        nameIDs.push_back(names.intern(name));
+    }
 
-        Orders.push_back(Order(orderIDFile, nameFile, typeFileCast,
-                          mealFileCast, skipCountFile, statusFileCast));
+    if (!state.error.empty()) {
+        cerr << state.error << endl;
+    }
 
+    // Meal table, each distinct meal written once and referenced by ID from the orders.
+    // Items keep the price they were charged, whatever the menu says now
+    const MenuSnapshot& menu = catalog.snapshot();
+    vector <const Meal*> mealIDs;
+    mealIDs.reserve(state.meals.size());
+    vector <Food> mealFileCast;
+    for (const LoadedMeal& loaded : state.meals) {
+        mealFileCast.clear();
+        for (uint32_t k = 0; k < loaded.size; k++) {
+            const LoadedItem& item = state.mealItems[loaded.firstItem + k];
+            mealFileCast.push_back(Food(menu.items[item.code], item.cents));
+        }
+        mealIDs.push_back(meals.intern(mealFileCast));
     }
 
+    vector <NameEntry> loadedNames;
+    loadedNames.reserve(state.orderCount());
+    Orders.reserve(Orders.size() + state.orderCount());
+    size_t firstLoaded = Orders.size();
+    bool ascending = true;
+
+    for (const LoadedChunk& chunk : state.chunks) {
+        ascending = ascending && chunk.ascending && (chunk.orders.empty() || Orders.size() == 0
+                                                     || Orders.back().getOrderID() < chunk.orders.front().orderID);
+        for (const LoadedOrder& loaded : chunk.orders) {
+            uint32_t nameID = nameIDs[loaded.nameID];
+            Status status = static_cast<Status>(loaded.status);
+
+            Order& order = Orders.emplace_back(loaded.orderID, nameID, names.get(nameID),
+                                               static_cast<OrderType>(loaded.type), mealIDs[loaded.mealID],
+                                               loaded.skipCount, status);
+            order.setPromisedTime(loaded.promisedTime);
+            order.setPricing(loaded.discountCents, loaded.feePercent);
+            trackQueues(order);
+            loadedNames.push_back(NameEntry{order.getName(), order.getOrderID(), status});
+            if (status == READY_FOR_PICKUP) {
+                history.append(order, false);
+            }
+        }
+        if (!chunk.error.empty()) {
+            cerr << chunk.error << endl;
+            break;
+        }
+    }
+    nameIndex.insertAll(loadedNames, threads);
 
+    if (currentOrderIndex < 0 || currentOrderIndex >= Orders.size()){
+        currentOrderIndex = 0;
+    }
+    if (!ascending) {
+        int currentID = Orders.empty() ? -1 : Orders[currentOrderIndex].getOrderID();
+        sort(Orders.begin() + firstLoaded, Orders.end(),
+             [](Order& a, Order& b) { return a.getOrderID() < b.getOrderID(); });
+        currentOrderIndex = max(0, findOrderIndex(currentID));
+    }
+    restoreFromHistory();
+    boardDirty = true;
 };
 
 /**
  * Writes orders to a file
+ * Customer names and meals are written once in a name table and a meal table ahead of the orders.
  */
 void RestaurantSystem::fileWrite(ofstream& outputStreamPP){
-    if (Orders.size() > 0) {
-        outputStreamPP << currentOrderIndex << " " << nextID << endl;
+    writeState(outputStreamPP, false);
+}
+
+/**
+ * Writes the orders in the state file format.
+ * A state file leaves out ready orders when they are in the history, and is empty without orders.
+ * A checkpoint for followers has every order and always its header, so it also carries the next ID.
+ *
+ * @param outputStreamPP The stream to write to.
+ * @param checkpoint Whether to write a checkpoint rather than a state file.
+ */
+void RestaurantSystem::writeState(ostream& outputStreamPP, bool checkpoint){
+    // Ready orders are already in the history, which puts the recent ones back at startup
+    auto isWritten = [this, checkpoint](Order& order) {
+        return checkpoint || !history.isOpen() || order.getOrderStatus() != READY_FOR_PICKUP;
+    };
+
+    int writtenIndex = 0;
+    for (int i = 0; i < currentOrderIndex && i < Orders.size(); i++) {
+        writtenIndex += isWritten(Orders[i]);
     }
+
+    // Only the names and meals of written orders, numbered by first use so equal states write equal files
+    vector <uint32_t> fileNameIDs(names.size(), 0);
+    vector <uint32_t> writtenNames;
+    vector <uint32_t> fileMealIDs(meals.size() + 1, 0);
+    vector <const Meal*> written;
+    for (Order& order : Orders) {
+        if (!isWritten(order)) {
+            continue;
+        }
+        if (fileNameIDs[order.getNameID()] == 0) {
+            writtenNames.push_back(order.getNameID());
+            fileNameIDs[order.getNameID()] = writtenNames.size();
+        }
+        if (fileMealIDs[order.getMealID()] == 0) {
+            written.push_back(order.getSharedMeal());
+            fileMealIDs[order.getMealID()] = written.size();
+        }
+    }
+
+    if (Orders.size() > 0 || checkpoint) {
+        outputStreamPP << writtenIndex << " " << nextID << endl;
+
+        // Each distinct name is written once; orders refer to it by ID
+        outputStreamPP << writtenNames.size() << "\n";
+        for (uint32_t nameID : writtenNames) {
+            outputStreamPP << names.get(nameID) << "\n";
+        }
+
+        // Each distinct meal is written once as its item count and code and price pairs
+        outputStreamPP << written.size() << "\n";
+        for (const Meal* meal : written) {
+            outputStreamPP << meal->items.size();
+            for (const Food& item : meal->items) {
+                outputStreamPP << " " << item.getFood() << " " << item.getPriceCents();
+            }
+            outputStreamPP << "\n";
+        }
+    }
+    bool first = true;
     for (int i = 0; i < Orders.size(); i++) {
-        if (i > 0){
+        if (!isWritten(Orders[i])){
+            continue;
+        }
+        if (!first){
             outputStreamPP << "\n";
         }
+        first = false;
 
-        outputStreamPP << Orders[i].getOrderID() << " " << Orders[i].getName() << " " <<
+        outputStreamPP << Orders[i].getOrderID() << " " << fileNameIDs[Orders[i].getNameID()] - 1 << " " <<
                       Orders[i].getOrderType() << " " << Orders[i].getSkipCount() << " "
-                      << Orders[i].getOrderStatus();
+                      << Orders[i].getOrderStatus() << " " << Orders[i].getPromisedTime() << " "
+                      << Orders[i].getDiscountCents() << " " << Orders[i].getFeePercent() << " "
+                      << fileMealIDs[Orders[i].getMealID()] - 1;
+    }
+};
+
+/**
+ * Starts shipping the changes of this system to followers on a local socket.
+ * Recording continues the sequence numbers this system last applied, so a follower that takes
+ * over keeps the numbering of the leader it replaces. Followers start from a checkpoint of the
+ * current state.
+ *
+ * @param socketPath The socket path.
+ * @return False if another terminal leads the socket already.
+ */
+bool RestaurantSystem::lead(const string& socketPath){
+    if (!leader.start(socketPath)) {
+        return false;
+    }
+    replication.setRecording(true, replication.lastLSN());
+    takeCheckpoint();
+    return true;
+}
+
+/**
+ * Mirrors the orders of the leader on a local socket until it goes away.
+ * A checkpoint replaces every order; a batch is applied operation by operation through the same
+ * paths the leader took, so the queues, timers and indexes follow along. The order tasks the batch
+ * signalled are resumed after it, as the leader's tick does, so their frames do not pile up. The
+ * leader is acknowledged once per burst, after the last frame that had already arrived.
+ *
+ * @param socketPath The socket path.
+ * @return How the leader went away.
+ */
+FollowEnd RestaurantSystem::follow(const string& socketPath){
+    ReplicationFollower link;
+    if (!link.connect(socketPath)) {
+        return NO_LEADER;
+    }
+
+    bool echoBefore = echo;
+    echo = false;
+    FollowEnd end = LEADER_LOST;
+    ReplicationFrame header;
+    string payload;
+    ReplicatedOp op;
+
+    while (link.receive(header, payload)) {
+        if (header.kind == FRAME_SHUTDOWN) {
+            end = LEADER_SHUT_DOWN;
+            break;
+        }
+        if (header.kind == FRAME_CHECKPOINT) {
+            clearOrders();
+            istringstream state(payload);
+            fileRead(state);
+            cout << "Replica of " << Orders.size() << " orders at change " << header.lastLSN << endl;
+        } else {
+            const char* at = payload.data();
+            const char* batchEnd = at + payload.size();
+            while (ReplicationLog::decode(at, batchEnd, op)) {
+                applyOperation(op);
+                // A batch can hold more changes than the bus keeps, and no tick runs while following
+                drainMetrics();
+            }
+            if (at != batchEnd) {
+                cerr << "Damaged change batch ending at change " << header.lastLSN << ", rest skipped" << endl;
+            }
+        }
+        pipeline.run();
+        replication.setRecording(false, header.lastLSN);
+
+        if (!link.hasPending()) {
+            link.acknowledge(header);
+        }
+    }
+    // What happened while following is not news to this terminal's console
+    drainDisplay();
+    echo = echoBefore;
+    return end;
+}
+
+/**
+ * Shows the followers of this system, the last change each applied and its replication lag:
+ * the time from publishing a batch to the follower's acknowledgement of it.
+ */
+void RestaurantSystem::replicationStatus(){
+    if (!leader.isRunning()) {
+        cout << "Not replicating; start with -L <socket> to lead followers" << endl;
+        return;
+    }
+
+    uint64_t lastLSN = leader.lastLSN();
+    vector<FollowerStatus> followers = getFollowers();
+    cout << "\nLeading at change " << lastLSN << ", " << followers.size() << " followers" << endl;
+    cout << "--#--|---CHANGE---|-BEHIND-|--LAG MS--|--MEAN--|--MAX--" << endl;
+    for (size_t k = 0; k < followers.size(); k++) {
+        const FollowerStatus& follower = followers[k];
+        cout << setw(4) << right << (k + 1) << " | " << setw(10) << follower.ackedLSN << " | "
+             << setw(6) << (lastLSN - follower.ackedLSN) << " | " << fixed << setprecision(2)
+             << setw(8) << follower.lagMs << " | " << setw(6) << follower.meanLagMs << " | "
+             << setw(6) << follower.maxLagMs << left << endl;
+    }
+    cout.unsetf(ios::fixed);
+}
+
+/**
+ * Retrieves the replication state of the followers.
+ *
+ * @return One entry per connected follower, empty unless leading.
+ */
+vector<FollowerStatus> RestaurantSystem::getFollowers(){
+    return leader.isRunning() ? leader.status() : vector<FollowerStatus>();
+}
+
+/**
+ * Retrieves the last change shipped to the followers.
+ *
+ * @return Its sequence number, 0 unless leading.
+ */
+uint64_t RestaurantSystem::lastChange(){
+    return leader.isRunning() ? leader.lastLSN() : 0;
+}
+
+/**
+ * Writes every order and the next ID in the state file format, ready orders included even when
+ * they are in the history.
+ *
+ * @param outputStreamPP The stream to write to.
+ */
+void RestaurantSystem::writeCheckpoint(ostream& outputStreamPP){
+    writeState(outputStreamPP, true);
+}
+
+/**
+ * Digests the whole state as a 64-bit FNV-1a hash of its checkpoint, so a replayed shift can be
+ * checked against the one recorded without keeping the state itself.
+ *
+ * @return The digest.
+ */
+uint64_t RestaurantSystem::stateDigest(){
+    ostringstream state;
+    writeState(state, true);
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : state.str()) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Empties the system of orders and of everything derived from them, before a checkpoint
+ * replaces them. Names, menu, pricing and inventory stay.
+ */
+void RestaurantSystem::clearOrders(){
+    Orders.clear();
+    currentOrderIndex = 0;
+    saturatedSkips = 0;
+    nextID = 0;
+    consecutiveDeadlineDispatches = 0;
+    batcher = KitchenBatcher();
+    estimator = WaitEstimator();
+    deadlines = DeadlineScheduler();
+    timers = TimerWheel();
+    pipeline.clear();
+    nameIndex = NameIndex();
+    boardDirty = true;
+}
+
+/**
+ * Applies an operation of the leader's change log.
+ * Status changes go through the same steps as on the leader: a dispatch takes the order out of the
+ * placed queue and makes it the current order, completion and pickup update the estimator,
+ * deadlines and timers. Operations about orders this system does not have are ignored.
+ *
+ * @param op The operation.
+ */
+void RestaurantSystem::applyOperation(const ReplicatedOp& op){
+    if (op.kind == OP_STOCK) {
+        inventory.setStock(static_cast<FOOD>(op.orderID), op.value, op.lowAt);
+        return;
+    }
+    if (op.kind == OP_STATUS_BATCH) {
+        transitionOrders(vector<int>(op.orderIDs.begin(), op.orderIDs.end()), static_cast<Status>(op.status));
+        return;
+    }
+    if (op.kind == OP_SPILL) {
+        vector<int> indexes;
+        for (int32_t orderID : op.orderIDs) {
+            int index = findOrderIndex(orderID);
+            if (index >= 0 && Orders[index].getOrderStatus() == READY_FOR_PICKUP) {
+                indexes.push_back(index);
+            }
+        }
+        spillAt(indexes);
+        return;
+    }
+
+    int index = findOrderIndex(op.orderID);
+    if (op.kind == OP_PLACE) {
+        applyPlacement(op, index);
+        return;
+    }
+    if (index < 0) {
+        return;
+    }
+
+    Order& order = Orders[index];
+    switch (op.kind) {
+        case OP_STATUS:
+            if (op.status == COOKING && order.getOrderStatus() == PLACED) {
+                dispatchOrder(index);
+            } else if (op.status == COMPLETE) {
+                changeStatus(order, 1);
+            } else if (op.status == READY_FOR_PICKUP) {
+                changeStatus(order, 2);
+                armSlaTimer(order, PICKUP_SLA);
+            } else {
+                changeStatus(order, op.status - 1);
+            }
+            break;
+        case OP_SKIP:
+            addSkipCountToAll(index);
+            break;
+        case OP_ESCALATE:
+            order.escalate();
+            break;
+        case OP_COLD:
+            order.markCold();
+            boardDirty = true;
+            break;
+        case OP_CANCEL:
+            if (order.getOrderStatus() == PLACED) {
+                cancelAt(index);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Applies a new or edited order of the change log.
+ * A new order joins the placed queue like one taken at the counter. An edited order has its meal and
+ * pricing replaced and the kitchen's demand and wait aggregates follow, as editOrder does. The
+ * order's portions are taken from the inventory, and an edit first gives back the old ones.
+ *
+ * @param op The operation.
+ * @param index Index of the order, or -1 if it is new.
+ */
+void RestaurantSystem::applyPlacement(const ReplicatedOp& op, int index){
+    const MenuSnapshot& menu = catalog.snapshot();
+    vector<Food> meal;
+    for (const ReplicatedItem& item : op.items) {
+        meal.push_back(Food(menu.items[item.code], item.cents));
+    }
+    uint32_t nameID = names.intern(op.name);
+    Order placed(op.orderID, nameID, names.get(nameID), static_cast<OrderType>(op.type), meals.intern(meal),
+                 op.value, static_cast<Status>(op.status));
+    placed.setPlacedTime(op.placedTime);
+    placed.setPromisedTime(op.promisedTime);
+    placed.setPricing(op.discountCents, op.feePercent);
+
+    if (index >= 0) {
+        Order& order = Orders[index];
+        if (order.getOrderStatus() != PLACED) {
+            return;
+        }
+        int prepTimeBefore = order.getPrepTime();
+        batcher.removeOrder(order);
+        for (const Food& item : order.getMeal()) {
+            inventory.release(item.getFood());
+        }
+        placed.setSlaTimer(order.getSlaTimer());
+        placed.setTask(order.getTask());
+        order = std::move(placed);
+        for (const Food& item : order.getMeal()) {
+            inventory.reserve(item.getFood());
+        }
+        batcher.addOrder(order);
+        if (order.getPrepTime() != prepTimeBefore) {
+            estimator.orderEdited(order, prepTimeBefore);
+            deadlines.reschedule(order);
+        }
+        boardDirty = true;
+    } else if (Orders.empty() || Orders.back().getOrderID() < op.orderID) {
+        for (const Food& item : placed.getMeal()) {
+            inventory.reserve(item.getFood());
+        }
+        nextID = max(nextID, op.orderID);
+        enqueueOrder(placed);
+    } else {
+        cerr << "Replicated order #" << op.orderID << " arrived out of order, skipped" << endl;
+    }
+}
+
+/**
+ * Sends the followers a checkpoint of the whole state, as a state file of every order.
+ * Stock is not part of a state file, so the counted foods follow as the first batch after it.
+ */
+void RestaurantSystem::takeCheckpoint(){
+    ostringstream state;
+    writeState(state, true);
+    leader.setCheckpoint(state.str(), replication.lastLSN());
 
-        outputStreamPP << "\n" << Orders[i].mealToString();
+    for (int i = 0; i < 17; i++) {
+        FOOD food = static_cast<FOOD>(i);
+        if (inventory.getStock(food) >= 0) {
+            replication.stock(food, inventory.getStock(food), inventory.getLowAt(food));
+        }
+    }
+    if (!replication.empty()) {
+        leader.publish(replication.take(), replication.lastLSN());
+    }
+}
 
+/**
+ * Publishes the changes recorded since the last flush to the followers as one batch,
+ * and a new checkpoint once the batches kept for late followers outgrow the last one.
+ */
+void RestaurantSystem::flushReplication(){
+    if (!leader.isRunning()) {
+        return;
+    }
+    if (!replication.empty()) {
+        leader.publish(replication.take(), replication.lastLSN());
     }
-};
\ No newline at end of file
+    if (leader.wantsCheckpoint()) {
+        takeCheckpoint();
+    }
+}
@@ -11,24 +11,307 @@
 #include <unordered_map>
 #include <fstream>
 #include "Order.h"
+#include "KitchenBatcher.h"
+#include "WaitEstimator.h"
+#include "DeadlineScheduler.h"
+#include "TimerWheel.h"
+#include "OrderPipeline.h"
+#include "EventBus.h"
+#include "BoardPublisher.h"
+#include "ConsoleRenderer.h"
+#include "ReceiptFormatter.h"
+#include "StringPool.h"
+#include "MealTable.h"
+#include "ShiftArena.h"
+#include "NameIndex.h"
+#include "PricingRules.h"
+#include "Inventory.h"
+#include "MenuCatalog.h"
+#include "OrderHistory.h"
+#include "StateLoader.h"
+#include "ReplicationLog.h"
+#include "Replicator.h"
 
 using namespace std;
 
+/**
+ * Summary of one store, for reports across stores.
+ */
+struct StoreReport {
+    long orders = 0; // Orders in the system
+    long byStatus[4] = {}; // Orders per Status
+    long byType[4] = {}; // Orders per OrderType
+    long chargedCents = 0; // Total charged over every order in the system
+    int waitSeconds[4] = {}; // Wait quoted per OrderType for an order with no prep time
+};
+
+/**
+ * Memory held by one store, by what holds it.
+ * The orders, the order list and the meals live in the shift arena, whose heap chunks are shown apart.
+ */
+struct MemoryFootprint {
+    size_t orderBytes = 0; // Orders in the system
+    size_t orderSlackBytes = 0; // Room left in the order list, taken by the next orders
+    size_t mealBytes = 0; // Shared meal compositions
+    size_t nameBytes = 0; // Customer names
+    size_t indexBytes = 0; // Name index, timers, deadlines, wait estimates, kitchen tickets and order tasks
+    size_t archiveBytes = 0; // Open history blocks and their buffers
+    size_t replicationBytes = 0; // Changes and frames held for followers
+    size_t total = 0; // Sum of the above but the slack, what the memory budget is held to; spilling frees orders and indexes only
+    size_t arenaReserved = 0; // Heap chunks of the shift arena
+    size_t arenaInUse = 0; // Blocks of the shift arena not given back
+};
+
 /**
  * Manages the queueing system of orders in a restaurant.
  */
 class RestaurantSystem {
 private:
     int nextID = 0;
-    vector <Order> Orders;
+    StringPool names; // Customer names of the shift, shared by every order with that name
+    MenuCatalog catalog; // Menu versions of the shift, items in orders point into them
+    string menuPath; // Menu file last loaded, reloaded by reloadMenu
+    ShiftArena shift; // Memory of the shift's orders and meals, declared before the orders so it outlives them
+    MealTable meals{&shift}; // Distinct meal compositions of the shift, shared by every order with those items
+    pmr::vector <Order> Orders{&shift};
     int currentOrderIndex = 0;
+    int saturatedSkips = 0; // Leading orders whose skip count is at its maximum, passed over by skipping
+    KitchenBatcher batcher; // Running per-FOOD demand over placed orders
+    WaitEstimator estimator; // Running queue aggregates for wait time quotes
+    DeadlineScheduler deadlines; // Earliest-deadline-first heap of promised orders
+    bool deadlineMode = false; // Whether promised orders may jump the type priorities
+    int consecutiveDeadlineDispatches = 0; // Deadline dispatches since the last type priority dispatch
+    TimerWheel timers; // Service level timers of placed and ready orders
+    OrderPipeline pipeline; // Tasks of the orders in the kitchen and the cook queue of each type
+    EventBus events; // Placements, status changes and cancels for subscribers
+    int displaySubscriber; // Console display's subscription to the event bus
+    int metricsSubscriber; // Metrics subscription to the event bus
+    long eventCounts[4] = {}; // Events seen by the metrics subscription per EventKind
+    BoardPublisher board; // Shared-memory mirror of the orders for external displays
+    int boardSubscriber; // Board's subscription to the event bus
+    bool boardDirty = false; // Whether the board misses a change not seen on the event bus
+    ConsoleRenderer listRenderer{1}; // Full redraw renderer of the order lists on standard output
+    ConsoleRenderer kitchenRenderer; // Diff renderer of the kitchen display, disabled until set
+    ReceiptFormatter receipts; // Compiled receipt templates for batch reprints
+    NameIndex nameIndex; // Orders by customer name for lookups at the pickup counter
+    PricingRules pricing; // Compiled promotions, combos and fees orders are priced with
+    Inventory inventory; // Portions left per food, shared with every intake
+    uint32_t stockVersion = 0; // Inventory mask version last reported
+    uint32_t reportedLow = 0; // Foods last reported as running low
+    uint32_t reportedAvailable = (1u << 17) - 1; // Foods last reported as available
+    OrderHistory history; // Hourly segments of finished and cancelled orders, closed unless set
+    bool echo = true; // Whether dispatched orders and status changes are printed
+    int lastDispatchedID = -1; // Order sent to the kitchen last
+    ReplicationLog replication; // Changes to the orders recorded for followers while leading
+    ReplicationLeader leader; // Ships the recorded changes to followers, idle unless leading
+    size_t memoryBudget = 0; // Footprint ready orders are spilled to stay under, 0 for none
+    long spilledOrders = 0; // Ready orders spilled out of memory this shift
+    bool budgetWarned = false; // Whether being over budget with nothing to spill was reported
+
+    /**
+     * Sends the order at index to the kitchen
+     * and marks it as cooking
+     * @param index
+     */
+    void dispatchOrder(int index);
+
+    /**
+     * Adds a priced order to the
+     * placed queue and its aggregates
+     * @param order
+     */
+    void enqueueOrder(Order& order);
+
+    /**
+     * Finds an order by ID
+     * @param orderID
+     * @return index of the order or -1
+     * if it is not in the system
+     */
+    int findOrderIndex(int orderID);
+
+    /**
+     * Registers an order loaded from
+     * file with the queue aggregates
+     * @param order
+     */
+    void trackOrder(Order& order);
+
+    /**
+     * Registers an order with the queue
+     * aggregates but not the name index
+     * @param order
+     */
+    void trackQueues(Order& order);
+
+    /**
+     * Arms the service level timer
+     * of an order for its type
+     * @param order
+     * @param kind
+     */
+    void armSlaTimer(Order& order, TimerKind kind);
+
+    /**
+     * Cancels the service level
+     * timer of an order
+     * @param order
+     */
+    void clearSlaTimer(Order& order);
+
+    /**
+     * Updates the kitchen's demand and
+     * the wait aggregates for a change
+     * of an order's status
+     * @param order
+     * @param fromStatus status before the change
+     */
+    void updateQueues(Order& order, Status fromStatus);
+
+    /**
+     * Moves the task of an order on
+     * to the order's new status
+     * @param order
+     */
+    void advanceTask(Order& order);
+
+    /**
+     * Publishes an event about an
+     * order on the event bus
+     * @param kind
+     * @param order
+     * @param fromStatus status before the event
+     */
+    void publishEvent(EventKind kind, Order& order, Status fromStatus);
+
+    /**
+     * Puts orders still waiting to be
+     * picked up back on the pickup list
+     * from the latest history segments
+     */
+    void restoreFromHistory();
+
+    /**
+     * Sets the status of an order
+     * and publishes the transition
+     * @param order
+     * @param statusP
+     */
+    void changeStatus(Order& order, int statusP);
+
+    /**
+     * Prints status changes from
+     * the display subscription
+     */
+    void drainDisplay();
+
+    /**
+     * Counts the events of the
+     * metrics subscription by kind
+     */
+    void drainMetrics();
+
+    /**
+     * Republishes the shared-memory
+     * order board if anything changed
+     */
+    void refreshBoard();
+
+    /**
+     * Prints foods that started running
+     * low, sold out or came back
+     */
+    void reportStock();
+
+    /**
+     * Redraws the changed rows
+     * of the kitchen display
+     */
+    void renderKitchenDisplay();
+
+    /**
+     * Cancels the placed order at index
+     * and takes it out of the system
+     * @param index
+     */
+    void cancelAt(int index);
+
+    /**
+     * Moves the orders at indexes to a
+     * later status as one batch
+     * @param indexes
+     * @param status
+     * @return number of orders moved
+     */
+    int transitionAt(const vector<int>& indexes, Status status);
+
+    /**
+     * Drops the ready orders at indexes
+     * from memory, leaving them in
+     * the history
+     * @param indexes in ascending order
+     * @return number of orders spilled
+     */
+    int spillAt(const vector<int>& indexes);
+
+    /**
+     * Spills the oldest ready orders
+     * when the footprint is over the
+     * memory budget; names and meals
+     * stay for the shift
+     */
+    void enforceMemoryBudget();
+
+    /**
+     * Writes the state file format
+     * @param out
+     * @param checkpoint whether ready orders
+     * and an empty header are written too
+     */
+    void writeState(ostream& out, bool checkpoint);
+
+    /**
+     * Empties the system of orders
+     * before a checkpoint replaces them
+     */
+    void clearOrders();
+
+    /**
+     * Applies an operation of the
+     * leader's change log
+     * @param op
+     */
+    void applyOperation(const ReplicatedOp& op);
+
+    /**
+     * Applies a new or edited
+     * order of the change log
+     * @param op
+     * @param index index of the order
+     * or -1 if it is new
+     */
+    void applyPlacement(const ReplicatedOp& op, int index);
+
+    /**
+     * Sends the followers a checkpoint
+     * of the whole state
+     */
+    void takeCheckpoint();
+
+    /**
+     * Publishes the changes recorded
+     * since the last flush to followers
+     */
+    void flushReplication();
 
 public:
 
     /**
      * Constructor for the RestaurantSystem class.
+     * @param boardName shared-memory object
+     * the order board is published in
      */
-    RestaurantSystem();
+    explicit RestaurantSystem(const string& boardName = BOARD_SHM_NAME);
 
     void printOrders(int statusP, const vector<int>& typePs);
 
@@ -57,17 +340,119 @@ public:
      */
     bool checkQueueForType(OrderType type);
     /**
-     * Places an order into the system with a specific order ID and type.
-     * @param orderID Unique identifier for the order.
-     * @param type Type of the order.
+     * Prompts user for an order and places it into the system.
+     * @return Quoted wait time in seconds, or -1 if nothing was ordered.
      */
-    void placeOrder();
+    int placeOrder();
 
     /**
      * Processes and gets the next order to be cooked.
      */
     void getNextOrderToCook();
 
+    /**
+     * Places an order without prompting
+     * Items that are sold out or off
+     * the menu are left out
+     * @param name customer name
+     * @param type
+     * @param items
+     * @param promisedMinutes 0 for no promise
+     * @return ID of the order, or -1
+     * if none of its items were added
+     */
+    int submitOrder(string_view name, OrderType type, const vector<FOOD>& items, int promisedMinutes = 0);
+
+    /**
+     * Quotes the wait for a new order
+     * without placing it
+     * @param type
+     * @param prepTime seconds of work
+     * the new order brings
+     * @return quoted wait in seconds
+     */
+    int quoteWait(OrderType type, int prepTime);
+
+    /**
+     * Dispatches the next order to
+     * cook without printing it
+     * @return ID of the order, or -1
+     * if no order is waiting
+     */
+    int cookNextOrder();
+
+    /**
+     * Marks a cooking order as complete
+     * @param orderID
+     * @return whether the order was cooking
+     */
+    bool completeOrder(int orderID);
+
+    /**
+     * Marks an order ready for pickup
+     * @param orderID
+     * @return whether the order was found
+     */
+    bool readyOrder(int orderID);
+
+    /**
+     * Moves many orders to complete or
+     * ready for pickup in one pass
+     * @param orderIDs in any order
+     * @param status COMPLETE or
+     * READY_FOR_PICKUP
+     * @return number of orders moved
+     */
+    int transitionOrders(vector<int> orderIDs, Status status);
+
+    /**
+     * Moves every order with a status
+     * and type to a later status
+     * @param from
+     * @param types empty for every type
+     * @param status COMPLETE or
+     * READY_FOR_PICKUP
+     * @return number of orders moved
+     */
+    int transitionMatching(Status from, const vector<OrderType>& types, Status status);
+
+    /**
+     * Summarizes the orders and
+     * queues of the store
+     * @return the store's report
+     */
+    StoreReport report();
+
+    /**
+     * Adds up the memory held by the
+     * orders and everything kept for them,
+     * without the order list room and
+     * the arena's chunks
+     * @return the store's footprint
+     */
+    MemoryFootprint memoryFootprint();
+
+    /**
+     * Sets the footprint the store is
+     * held under by spilling ready
+     * orders to the history
+     * @param bytes 0 for no budget
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /**
+     * Prints the footprint by what
+     * holds it and the memory budget
+     */
+    void memoryReport();
+
+    /**
+     * Chooses whether dispatched orders
+     * and status changes are printed
+     * @param enabled
+     */
+    void setEcho(bool enabled);
+
     /**
      * Prompts user for ID
      * Retrieves and displays details of a specific order based on its ID.
@@ -91,22 +476,197 @@ public:
      */
     void markOrderForPickup();
 
+    /**
+     * Prompts user for order IDs or a
+     * status and type filter
+     * Moves every order chosen to
+     * complete or ready for pickup
+     */
+    void bulkStatusChange();
+
     /**
      * Prompts user for ID
      * Cancels an order based on its ID.
      */
     void cancelOrder();
 
+    /**
+     * Prompts user for ID of a placed order
+     * Adds and removes items of the order
+     */
+    void editOrder();
+
+    /**
+     * Shows batches of identical items across placed orders
+     * Prompts user for a batch to mark as cooked
+     */
+    void showCookingBatches();
+
+    /**
+     * Fires service level timers that
+     * expired since the last tick and
+     * escalates the orders they guard
+     * Refreshes the shared-memory board
+     */
+    void tick();
+
+    /**
+     * Shows met and missed promised times
+     * Prompts user to toggle deadline scheduling
+     */
+    void deadlineReport();
+
+    /**
+     * Shows event counts and the
+     * backpressure of each subscriber
+     * and the order tasks in flight
+     */
+    void eventBusStatus();
+
+    /**
+     * Shows bytes and time per frame
+     * of the console renderers
+     */
+    void displayStatistics();
+
+    /**
+     * Prompts user for the start of a name
+     * Lists the orders of every customer
+     * whose name starts with it
+     */
+    void findOrdersByName();
+
+    /**
+     * Shows portions left per food
+     * Prompts user to restock one
+     */
+    void manageInventory();
+
+    /**
+     * Loads the pricing rules new
+     * orders are priced with
+     * @param path
+     * @return whether the file loaded
+     */
+    bool loadPricingRules(const string& path);
+
+    /**
+     * Loads a menu file and swaps
+     * it in for new orders
+     * @param path
+     * @return whether the menu was replaced
+     */
+    bool loadMenu(const string& path);
+
+    /**
+     * Archives finished and cancelled
+     * orders in a history directory
+     * @param path
+     * @return whether the directory opened
+     */
+    bool openHistory(const string& path);
+
+    /**
+     * Prompts for a day, hours and type
+     * and lists the archived orders
+     */
+    void historyReport();
+
+    /**
+     * Reloads the menu file, prompting
+     * for one if none was loaded yet
+     */
+    void reloadMenu();
+
+    /**
+     * Reprices every order under the
+     * current rules and shows how the
+     * charged totals compare
+     */
+    void reconcilePrices();
+
+    /**
+     * Prompts user for a status
+     * Reprints the receipts of every
+     * order with that status
+     */
+    void reprintReceipts();
+
+    /**
+     * Draws the kitchen display on
+     * a terminal or serial device
+     * @param path
+     * @return whether the device opened
+     */
+    bool setKitchenDisplay(const string& path);
+
+    /**
+     * Starts shipping changes to
+     * followers on a local socket
+     * @param socketPath
+     * @return false if another terminal
+     * leads the socket already
+     */
+    bool lead(const string& socketPath);
+
+    /**
+     * Mirrors the orders of the leader
+     * on a local socket until it goes away
+     * @param socketPath
+     * @return how the leader went away
+     */
+    FollowEnd follow(const string& socketPath);
+
+    /**
+     * Shows the followers and how
+     * far behind the leader they are
+     */
+    void replicationStatus();
+
+    /**
+     * Retrieves the replication
+     * state of the followers
+     * @return one entry per follower,
+     * empty unless leading
+     */
+    vector<FollowerStatus> getFollowers();
+
+    /**
+     * Retrieves the last change
+     * shipped to the followers
+     * @return its sequence number
+     */
+    uint64_t lastChange();
+
+    /**
+     * Writes every order and the
+     * next ID, as a state file
+     * @param outputStreamP
+     */
+    void writeCheckpoint(ostream& outputStreamP);
+
+    /**
+     * Digests the whole state, so two
+     * runs can be compared cheaply
+     * @return FNV-1a of the checkpoint
+     */
+    uint64_t stateDigest();
+
     /**
      * Destructor for the RestaurantSystem class.
-     * Responsible for freeing dynamically allocated memory.
+     * The orders give their blocks back to the shift arena,
+     * which then returns its chunks to the heap at once.
+     * Followers get the last changes and a shutdown.
      */
     ~RestaurantSystem();
 
     /**
      * Reads a file for orders
+     * @param inputStreamP
+     * @param threads threads to parse and
+     * index with, 0 for one per core
      */
-    void fileRead(ifstream& inputStreamP);
+    void fileRead(istream& inputStreamP, int threads = 0);
 
     /**
      * Writes orders to a file
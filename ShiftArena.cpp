@@ -0,0 +1,80 @@
+/**
+ * @file ShiftArena.cpp
+ * @brief This file contains the ShiftArena class, a monotonic arena released once per shift.
+ * @author Edward Villano
+ */
+
+#include "ShiftArena.h"
+
+/**
+ * Takes a chunk from the global heap and counts it.
+ */
+void* ShiftArena::CountingUpstream::do_allocate(size_t bytesP, size_t alignment){
+    allocations += 1;
+    bytes += bytesP;
+    return pmr::new_delete_resource()->allocate(bytesP, alignment);
+}
+
+/**
+ * Gives a chunk back to the global heap.
+ */
+void ShiftArena::CountingUpstream::do_deallocate(void* pointer, size_t bytesP, size_t alignment){
+    bytes -= bytesP;
+    pmr::new_delete_resource()->deallocate(pointer, bytesP, alignment);
+}
+
+bool ShiftArena::CountingUpstream::do_is_equal(const pmr::memory_resource& other) const noexcept{
+    return this == &other;
+}
+
+/**
+ * Constructor for the ShiftArena class.
+ *
+ * @param initialBytes Size of the first chunk taken from the heap.
+ */
+ShiftArena::ShiftArena(size_t initialBytes)
+        : arena(initialBytes, &heap){
+}
+
+/**
+ * Bumps a block out of the arena.
+ */
+void* ShiftArena::do_allocate(size_t bytes, size_t alignment){
+    stats.allocations += 1;
+    stats.bytesInUse += bytes;
+    return arena.allocate(bytes, alignment);
+}
+
+/**
+ * Counts a block given back. Its memory stays with the shift until release().
+ */
+void ShiftArena::do_deallocate(void* pointer, size_t bytes, size_t alignment){
+    stats.deallocations += 1;
+    stats.bytesInUse -= bytes;
+    arena.deallocate(pointer, bytes, alignment);
+}
+
+bool ShiftArena::do_is_equal(const pmr::memory_resource& other) const noexcept{
+    return this == &other;
+}
+
+/**
+ * Returns every block of the shift to the heap at once.
+ * The cost depends on the number of arena chunks, not on the number of orders.
+ */
+void ShiftArena::release(){
+    arena.release();
+    stats.bytesInUse = 0;
+}
+
+/**
+ * Retrieves the allocation counters of the shift.
+ *
+ * @return The counters.
+ */
+ArenaStats ShiftArena::getStats(){
+    ArenaStats current = stats;
+    current.heapAllocations = heap.allocations;
+    current.bytesReserved = heap.bytes;
+    return current;
+}
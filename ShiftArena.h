@@ -0,0 +1,86 @@
+/**
+ * @file ShiftArena.h
+ * @brief Defines the ShiftArena class, the per-shift memory resource orders and their meals are allocated from.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_SHIFTARENA_H
+#define RESTAURANTREAL_SHIFTARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+using namespace std;
+
+/**
+ * Allocation counters of a ShiftArena.
+ */
+struct ArenaStats {
+    long allocations = 0; // Blocks handed to orders and their containers
+    long deallocations = 0; // Blocks given back by orders and their containers
+    long bytesInUse = 0; // Bytes handed out and not given back
+    long heapAllocations = 0; // Chunks taken from the global heap
+    long bytesReserved = 0; // Bytes taken from the global heap
+};
+
+/**
+ * @class ShiftArena
+ * @brief Memory resource for everything that lives for one shift.
+ *
+ * Blocks are bumped out of a monotonic arena that takes geometrically growing chunks from the
+ * global heap. Freed blocks are not reused: orders are small and a shift is bounded, so the
+ * memory a shift leaves behind costs less than recycling it would (see tools/OrderAllocBench.cpp).
+ * The whole shift is returned by release(), which only walks the arena's chunks.
+ *
+ * The arena is single threaded, like the rest of the system's order state.
+ */
+class ShiftArena : public pmr::memory_resource {
+    private:
+        /**
+         * Forwards to the global heap and counts the chunks it hands out.
+         */
+        class CountingUpstream : public pmr::memory_resource {
+            public:
+                long allocations = 0;
+                long bytes = 0;
+
+            private:
+                void* do_allocate(size_t bytesP, size_t alignment) override;
+                void do_deallocate(void* pointer, size_t bytesP, size_t alignment) override;
+                bool do_is_equal(const pmr::memory_resource& other) const noexcept override;
+        };
+
+        CountingUpstream heap; // Global heap, counted
+        pmr::monotonic_buffer_resource arena; // Bump allocator over heap chunks
+        ArenaStats stats;
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const pmr::memory_resource& other) const noexcept override;
+
+    public:
+        /**
+         * Constructor for the ShiftArena class.
+         *
+         * @param initialBytes Size of the first chunk taken from the heap.
+         */
+        explicit ShiftArena(size_t initialBytes = 64 * 1024);
+
+        ShiftArena(const ShiftArena&) = delete;
+        ShiftArena& operator=(const ShiftArena&) = delete;
+
+        /**
+         * Returns every block of the shift to the heap at once.
+         * Anything still allocated from the arena is invalid afterwards.
+         */
+        void release();
+
+        /**
+         * Retrieves the allocation counters of the shift.
+         *
+         * @return The counters.
+         */
+        ArenaStats getStats();
+};
+
+#endif //RESTAURANTREAL_SHIFTARENA_H
@@ -0,0 +1,35 @@
+/**
+ * @file ShiftClock.cpp
+ * @brief This file contains the ShiftClock class, the system's settable wall clock.
+ * @author Edward Villano
+ */
+
+#include "ShiftClock.h"
+
+atomic<time_t> ShiftClock::fixed{0};
+
+/**
+ * Reads the clock.
+ *
+ * @return The time set by a replay, or the system time.
+ */
+time_t ShiftClock::now(){
+    time_t time = fixed.load(memory_order_relaxed);
+    return time > 0 ? time : ::time(nullptr);
+}
+
+/**
+ * Holds the clock at a time until set again or released.
+ *
+ * @param time The time, greater than 0.
+ */
+void ShiftClock::set(time_t time){
+    fixed.store(time, memory_order_relaxed);
+}
+
+/**
+ * Goes back to the system clock.
+ */
+void ShiftClock::release(){
+    fixed.store(0, memory_order_relaxed);
+}
@@ -0,0 +1,48 @@
+/**
+ * @file ShiftClock.h
+ * @brief Defines the ShiftClock class, the time of day every part of the system reads, which a
+ *        replay can hold to the times of a recorded shift.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_SHIFTCLOCK_H
+#define RESTAURANTREAL_SHIFTCLOCK_H
+
+#include <atomic>
+#include <ctime>
+
+using namespace std;
+
+/**
+ * @class ShiftClock
+ * @brief Wall clock in seconds for placement times, timers, deadlines, pricing hours and the history.
+ *
+ * It reads the system clock unless a replay has set it, in which case it stays at the time set until
+ * set again, so a recorded shift sees the same times on every replay however fast it runs.
+ */
+class ShiftClock {
+    private:
+        static atomic<time_t> fixed; // Time set by a replay, 0 to read the system clock
+
+    public:
+        /**
+         * Reads the clock.
+         *
+         * @return The time set by a replay, or the system time.
+         */
+        static time_t now();
+
+        /**
+         * Holds the clock at a time until set again or released.
+         *
+         * @param time The time, greater than 0.
+         */
+        static void set(time_t time);
+
+        /**
+         * Goes back to the system clock.
+         */
+        static void release();
+};
+
+#endif //RESTAURANTREAL_SHIFTCLOCK_H
@@ -0,0 +1,210 @@
+/**
+ * @file StateLoader.cpp
+ * @brief This file contains the StateLoader class, the chunked parallel parser of state files.
+ * @author Edward Villano
+ */
+
+#include "StateLoader.h"
+#include <algorithm>
+#include <charconv>
+#include <thread>
+
+static const size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+/**
+ * Checks for the whitespace the stream reader skips between tokens.
+ */
+static bool isSpace(char c){
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+/**
+ * Reads whitespace separated tokens out of a range of the file.
+ */
+struct TokenReader {
+    const char* at;
+    const char* end;
+
+    /**
+     * Reads the next token as a number; false if there is none or it is not a number.
+     */
+    template <typename Number>
+    bool number(Number& value){
+        while (at < end && isSpace(*at)) {
+            at++;
+        }
+        auto [next, error] = from_chars(at, end, value);
+        if (error != errc() || (next < end && !isSpace(*next))) {
+            return false;
+        }
+        at = next;
+        return true;
+    }
+
+    /**
+     * Reads the next token as text; empty if there is none.
+     */
+    string_view token(){
+        while (at < end && isSpace(*at)) {
+            at++;
+        }
+        const char* start = at;
+        while (at < end && !isSpace(*at)) {
+            at++;
+        }
+        return string_view(start, at - start);
+    }
+};
+
+/**
+ * Finds the start of the first order at or after a position.
+ * Every line after the tables is an order, so this is the start of the next line unless the position
+ * already is one.
+ *
+ * @param at A position in the orders of the file.
+ * @param end End of the file.
+ * @return The start of an order line, or end.
+ */
+const char* StateLoader::recordStart(const char* at, const char* end){
+    if (at[-1] != '\n') {
+        at = find(at, end, '\n');
+        at += (at < end);
+    }
+    return at;
+}
+
+/**
+ * Parses the orders of one chunk of the file into plain records.
+ * Parsing stops at the first order that cannot be read, as the stream reader did.
+ *
+ * @param begin Start of the first order of the chunk.
+ * @param end End of the chunk, the start of the next chunk's first order.
+ * @param chunk Receives the orders.
+ */
+void StateLoader::parseChunk(const char* begin, const char* end, LoadedChunk& chunk) const{
+    TokenReader in{begin, end};
+    chunk.orders.reserve((end - begin) / 24);
+
+    LoadedOrder order;
+    while (in.number(order.orderID) && in.number(order.nameID) && in.number(order.type)
+           && in.number(order.skipCount) && in.number(order.status) && in.number(order.promisedTime)
+           && in.number(order.discountCents) && in.number(order.feePercent) && in.number(order.mealID)) {
+
+        if (order.mealID >= meals.size()) {
+            chunk.error = "Error reading meal of order " + to_string(order.orderID);
+            return;
+        }
+        if (order.nameID >= names.size()) {
+            chunk.error = "Error reading name of order " + to_string(order.orderID);
+            return;
+        }
+
+        if (!chunk.orders.empty() && chunk.orders.back().orderID >= order.orderID) {
+            chunk.ascending = false;
+        }
+        chunk.orders.push_back(order);
+    }
+
+    if (in.token().size() > 0) {
+        chunk.error = "Error reading order after " + to_string(chunk.orders.empty() ? 0 : chunk.orders.back().orderID);
+    }
+}
+
+/**
+ * Reads and parses a state file.
+ * The file is read into memory with one read and its tables are parsed, then its orders are cut into
+ * chunks parsed on separate threads. Chunks are at least MIN_CHUNK_BYTES, so small files are parsed on the calling thread alone.
+ *
+ * @param input The state file, read from its current position to the end.
+ * @param threads Number of threads to parse with, at least one.
+ * @return False if the file has no header, as when it is empty.
+ * A meal table that cannot be read leaves error set and no orders.
+ */
+bool StateLoader::read(istream& input, int threads){
+    streampos start = input.tellg();
+    if (start >= 0 && input.seekg(0, ios::end)) {
+        text.resize(input.tellg() - start);
+        input.seekg(start);
+        input.read(text.data(), text.size());
+        text.resize(input.gcount());
+    } else {
+        input.clear();
+        text.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+    }
+
+    TokenReader header{text.data(), text.data() + text.size()};
+    uint32_t nameCount;
+    if (!header.number(currentOrderIndex) || !header.number(nextID) || !header.number(nameCount)) {
+        return false;
+    }
+    names.reserve(min<size_t>(nameCount, text.size() / 2));
+    for (uint32_t k = 0; k < nameCount; k++) {
+        string_view name = header.token();
+        if (name.empty()) {
+            break;
+        }
+        names.push_back(name);
+    }
+
+    // Meal table, each distinct composition once
+    uint32_t mealCount;
+    if (!header.number(mealCount)) {
+        error = "Error reading meal table";
+        return true;
+    }
+    meals.reserve(min<size_t>(mealCount, text.size() / 2));
+    for (uint32_t k = 0; k < mealCount; k++) {
+        LoadedMeal meal{(uint32_t)mealItems.size(), 0};
+        if (!header.number(meal.size)) {
+            error = "Error reading meal table";
+            return true;
+        }
+        for (uint32_t i = 0; i < meal.size; i++) {
+            LoadedItem item;
+            if (!header.number(item.code) || !header.number(item.cents) || item.code < 0 || item.code >= 17) {
+                error = "Error reading meal";
+                return true;
+            }
+            mealItems.push_back(item);
+        }
+        meals.push_back(meal);
+    }
+
+    const char* begin = header.at;
+    const char* end = text.data() + text.size();
+    threads = max(1, min<int>(threads, (end - begin) / MIN_CHUNK_BYTES));
+
+    // Cuts at record boundaries near equal shares; a cut that runs into the next one merges the chunks
+    vector<const char*> cuts{begin};
+    for (int k = 1; k < threads; k++) {
+        const char* cut = recordStart(max(begin + (end - begin) * k / threads, cuts.back() + 1), end);
+        if (cut < end) {
+            cuts.push_back(cut);
+        }
+    }
+    cuts.push_back(end);
+
+    chunks.resize(cuts.size() - 1);
+    vector<thread> workers;
+    for (size_t k = 1; k < chunks.size(); k++) {
+        workers.emplace_back([this, &cuts, k] { parseChunk(cuts[k], cuts[k + 1], chunks[k]); });
+    }
+    parseChunk(cuts[0], cuts[1], chunks[0]);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    return true;
+}
+
+/**
+ * Retrieves the number of orders parsed.
+ *
+ * @return The orders of every chunk.
+ */
+size_t StateLoader::orderCount() const{
+    size_t count = 0;
+    for (const LoadedChunk& chunk : chunks) {
+        count += chunk.orders.size();
+    }
+    return count;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file StateLoader.h
+ * @brief Defines the StateLoader class, which parses a state file in chunks on several threads.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_STATELOADER_H
+#define RESTAURANTREAL_STATELOADER_H
+
+#include <cstdint>
+#include <ctime>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+/**
+ * One item of a loaded meal, as written in the state file.
+ */
+struct LoadedItem {
+    int code; // FOOD code
+    int32_t cents; // Price the item was charged
+};
+
+/**
+ * One meal of the state file's meal table, before it is interned.
+ */
+struct LoadedMeal {
+    uint32_t firstItem; // Position of the meal's first item in the loader's mealItems
+    uint32_t size;
+};
+
+/**
+ * One order as written in the state file, before it is built.
+ */
+struct LoadedOrder {
+    int orderID;
+    uint32_t nameID; // Position in the file's name table
+    int type;
+    int skipCount;
+    int status;
+    time_t promisedTime;
+    long discountCents;
+    int feePercent;
+    uint32_t mealID; // Position in the file's meal table
+};
+
+/**
+ * The orders of one chunk of a state file, in file order.
+ */
+struct LoadedChunk {
+    vector<LoadedOrder> orders;
+    bool ascending = true; // Whether the IDs of the chunk only go up
+    string error; // Why parsing stopped before the end of the chunk, empty if it did not
+};
+
+/**
+ * @class StateLoader
+ * @brief Reads a whole state file into memory and parses its orders on a pool of threads.
+ *
+ * The header, the name table and the meal table are parsed first. Each distinct meal is written once,
+ * as a count and that many code and price pairs, and orders refer to it by ID. The orders after the
+ * tables are cut into one chunk per thread at line starts, since every order is a line of nine numbers.
+ * Each thread parses its chunk into plain records without touching anything shared, and the chunks are
+ * handed back in file order for the system to build its orders. Parsing within a chunk is token based
+ * like the stream reader, so only the cuts depend on the line layout; a file without it loads as a
+ * single chunk.
+ */
+class StateLoader {
+    private:
+        string text; // The whole file; names view into it
+
+        /**
+         * Parses the orders of one chunk of the file.
+         */
+        void parseChunk(const char* begin, const char* end, LoadedChunk& chunk) const;
+
+        /**
+         * Finds the start of the first order at or after a position.
+         */
+        static const char* recordStart(const char* at, const char* end);
+
+    public:
+        int currentOrderIndex = 0; // Current order index saved in the header
+        int nextID = 0; // Next order ID saved in the header
+        vector<string_view> names; // Name table of the file, viewing text
+        vector<LoadedMeal> meals; // Meal table of the file
+        vector<LoadedItem> mealItems; // Items of every meal of the meal table
+        vector<LoadedChunk> chunks; // Parsed orders, chunk by chunk in file order
+        string error; // Why the meal table could not be read, empty if it could
+
+        /**
+         * Reads and parses a state file.
+         *
+         * @param input The state file, read from its current position to the end.
+         * @param threads Number of threads to parse with, at least one.
+         * @return False if the file has no header, as when it is empty.
+         * A meal table that cannot be read leaves error set and no orders.
+         */
+        bool read(istream& input, int threads);
+
+        /**
+         * Retrieves the number of orders parsed.
+         *
+         * @return The orders of every chunk.
+         */
+        size_t orderCount() const;
+};
+
+#endif //RESTAURANTREAL_STATELOADER_H
@@ -0,0 +1,272 @@
+/**
+ * @file StoreShards.cpp
+ * @brief This file contains the StoreShards class, the shards of a multi-store process.
+ * @author Edward Villano
+ */
+
+#include "StoreShards.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <latch>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+
+/**
+ * Destructor for the StoreShards class.
+ * Stops every shard.
+ */
+StoreShards::~StoreShards(){
+    stop();
+}
+
+/**
+ * Reads a stores file, one store per line: name, state file, then optionally history
+ * directory, menu file and pricing rules file, with - for none. # starts a comment.
+ *
+ * @param path The stores file.
+ * @param stores Receives the stores.
+ * @return False if the file cannot be read or lists no store.
+ */
+bool StoreShards::loadStores(const string& path, vector<StoreConfig>& stores){
+    ifstream input(path);
+    if (!input) {
+        cerr << "Stores file " << path << " not found" << endl;
+        return false;
+    }
+
+    string line;
+    for (int number = 1; getline(input, line); number++) {
+        line = line.substr(0, line.find('#'));
+        istringstream fields(line);
+        string values[5];
+        int count = 0;
+        while (count < 5 && fields >> values[count]) {
+            count += 1;
+        }
+        if (count == 0) {
+            continue;
+        }
+        if (count < 2) {
+            cerr << "Store on line " << number << " of " << path << " has no state file" << endl;
+            return false;
+        }
+        for (string& value : values) {
+            if (value == "-") {
+                value.clear();
+            }
+        }
+
+        auto sameName = [&](const StoreConfig& store) { return store.name == values[0]; };
+        if (any_of(stores.begin(), stores.end(), sameName)) {
+            cerr << "Store " << values[0] << " is listed twice in " << path << endl;
+            return false;
+        }
+        stores.push_back(StoreConfig{values[0], values[1], values[2], values[3], values[4], ""});
+    }
+    return !stores.empty();
+}
+
+/**
+ * Builds a shard's store on the shard's own thread, then runs its inbox until the shard stops.
+ * Building it here means the store's memory is first touched on the core that will use it.
+ *
+ * @param shard The shard.
+ * @param core Core to pin the thread to, or -1 to leave it unpinned.
+ * @param loaded Counted down once the store's files are loaded.
+ */
+void StoreShards::run(Shard& shard, int core, latch& loaded){
+    if (core >= 0) {
+        cpu_set_t cores;
+        CPU_ZERO(&cores);
+        CPU_SET(core, &cores);
+        pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores);
+    }
+
+    const StoreConfig& config = shard.config;
+    RestaurantSystem system(config.boardName);
+    system.setEcho(false);
+    if (!config.menuPath.empty()) {
+        system.loadMenu(config.menuPath);
+    }
+    if (!config.rulesPath.empty()) {
+        system.loadPricingRules(config.rulesPath);
+    }
+    if (!config.historyPath.empty()) {
+        system.openHistory(config.historyPath);
+    }
+    // The stores load side by side, so each parses its own file on its own thread
+    ifstream input(config.statePath);
+    system.fileRead(input, 1);
+    input.close();
+    loaded.count_down();
+
+    vector<function<void(RestaurantSystem&)>> batch;
+    auto nextTick = chrono::steady_clock::now();
+    while (true) {
+        {
+            unique_lock<mutex> guard(shard.lock);
+            shard.wake.wait_until(guard, nextTick, [&] { return shard.stopping || !shard.inbox.empty(); });
+            if (shard.stopping && shard.inbox.empty()) {
+                break;
+            }
+            swap(batch, shard.inbox);
+        }
+
+        for (function<void(RestaurantSystem&)>& task : batch) {
+            task(system);
+        }
+        batch.clear();
+
+        if (chrono::steady_clock::now() >= nextTick) {
+            system.tick();
+            nextTick = chrono::steady_clock::now() + chrono::seconds(1);
+        }
+    }
+}
+
+/**
+ * Starts a shard for every store and waits until all of them have loaded their files.
+ * Shards are pinned to cores round robin, so with at least as many cores as stores each has its own.
+ *
+ * @param stores The stores to host.
+ * @param pin Whether to pin each shard's thread to a core.
+ */
+void StoreShards::start(const vector<StoreConfig>& stores, bool pin){
+    int cores = max(1u, thread::hardware_concurrency());
+    latch loaded(stores.size());
+
+    for (size_t k = 0; k < stores.size(); k++) {
+        shards.push_back(make_unique<Shard>());
+        Shard& shard = *shards.back();
+        shard.config = stores[k];
+        if (shard.config.boardName.empty()) {
+            string name = shard.config.name;
+            replace(name.begin(), name.end(), '/', '_');
+            shard.config.boardName = string(BOARD_SHM_NAME) + "-" + name;
+        }
+        shard.worker = thread(run, ref(shard), pin ? (int)(k % cores) : -1, ref(loaded));
+    }
+    loaded.wait();
+}
+
+/**
+ * Stops every shard once the work already posted to it is done.
+ */
+void StoreShards::stop(){
+    for (unique_ptr<Shard>& shard : shards) {
+        lock_guard<mutex> guard(shard->lock);
+        shard->stopping = true;
+        shard->wake.notify_one();
+    }
+    for (unique_ptr<Shard>& shard : shards) {
+        shard->worker.join();
+    }
+    shards.clear();
+}
+
+/**
+ * Retrieves the number of stores.
+ *
+ * @return The number of shards.
+ */
+size_t StoreShards::size() const{
+    return shards.size();
+}
+
+/**
+ * Retrieves the name of a store.
+ *
+ * @param store Position of the store.
+ * @return The store's name.
+ */
+const string& StoreShards::storeName(size_t store) const{
+    return shards[store]->config.name;
+}
+
+/**
+ * Queues work for a store. It runs later on the store's thread, after the work queued before it.
+ * The worker is only woken when the inbox was empty; otherwise it is already awake or about to be.
+ *
+ * @param store Position of the store.
+ * @param task The work, given the store's system.
+ */
+void StoreShards::post(size_t store, function<void(RestaurantSystem&)> task){
+    Shard& shard = *shards[store];
+    bool wasEmpty;
+    {
+        lock_guard<mutex> guard(shard.lock);
+        wasEmpty = shard.inbox.empty();
+        shard.inbox.push_back(std::move(task));
+    }
+    if (wasEmpty) {
+        shard.wake.notify_one();
+    }
+}
+
+/**
+ * Runs work on a store's thread and waits for it to finish.
+ *
+ * @param store Position of the store.
+ * @param task The work, given the store's system.
+ */
+void StoreShards::call(size_t store, const function<void(RestaurantSystem&)>& task){
+    latch done(1);
+    post(store, [&](RestaurantSystem& system) {
+        task(system);
+        done.count_down();
+    });
+    done.wait();
+}
+
+/**
+ * Asks every store for its report at once and waits for all of them.
+ *
+ * @return The reports in store order.
+ */
+vector<StoreReport> StoreShards::report(){
+    vector<StoreReport> reports(shards.size());
+    latch done(shards.size());
+    for (size_t k = 0; k < shards.size(); k++) {
+        post(k, [&reports, &done, k](RestaurantSystem& system) {
+            reports[k] = system.report();
+            done.count_down();
+        });
+    }
+    done.wait();
+    return reports;
+}
+
+/**
+ * Has every store with a state file write a snapshot of it at once, and waits for all of them.
+ * Each file is written beside the old one and renamed over it, so a store never has half a file.
+ *
+ * @return The number of snapshots written.
+ */
+int StoreShards::snapshot(){
+    atomic<int> written{0};
+    latch done(shards.size());
+    for (size_t k = 0; k < shards.size(); k++) {
+        string path = shards[k]->config.statePath;
+        post(k, [path, &written, &done](RestaurantSystem& system) {
+            if (!path.empty()) {
+                string temporary = path + ".tmp";
+                ofstream output(temporary);
+                system.fileWrite(output);
+                output.close();
+                if (output && rename(temporary.c_str(), path.c_str()) == 0) {
+                    written.fetch_add(1);
+                } else {
+                    cerr << "Could not write snapshot " << path << endl;
+                }
+            }
+            done.count_down();
+        });
+    }
+    done.wait();
+    return written.load();
+}
@@ -0,0 +1,151 @@
+/**
+ * @file StoreShards.h
+ * @brief Defines the StoreShards class, which hosts one RestaurantSystem per store in one process,
+ *        each on a worker thread of its own.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_STORESHARDS_H
+#define RESTAURANTREAL_STORESHARDS_H
+
+#include <condition_variable>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RestaurantSystem.h"
+
+using namespace std;
+
+/**
+ * Files and names of one store.
+ */
+struct StoreConfig {
+    string name;
+    string statePath; // State file read at start and written by snapshots, empty for none
+    string historyPath; // History directory orders are archived in, empty for none
+    string menuPath; // Menu file, empty for the built in menu
+    string rulesPath; // Pricing rules file, empty for none
+    string boardName; // Shared-memory order board, /pos_board-<name> if empty
+};
+
+/**
+ * @class StoreShards
+ * @brief Runs several stores in one process, one shard per store.
+ *
+ * A shard owns its store's RestaurantSystem, built on and only ever touched by the shard's worker
+ * thread, which is pinned to a core of its own where there are enough. Everything a store does
+ * happens on that thread, so the stores share no state and need no locks between them. Work reaches
+ * a shard through its inbox; the worker takes everything queued in one swap and runs it as a batch,
+ * then ticks the store's timers at most once a second.
+ *
+ * The only messages across shards are the consolidated ones: a report asks every shard for its
+ * StoreReport and a snapshot has every shard write its own state file, all at the same time.
+ */
+class StoreShards {
+    private:
+        /**
+         * One store and the thread it runs on.
+         */
+        struct Shard {
+            StoreConfig config;
+            thread worker;
+            mutex lock; // Guards inbox and stopping
+            condition_variable wake; // Signalled when work arrives or the shard stops
+            vector<function<void(RestaurantSystem&)>> inbox; // Work not yet taken by the worker
+            bool stopping = false;
+        };
+
+        vector<unique_ptr<Shard>> shards;
+
+        /**
+         * Builds a shard's store and runs its inbox until it stops.
+         */
+        static void run(Shard& shard, int core, latch& loaded);
+
+    public:
+        StoreShards() = default;
+
+        /**
+         * Destructor for the StoreShards class.
+         * Stops every shard.
+         */
+        ~StoreShards();
+
+        StoreShards(const StoreShards&) = delete;
+        StoreShards& operator=(const StoreShards&) = delete;
+
+        /**
+         * Reads a stores file, one store per line: name, state file, then optionally history
+         * directory, menu file and pricing rules file, with - for none. # starts a comment.
+         *
+         * @param path The stores file.
+         * @param stores Receives the stores.
+         * @return False if the file cannot be read or lists no store.
+         */
+        static bool loadStores(const string& path, vector<StoreConfig>& stores);
+
+        /**
+         * Starts a shard for every store and waits until all of them have loaded their files.
+         *
+         * @param stores The stores to host.
+         * @param pin Whether to pin each shard's thread to a core.
+         */
+        void start(const vector<StoreConfig>& stores, bool pin = true);
+
+        /**
+         * Stops every shard once the work already posted to it is done.
+         */
+        void stop();
+
+        /**
+         * Retrieves the number of stores.
+         *
+         * @return The number of shards.
+         */
+        size_t size() const;
+
+        /**
+         * Retrieves the name of a store.
+         *
+         * @param store Position of the store.
+         * @return The store's name.
+         */
+        const string& storeName(size_t store) const;
+
+        /**
+         * Queues work for a store. It runs later on the store's thread, after the work queued before it.
+         *
+         * @param store Position of the store.
+         * @param task The work, given the store's system.
+         */
+        void post(size_t store, function<void(RestaurantSystem&)> task);
+
+        /**
+         * Runs work on a store's thread and waits for it to finish.
+         *
+         * @param store Position of the store.
+         * @param task The work, given the store's system.
+         */
+        void call(size_t store, const function<void(RestaurantSystem&)>& task);
+
+        /**
+         * Asks every store for its report at once and waits for all of them.
+         *
+         * @return The reports in store order.
+         */
+        vector<StoreReport> report();
+
+        /**
+         * Has every store with a state file write a snapshot of it at once, and waits for all of them.
+         * Each file is written beside the old one and renamed over it, so a store never has half a file.
+         *
+         * @return The number of snapshots written.
+         */
+        int snapshot();
+};
+
+#endif //RESTAURANTREAL_STORESHARDS_H
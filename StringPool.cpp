@@ -0,0 +1,97 @@
+/**
+ * @file StringPool.cpp
+ * @brief This file contains the StringPool class, which interns strings into arena chunks.
+ * @author Edward Villano
+ */
+
+#include "StringPool.h"
+#include <cstring>
+
+/**
+ * Copies bytes into the arena.
+ * Strings longer than a chunk get a chunk of their own, kept behind the chunk being filled,
+ * so the next strings still go into the room left in that one.
+ *
+ * @param text The bytes to store.
+ * @return A view of the stored copy.
+ */
+string_view StringPool::store(string_view text){
+    if (text.size() > CHUNK_SIZE) {
+        unique_ptr<char[]> own = make_unique<char[]>(text.size());
+        memcpy(own.get(), text.data(), text.size());
+        string_view stored(own.get(), text.size());
+        bytesReserved += text.size();
+        // With no chunk yet, chunkUsed is a full chunk, so the next string starts a new one
+        chunks.insert(chunks.empty() ? chunks.end() : chunks.end() - 1, std::move(own));
+        return stored;
+    }
+    if (chunks.empty() || text.size() > CHUNK_SIZE - chunkUsed) {
+        chunks.push_back(make_unique<char[]>(CHUNK_SIZE));
+        bytesReserved += CHUNK_SIZE;
+        chunkUsed = 0;
+    }
+    char* copy = chunks.back().get() + chunkUsed;
+    memcpy(copy, text.data(), text.size());
+    chunkUsed += text.size();
+    return string_view(copy, text.size());
+}
+
+/**
+ * Returns the ID of a string, storing it first if it is not in the pool yet.
+ *
+ * @param text The string to intern.
+ * @return The string's ID.
+ */
+uint32_t StringPool::intern(string_view text){
+    auto it = ids.find(text);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    uint32_t id = strings.size();
+    string_view stored = store(text);
+    strings.push_back(stored);
+    ids.emplace(stored, id);
+    return id;
+}
+
+/**
+ * Retrieves an interned string.
+ *
+ * @param id The string's ID.
+ * @return A view of the string, valid until the pool is cleared.
+ */
+string_view StringPool::get(uint32_t id){
+    return strings[id];
+}
+
+/**
+ * Retrieves the number of distinct strings in the pool.
+ *
+ * @return The number of interned strings.
+ */
+uint32_t StringPool::size(){
+    return strings.size();
+}
+
+/**
+ * Retrieves the memory held by the pool, including its lookup table.
+ *
+ * @return The approximate footprint in bytes.
+ */
+size_t StringPool::bytesUsed(){
+    return bytesReserved + strings.capacity() * sizeof(string_view)
+           + ids.size() * (sizeof(string_view) + sizeof(uint32_t) + 2 * sizeof(void*))
+           + ids.bucket_count() * sizeof(void*);
+}
+
+/**
+ * Releases every string at once. All views and IDs become invalid.
+ */
+void StringPool::clear(){
+    chunks.clear();
+    strings.clear();
+    ids.clear();
+    chunkUsed = CHUNK_SIZE;
+    bytesReserved = 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file StringPool.h
+ * @brief Defines the StringPool class, an arena-backed intern table for customer names.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_STRINGPOOL_H
+#define RESTAURANTREAL_STRINGPOOL_H
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @class StringPool
+ * @brief Stores each distinct string once in large arena chunks and hands out stable IDs and views.
+ *
+ * Views stay valid until the pool is cleared, because chunks are never moved or freed individually.
+ * A shift's names are released all at once by clear().
+ */
+class StringPool {
+    private:
+        static constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+        vector<unique_ptr<char[]>> chunks; // Arena chunks holding the string bytes
+        size_t chunkUsed = CHUNK_SIZE; // Bytes used in the last chunk
+        size_t bytesReserved = 0; // Bytes allocated for chunks
+        vector<string_view> strings; // Interned strings by ID
+        unordered_map<string_view, uint32_t> ids; // IDs by interned string
+
+        /**
+         * Copies bytes into the arena.
+         *
+         * @return A view of the stored copy.
+         */
+        string_view store(string_view text);
+
+    public:
+        /**
+         * Returns the ID of a string, storing it first if it is not in the pool yet.
+         *
+         * @param text The string to intern.
+         * @return The string's ID.
+         */
+        uint32_t intern(string_view text);
+
+        /**
+         * Retrieves an interned string.
+         *
+         * @param id The string's ID.
+         * @return A view of the string, valid until the pool is cleared.
+         */
+        string_view get(uint32_t id);
+
+        /**
+         * Retrieves the number of distinct strings in the pool.
+         *
+         * @return The number of interned strings.
+         */
+        uint32_t size();
+
+        /**
+         * Retrieves the memory held by the pool, including its lookup table.
+         *
+         * @return The approximate footprint in bytes.
+         */
+        size_t bytesUsed();
+
+        /**
+         * Releases every string at once. All views and IDs become invalid.
+         */
+        void clear();
+};
+
+#endif //RESTAURANTREAL_STRINGPOOL_H
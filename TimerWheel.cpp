@@ -0,0 +1,184 @@
+/**
+ * @file TimerWheel.cpp
+ * @brief This file contains the TimerWheel class, a hierarchical timer wheel with O(1)
+ *        arming and cancelling of per-order timers.
+ * @author Edward Villano
+ */
+
+#include "TimerWheel.h"
+#include "ShiftClock.h"
+#include <algorithm>
+
+/**
+ * Constructor for the TimerWheel class.
+ * Starts the wheel at the current time with every slot empty.
+ */
+TimerWheel::TimerWheel(){
+    fill(begin(heads), end(heads), -1);
+    current = ShiftClock::now();
+}
+
+/**
+ * Links a node into the slot matching its expiry.
+ * Timers already due go into the slot of the current tick.
+ *
+ * @param index Node to link.
+ */
+void TimerWheel::link(int index){
+    Node& node = nodes[index];
+    time_t when = max(node.expiry, current);
+    time_t delta = when - current;
+
+    int slot;
+    if (delta < SLOTS) {
+        slot = when & (SLOTS - 1);
+    } else if (delta < (time_t)SLOTS << SLOT_BITS) {
+        slot = SLOTS + ((when >> SLOT_BITS) & (SLOTS - 1));
+    } else if (delta < (time_t)SLOTS << (2 * SLOT_BITS)) {
+        slot = 2 * SLOTS + ((when >> (2 * SLOT_BITS)) & (SLOTS - 1));
+    } else {
+        // Beyond the wheel's span: park in the top slot that comes around last
+        slot = 2 * SLOTS + (((current >> (2 * SLOT_BITS)) + SLOTS - 1) & (SLOTS - 1));
+    }
+
+    node.slot = slot;
+    node.prev = -1;
+    node.next = heads[slot];
+    if (heads[slot] >= 0) {
+        nodes[heads[slot]].prev = index;
+    }
+    heads[slot] = index;
+}
+
+/**
+ * Unlinks a node from its slot.
+ *
+ * @param index Node to unlink.
+ */
+void TimerWheel::unlink(int index){
+    Node& node = nodes[index];
+    if (node.prev >= 0) {
+        nodes[node.prev].next = node.next;
+    } else {
+        heads[node.slot] = node.next;
+    }
+    if (node.next >= 0) {
+        nodes[node.next].prev = node.prev;
+    }
+    node.slot = -1;
+}
+
+/**
+ * Re-links every node of a coarse slot into finer slots.
+ * Called when the current tick enters the range covered by that slot.
+ *
+ * @param level Level whose slot for the current tick is cascaded.
+ */
+void TimerWheel::cascade(int level){
+    int slot = level * SLOTS + ((current >> (level * SLOT_BITS)) & (SLOTS - 1));
+    int index = heads[slot];
+    heads[slot] = -1;
+
+    while (index >= 0) {
+        int next = nodes[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+/**
+ * Arms a timer for an order.
+ * Takes a node from the free list, or grows the pool when none is free.
+ *
+ * @param expiry Time the timer should fire.
+ * @param orderID Order the timer belongs to.
+ * @param kind What the timer guards.
+ * @return Handle used to cancel the timer.
+ */
+int TimerWheel::arm(time_t expiry, int orderID, TimerKind kind){
+    int index;
+    if (freeList >= 0) {
+        index = freeList;
+        freeList = nodes[index].next;
+    } else {
+        index = static_cast<int>(nodes.size());
+        nodes.push_back(Node());
+    }
+
+    // Never fire inside the tick that has already been processed
+    nodes[index].expiry = max(expiry, current + 1);
+    nodes[index].orderID = orderID;
+    nodes[index].kind = kind;
+    link(index);
+    armed += 1;
+    return index;
+}
+
+/**
+ * Cancels an armed timer and returns its node to the free list.
+ *
+ * @param handle Handle returned by arm; -1 is ignored.
+ */
+void TimerWheel::cancel(int handle){
+    if (handle < 0 || handle >= nodes.size() || nodes[handle].slot < 0) {
+        return;
+    }
+    unlink(handle);
+    nodes[handle].next = freeList;
+    freeList = handle;
+    armed -= 1;
+}
+
+/**
+ * Advances the wheel to a time and collects every timer that expired on the way.
+ * Each tick first cascades the coarser slots that start at that tick, then fires
+ * the one second slot for the tick.
+ *
+ * @param now The time to advance to.
+ * @param fired Receives the expired timers in expiry order.
+ */
+void TimerWheel::advance(time_t now, vector<TimerEvent>& fired){
+    while (current < now) {
+        current += 1;
+
+        if ((current & ((1 << (2 * SLOT_BITS)) - 1)) == 0) {
+            cascade(2);
+        }
+        if ((current & (SLOTS - 1)) == 0) {
+            cascade(1);
+        }
+
+        int slot = current & (SLOTS - 1);
+        int index = heads[slot];
+        heads[slot] = -1;
+
+        while (index >= 0) {
+            int next = nodes[index].next;
+            fired.push_back(TimerEvent{nodes[index].orderID, nodes[index].kind});
+            nodes[index].slot = -1;
+            nodes[index].next = freeList;
+            freeList = index;
+            armed -= 1;
+            index = next;
+        }
+    }
+}
+
+/**
+ * Retrieves the number of outstanding timers.
+ *
+ * @return The number of armed timers.
+ */
+int TimerWheel::size(){
+    return armed;
+}
+
+/**
+ * Retrieves the memory held by the wheel, including its timer pool.
+ * Freed timers stay in the pool for the next ones armed.
+ *
+ * @return The approximate footprint in bytes.
+ */
+size_t TimerWheel::bytesUsed(){
+    return sizeof(heads) + nodes.capacity() * sizeof(Node);
+}
@@ -0,0 +1,126 @@
+/**
+ * @file TimerWheel.h
+ * @brief Defines the TimerWheel class, a hierarchical timer wheel used to raise per-order
+ *        service level alerts as time passes.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_TIMERWHEEL_H
+#define RESTAURANTREAL_TIMERWHEEL_H
+
+#include <vector>
+#include <ctime>
+
+using namespace std;
+
+/**
+ * Kinds of timers armed for an order.
+ */
+enum TimerKind {
+    PLACED_SLA, // Order has waited too long to start cooking
+    PICKUP_SLA  // Ready order has waited too long to be picked up
+};
+
+/**
+ * A timer that expired during TimerWheel::advance.
+ */
+struct TimerEvent {
+    int orderID; // Order the timer was armed for
+    TimerKind kind; // What the timer guards
+};
+
+/**
+ * @class TimerWheel
+ * @brief Three levels of 64 slots at one second, 64 second and 4096 second resolution.
+ *
+ * Timers live in a pooled array and are linked into their slot, so arming and cancelling are O(1)
+ * and a timer only moves down a level when its coarse slot comes due. Timers further out than
+ * the top level's span wait in its last slot and are cascaded again when it comes around.
+ */
+class TimerWheel {
+    private:
+        static const int SLOT_BITS = 6;
+        static const int SLOTS = 1 << SLOT_BITS;
+        static const int LEVELS = 3;
+
+        /**
+         * A timer in the pool; free nodes are chained through next.
+         */
+        struct Node {
+            time_t expiry; // Time the timer fires
+            int orderID; // Order the timer was armed for
+            TimerKind kind; // What the timer guards
+            int prev; // Previous node in the slot list, -1 at the head
+            int next; // Next node in the slot list or free list, -1 at the tail
+            int slot; // Slot the node is linked into, level * SLOTS + index, -1 when unlinked
+        };
+
+        vector<Node> nodes; // Timer pool
+        int freeList = -1; // First free node in the pool
+        int heads[LEVELS * SLOTS]; // First node of each slot list
+        time_t current = 0; // Time the wheel has advanced to
+        int armed = 0; // Number of outstanding timers
+
+        /**
+         * Links a node into the slot matching its expiry.
+         */
+        void link(int index);
+
+        /**
+         * Unlinks a node from its slot.
+         */
+        void unlink(int index);
+
+        /**
+         * Re-links every node of a coarse slot into finer slots.
+         */
+        void cascade(int level);
+
+    public:
+        /**
+         * Constructor for the TimerWheel class.
+         * Starts the wheel at the current time.
+         */
+        TimerWheel();
+
+        /**
+         * Arms a timer for an order.
+         *
+         * @param expiry Time the timer should fire.
+         * @param orderID Order the timer belongs to.
+         * @param kind What the timer guards.
+         * @return Handle used to cancel the timer.
+         */
+        int arm(time_t expiry, int orderID, TimerKind kind);
+
+        /**
+         * Cancels an armed timer.
+         *
+         * @param handle Handle returned by arm; -1 is ignored.
+         */
+        void cancel(int handle);
+
+        /**
+         * Advances the wheel to a time and collects every timer that expired on the way.
+         *
+         * @param now The time to advance to.
+         * @param fired Receives the expired timers in expiry order.
+         */
+        void advance(time_t now, vector<TimerEvent>& fired);
+
+        /**
+         * Retrieves the number of outstanding timers.
+         *
+         * @return The number of armed timers.
+         */
+        int size();
+
+        /**
+         * Retrieves the memory held by the wheel, including its timer pool.
+         *
+         * @return The approximate footprint in bytes.
+         */
+        size_t bytesUsed();
+};
+
+#endif //RESTAURANTREAL_TIMERWHEEL_H
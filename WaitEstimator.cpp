@@ -0,0 +1,122 @@
+/**
+ * @file WaitEstimator.cpp
+ * @brief This file contains the WaitEstimator class, which quotes order wait times from
+ *        incrementally maintained queue aggregates.
+ * @author Edward Villano
+ */
+
+#include "WaitEstimator.h"
+#include "ShiftClock.h"
+#include <algorithm>
+
+// Weight of the newest throughput sample in the moving average
+const double throughputSmoothing = 0.2;
+
+// Throughput samples are clamped so one odd completion cannot swing the quotes
+const double minWorkRate = 0.25;
+const double maxWorkRate = 8.0;
+
+/**
+ * Records a newly placed order as queued work.
+ *
+ * @param order The order that was placed.
+ */
+void WaitEstimator::orderPlaced(Order& order){
+    queuedOrders[order.getOrderType()] += 1;
+    queuedWork[order.getOrderType()] += order.getPrepTime();
+}
+
+/**
+ * Moves an order's work from its queue into the kitchen.
+ *
+ * @param order The order that was dispatched.
+ */
+void WaitEstimator::orderDispatched(Order& order){
+    int prepTime = order.getPrepTime();
+
+    queuedOrders[order.getOrderType()] -= 1;
+    queuedWork[order.getOrderType()] -= prepTime;
+    cookingWork += prepTime;
+    cooking[order.getOrderID()] = Dispatch{ShiftClock::now(), prepTime};
+}
+
+/**
+ * Removes a completed order's work from the kitchen and updates the throughput.
+ * The throughput sample is the order's expected work over the time since the previous completion,
+ * or since its dispatch when the kitchen was idle.
+ *
+ * @param order The order that was completed.
+ */
+void WaitEstimator::orderCompleted(Order& order){
+    auto it = cooking.find(order.getOrderID());
+    if (it == cooking.end()){
+        return;
+    }
+
+    time_t now = ShiftClock::now();
+    time_t since = max(it->second.dispatchedTime, lastCompletion);
+    double elapsed = max<double>(1.0, difftime(now, since));
+    double sample = clamp(it->second.prepTime / elapsed, minWorkRate, maxWorkRate);
+
+    workRate = (1.0 - throughputSmoothing) * workRate + throughputSmoothing * sample;
+    lastCompletion = now;
+    cookingWork -= it->second.prepTime;
+    cooking.erase(it);
+}
+
+/**
+ * Removes a cancelled order's work from its queue.
+ *
+ * @param order The order that was cancelled.
+ */
+void WaitEstimator::orderCancelled(Order& order){
+    queuedOrders[order.getOrderType()] -= 1;
+    queuedWork[order.getOrderType()] -= order.getPrepTime();
+}
+
+/**
+ * Adjusts a placed order's queued work after its meal was edited.
+ *
+ * @param order The edited order.
+ * @param prepTimeBefore The order's preparation time before the edit.
+ */
+void WaitEstimator::orderEdited(Order& order, int prepTimeBefore){
+    queuedWork[order.getOrderType()] += order.getPrepTime() - prepTimeBefore;
+}
+
+/**
+ * Quotes the wait for a new order of the given type.
+ * Types are served DRIVE_THROUGH first through DOORDASH last, so only work queued
+ * at the same or a higher priority is ahead of the new order.
+ *
+ * @param type The type of the new order.
+ * @param prepTime Expected preparation time of the new order in seconds.
+ * @return The quoted wait in seconds.
+ */
+int WaitEstimator::quote(OrderType type, int prepTime){
+    int workAhead = cookingWork + prepTime;
+    for (int t = DRIVE_THROUGH; t <= type; t++){
+        workAhead += queuedWork[t];
+    }
+    return static_cast<int>(workAhead / workRate);
+}
+
+/**
+ * Retrieves the number of placed orders waiting for a type.
+ *
+ * @param type The order type to look up.
+ * @return The number of queued orders.
+ */
+int WaitEstimator::getQueuedOrders(OrderType type){
+    return queuedOrders[type];
+}
+
+/**
+ * Retrieves the memory held by the estimator's table of cooking orders.
+ *
+ * @return The approximate footprint in bytes.
+ */
+size_t WaitEstimator::bytesUsed(){
+    return cooking.size() * (sizeof(int) + sizeof(Dispatch) + 2 * sizeof(void*))
+           + cooking.bucket_count() * sizeof(void*);
+}
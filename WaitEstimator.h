@@ -0,0 +1,105 @@
+/**
+ * @file WaitEstimator.h
+ * @brief Defines the WaitEstimator class, which keeps running queue aggregates so wait times
+ *        can be quoted at order placement without scanning the orders list.
+ * @author Edward Villano
+ */
+
+#ifndef RESTAURANTREAL_WAITESTIMATOR_H
+#define RESTAURANTREAL_WAITESTIMATOR_H
+
+#include <unordered_map>
+#include <ctime>
+#include "Order.h"
+
+using namespace std;
+
+/**
+ * @class WaitEstimator
+ * @brief Maintains queued work per order type, work in the kitchen and recent kitchen throughput.
+ *
+ * Every update and every quote is O(1); the estimator is told about each place, dispatch,
+ * complete and cancel instead of inspecting the queue.
+ */
+class WaitEstimator {
+    private:
+        /**
+         * Book-keeping for an order that is currently cooking.
+         */
+        struct Dispatch {
+            time_t dispatchedTime; // Time the order was sent to the kitchen
+            int prepTime; // Expected preparation time of the order in seconds
+        };
+
+        int queuedOrders[4] = {}; // Placed orders waiting per OrderType
+        int queuedWork[4] = {}; // Expected preparation seconds waiting per OrderType
+        int cookingWork = 0; // Expected preparation seconds currently in the kitchen
+        unordered_map<int, Dispatch> cooking; // Orders currently in the kitchen, keyed by order ID
+        double workRate = 1.0; // Recent throughput in expected seconds of work completed per second
+        time_t lastCompletion = 0; // Time the kitchen last completed an order
+
+    public:
+        /**
+         * Records a newly placed order as queued work.
+         *
+         * @param order The order that was placed.
+         */
+        void orderPlaced(Order& order);
+
+        /**
+         * Moves an order's work from its queue into the kitchen.
+         *
+         * @param order The order that was dispatched.
+         */
+        void orderDispatched(Order& order);
+
+        /**
+         * Removes a completed order's work from the kitchen and updates the throughput.
+         *
+         * @param order The order that was completed.
+         */
+        void orderCompleted(Order& order);
+
+        /**
+         * Removes a cancelled order's work from its queue.
+         *
+         * @param order The order that was cancelled.
+         */
+        void orderCancelled(Order& order);
+
+        /**
+         * Adjusts a placed order's queued work after its meal was edited.
+         *
+         * @param order The edited order.
+         * @param prepTimeBefore The order's preparation time before the edit.
+         */
+        void orderEdited(Order& order, int prepTimeBefore);
+
+        /**
+         * Quotes the wait for a new order of the given type.
+         * Counts the work queued at the same or higher priority plus the work already cooking,
+         * scaled by the recent throughput of the kitchen.
+         *
+         * @param type The type of the new order.
+         * @param prepTime Expected preparation time of the new order in seconds.
+         * @return The quoted wait in seconds.
+         */
+        int quote(OrderType type, int prepTime);
+
+        /**
+         * Retrieves the number of placed orders waiting for a type.
+         *
+         * @param type The order type to look up.
+         * @return The number of queued orders.
+         */
+        int getQueuedOrders(OrderType type);
+
+        /**
+         * Retrieves the memory held by the estimator's table of cooking orders.
+         *
+         * @return The approximate footprint in bytes.
+         */
+        size_t bytesUsed();
+};
+
+#endif //RESTAURANTREAL_WAITESTIMATOR_H
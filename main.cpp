@@ -6,6 +6,7 @@
  */
 #include <iostream>
 #include <fstream>
+#include <cstdlib>
 #include "OptionsMenu.h"
 
 using namespace std;
@@ -17,27 +18,90 @@ using namespace std;
  * @return The result of program execution
  */
 int main(int argc, char** argv) {
-    string inputFilePath, outputFilePath, s;
+    string inputFilePath, outputFilePath, kitchenDisplayPath, pricingRulesPath, menuPath, historyPath, storesPath,
+           leaderPath, followPath, tracePath, s;
+    double budgetMegabytes = 0;
     for (int i = 0; i < argc ; i++){
         s = argv[i];
         if (s == "-o"){
             outputFilePath = argv[i+1];
         } else if (s == "-i"){
             inputFilePath = argv[i+1];
+        } else if (s == "-k"){
+            kitchenDisplayPath = argv[i+1];
+        } else if (s == "-p"){
+            pricingRulesPath = argv[i+1];
+        } else if (s == "-m"){
+            menuPath = argv[i+1];
+        } else if (s == "-H"){
+            historyPath = argv[i+1];
+        } else if (s == "-S"){
+            storesPath = argv[i+1];
+        } else if (s == "-L"){
+            leaderPath = argv[i+1];
+        } else if (s == "-F"){
+            followPath = argv[i+1];
+        } else if (s == "-T"){
+            tracePath = argv[i+1];
+        } else if (s == "-M"){
+            budgetMegabytes = atof(argv[i+1]);
         }
     }
 
-    ifstream inputFile(inputFilePath);
+    if (!storesPath.empty()){
+        // One shard per store, each with the files listed for it, instead of the single store below
+        vector<StoreConfig> stores;
+        if (!StoreShards::loadStores(storesPath, stores)){
+            return 1;
+        }
+        StoreShards shards;
+        shards.start(stores);
+        cout << "\nRunning " << shards.size() << " stores from " << storesPath << "\n\n" << endl;
+        OptionsMenu::ProcessStores(shards);
+        return 0;
+    }
+
+    ifstream inputFile(followPath.empty() ? inputFilePath : "");
     ofstream outputFile(outputFilePath);
 
-    if(!inputFile){
-        cerr << "Input file not found" << endl;
+    if (!followPath.empty()){
+        cout << "\nFollowing the leader on: " << followPath << endl;
+    } else {
+        if(!inputFile){
+            cerr << "Input file not found" << endl;
+        }
+        cout << "\nInputting from: " << inputFilePath << endl;
     }
-    cout << "\nInputting from: " << inputFilePath << endl;
     cout << "Outputting to: " << outputFilePath << "\n\n\n" <<endl;
 
     OptionsMenu menu;
-    menu.ProcessChoice(inputFile, outputFile);
+    if (!menuPath.empty()){
+        menu.setMenu(menuPath);
+    }
+    if (!pricingRulesPath.empty()){
+        menu.setPricingRules(pricingRulesPath);
+    }
+    if (!historyPath.empty() && followPath.empty()){
+        menu.setHistory(historyPath);
+    }
+    if (!kitchenDisplayPath.empty()){
+        menu.setKitchenDisplay(kitchenDisplayPath);
+    }
+    if (!leaderPath.empty()){
+        menu.setLeader(leaderPath);
+    }
+    if (!tracePath.empty()){
+        menu.setTrace(tracePath);
+    }
+    if (budgetMegabytes > 0){
+        menu.setMemoryBudget(budgetMegabytes * 1024 * 1024);
+    }
+    if (!followPath.empty()){
+        // The orders come from the leader; the history opens if this terminal takes over
+        menu.ProcessFollower(followPath, historyPath, outputFile);
+    } else {
+        menu.ProcessChoice(inputFile, outputFile);
+    }
 
 
 
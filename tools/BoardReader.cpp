@@ -0,0 +1,191 @@
+/**
+ * @file BoardReader.cpp
+ * @brief Reader tool for the shared-memory order board published by the Restaurant Ordering System.
+ *        Prints the current board once, keeps refreshing it, or measures reader/writer contention.
+ *
+ *        Usage: BoardReader [-n shmName] [-w]
+ *               BoardReader -b seconds [-r readers] [-u writerUpdatesPerSecond]
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../BoardLayout.h"
+#include "../Order.h"
+
+using namespace std;
+
+/**
+ * Maps an existing board read-only.
+ * @param shmName The shared-memory object name
+ * @return The mapped board, or nullptr if it does not exist
+ */
+const BoardSegment* mapBoard(const string& shmName) {
+    int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    void* mapped = mmap(nullptr, sizeof(BoardSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+    const BoardSegment* board = static_cast<const BoardSegment*>(mapped);
+    if (board->header.magic != BOARD_MAGIC || board->header.version != BOARD_VERSION) {
+        munmap(mapped, sizeof(BoardSegment));
+        return nullptr;
+    }
+    return board;
+}
+
+/**
+ * Prints a snapshot of the board.
+ * @param snapshot The snapshot to print
+ */
+void printBoard(const BoardSegment& snapshot) {
+    char updated[32];
+    time_t updatedAt = snapshot.header.updatedAt;
+    strftime(updated, sizeof(updated), "%H:%M:%S", localtime(&updatedAt));
+
+    cout << "\n----NAME-----|--ID--|-----TYPE-----|-----STATUS-----" << endl;
+    for (uint32_t i = 0; i < snapshot.header.count; i++) {
+        const BoardEntry& entry = snapshot.entries[i];
+        cout << setw(12) << left << entry.name
+             << " | " << setw(4) << entry.orderID
+             << " | " << setw(12) << OrderTypeList[entry.type & 3]
+             << " | " << setw(16) << StatusList[entry.status & 3]
+             << ((entry.flags & BOARD_FLAG_COLD) ? " COLD" : "") << endl;
+    }
+    cout << snapshot.header.totalOrders << " orders, updated " << updated << endl;
+}
+
+/**
+ * Runs one writer thread rewriting a private board against a number of
+ * reader threads, and reports throughput and retry rates.
+ * @param seconds How long to run
+ * @param readers Number of reader threads
+ * @param updateRate Writer updates per second, 0 to write as fast as possible
+ */
+void benchmark(int seconds, int readers, int updateRate) {
+    BoardSegment* board = new BoardSegment();
+    board->header.magic = BOARD_MAGIC;
+    board->header.version = BOARD_VERSION;
+
+    atomic<bool> running{true};
+    atomic<uint64_t> writes{0};
+    vector<uint64_t> reads(readers, 0), retries(readers, 0);
+    vector<thread> threads;
+
+    threads.emplace_back([&]() {
+        uint64_t n = 0;
+        while (running.load(memory_order_relaxed)) {
+            boardBeginWrite(board);
+            for (int i = 0; i < BOARD_CAPACITY / 4; i++) {
+                board->entries[i].orderID = n + i;
+                board->entries[i].status = (n + i) & 3;
+            }
+            board->header.count = BOARD_CAPACITY / 4;
+            board->header.updatedAt = n;
+            boardEndWrite(board);
+            n += 1;
+            if (updateRate > 0) {
+                this_thread::sleep_for(chrono::microseconds(1000000 / updateRate));
+            }
+        }
+        writes.store(n);
+    });
+
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&, r]() {
+            BoardSegment* snapshot = new BoardSegment();
+            while (running.load(memory_order_relaxed)) {
+                retries[r] += boardReadSnapshot(board, snapshot);
+                reads[r] += 1;
+            }
+            delete snapshot;
+        });
+    }
+
+    this_thread::sleep_for(chrono::seconds(seconds));
+    running.store(false);
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    uint64_t totalReads = 0, totalRetries = 0;
+    for (int r = 0; r < readers; r++) {
+        totalReads += reads[r];
+        totalRetries += retries[r];
+    }
+
+    cout << fixed << setprecision(1);
+    cout << "Writer: " << writes.load() / (double)seconds << " updates/s" << endl;
+    cout << "Readers: " << readers << ", " << totalReads / (double)seconds << " snapshots/s, "
+         << (totalReads ? 1e9 * seconds * readers / totalReads : 0) << " ns/snapshot, "
+         << setprecision(2) << (totalReads ? (double)totalRetries / totalReads : 0) << " retries/snapshot" << endl;
+    delete board;
+}
+
+/**
+ * Function main begins with program execution
+ * @param argc The number of command line arguments
+ * @param argv The array of command line arguments
+ * @return The result of program execution
+ */
+int main(int argc, char** argv) {
+    string shmName = BOARD_SHM_NAME, s;
+    bool watch = false;
+    int benchSeconds = 0;
+    int readers = 1;
+    int updateRate = 0;
+
+    for (int i = 1; i < argc; i++) {
+        s = argv[i];
+        if (s == "-n" && i + 1 < argc) {
+            shmName = argv[++i];
+        } else if (s == "-w") {
+            watch = true;
+        } else if (s == "-b" && i + 1 < argc) {
+            benchSeconds = stoi(argv[++i]);
+        } else if (s == "-r" && i + 1 < argc) {
+            readers = stoi(argv[++i]);
+        } else if (s == "-u" && i + 1 < argc) {
+            updateRate = stoi(argv[++i]);
+        }
+    }
+
+    if (benchSeconds > 0) {
+        benchmark(benchSeconds, readers, updateRate);
+        return 0;
+    }
+
+    const BoardSegment* board = mapBoard(shmName);
+    if (board == nullptr) {
+        cerr << "Order board " << shmName << " not found" << endl;
+        return 1;
+    }
+
+    BoardSegment* snapshot = new BoardSegment();
+    uint64_t lastSequence = 1;
+    do {
+        boardReadSnapshot(board, snapshot);
+        uint64_t sequence = snapshot->header.sequence.load(memory_order_relaxed);
+        if (sequence != lastSequence) {
+            printBoard(*snapshot);
+            lastSequence = sequence;
+        }
+        if (watch) {
+            this_thread::sleep_for(chrono::milliseconds(250));
+        }
+    } while (watch);
+
+    delete snapshot;
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file BulkStatusBench.cpp
+ * @brief End of rush cleanup benchmark. Places a batch of orders and sends them all to the kitchen,
+ *        then moves every one of them from cooking to ready for pickup, either one order at a time as
+ *        the complete and pickup options do, or as one bulk transition by ID or by status filter.
+ *        The system leads a change log and archives to a history directory as a real terminal would,
+ *        so the journal costs are part of the time. Reports the time per batch, orders per second and
+ *        the change log entries written, and checks every mode ends in the same state.
+ *
+ *        Usage: BulkStatusBench [-n ordersPerBatch] [-r rounds]
+ *        Build: g++ -std=c++20 -O2 -I. tools/BulkStatusBench.cpp $(ls *.cpp | grep -v main.cpp)
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../RestaurantSystem.h"
+#include "../ShiftClock.h"
+
+using namespace std;
+
+static const char* const customers[4] = {"Ann", "Bob", "Carmen", "Dev"};
+static const char* const modeNames[3] = {"One at a time", "Bulk by ID", "Bulk by filter"};
+
+/**
+ * Result of moving one batch.
+ */
+struct BatchRun {
+    double seconds;
+    uint64_t changes; // Change log entries the move wrote
+    string state; // Checkpoint after the move, with the clock held
+};
+
+/**
+ * Fills a system with a batch of cooking orders, moves them all to ready for pickup the way a mode
+ * does, and times the move up to and including the tick that follows it.
+ */
+static BatchRun runBatch(int mode, long orders, const string& scratch){
+    string boardName = "/pos_board-bulkbench-" + to_string(getpid());
+    BatchRun run{};
+    {
+        RestaurantSystem system(boardName);
+        system.setEcho(false);
+        filesystem::remove_all(scratch + ".history");
+        system.openHistory(scratch + ".history");
+        system.lead(scratch + ".sock");
+
+        vector<int> ids;
+        for (long i = 0; i < orders; i++) {
+            vector<FOOD> items{static_cast<FOOD>(i % 17), static_cast<FOOD>((i * 7) % 17)};
+            system.submitOrder(customers[i % 4], static_cast<OrderType>(i % 4), items);
+        }
+        for (long i = 0; i < orders; i++) {
+            ids.push_back(system.cookNextOrder());
+        }
+        system.tick();
+
+        uint64_t changesBefore = system.lastChange();
+        auto start = chrono::steady_clock::now();
+        if (mode == 0) {
+            for (int id : ids) {
+                system.completeOrder(id);
+                system.readyOrder(id);
+            }
+        } else if (mode == 1) {
+            system.transitionOrders(ids, READY_FOR_PICKUP);
+        } else {
+            system.transitionMatching(COOKING, {}, READY_FOR_PICKUP);
+        }
+        system.tick();
+        run.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        run.changes = system.lastChange() - changesBefore;
+
+        ostringstream state;
+        system.writeCheckpoint(state);
+        run.state = state.str();
+    }
+    shm_unlink(boardName.c_str());
+    filesystem::remove_all(scratch + ".history");
+    remove((scratch + ".sock.lock").c_str());
+    return run;
+}
+
+int main(int argc, char* argv[]) {
+    long orders = 10000;
+    int rounds = 5;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:r:")) != -1) {
+        switch (option) {
+            case 'n':
+                orders = atol(optarg);
+                break;
+            case 'r':
+                rounds = atoi(optarg);
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n ordersPerBatch] [-r rounds]" << endl;
+                return 1;
+        }
+    }
+    if (orders < 1 || rounds < 1) {
+        cerr << "Orders and rounds must be positive" << endl;
+        return 1;
+    }
+
+    string scratch = "/tmp/bulk-bench-" + to_string(getpid());
+    cout << orders << " orders per batch, cooking to ready for pickup, best of " << rounds << " rounds" << endl;
+
+    // Held clock, so placement and archive times match across modes
+    ShiftClock::set(ShiftClock::now());
+    string reference;
+    bool identical = true;
+    cout << fixed << setprecision(2);
+    for (int mode = 0; mode < 3; mode++) {
+        BatchRun best{};
+        best.seconds = 1e9;
+        for (int round = 0; round < rounds; round++) {
+            BatchRun run = runBatch(mode, orders, scratch);
+            if (run.seconds < best.seconds) {
+                best = run;
+            }
+        }
+        if (mode == 0) {
+            reference = best.state;
+        }
+        identical = identical && best.state == reference;
+        cout << left << setw(16) << modeNames[mode] << right << setw(10) << best.seconds * 1000 << " ms "
+             << setw(10) << (long)(orders / best.seconds) << " orders/s " << setw(8) << best.changes
+             << " change log entries" << endl;
+    }
+    ShiftClock::release();
+
+    cout << (identical ? "Every mode ends in the same state" : "Modes end in DIFFERENT states") << endl;
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file HistoryBench.cpp
+ * @brief Range query benchmark for the order history.
+ *        Archives days of synthetic orders into hourly segments, then times queries over the whole
+ *        history, one hour and ten minutes, reporting how much of the history each one touched.
+ *        The same orders are written in the text format of the state file to compare size and a full scan.
+ *
+ *        Usage: HistoryBench [-n orders] [-d days] [-o directory] [-z 0|1]
+ *        Build: g++ -std=c++20 -O2 tools/HistoryBench.cpp OrderHistory.cpp HistoryCodec.cpp Order.cpp Food.cpp MealTable.cpp ReceiptFormatter.cpp Inventory.cpp MenuCatalog.cpp ShiftClock.cpp
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../OrderHistory.h"
+
+using namespace std;
+
+/**
+ * Runs one query and prints one row of the report.
+ * @param history The history to query
+ * @param label Name of the range
+ * @param from Start of the range
+ * @param to End of the range
+ */
+void runQuery(OrderHistory& history, const string& label, time_t from, time_t to) {
+    long doordashCents = 0;
+    HistoryScan scan = history.query(from, to, [&](const HistoryEntry& entry) {
+        if (entry.type == DOORDASH && !entry.cancelled) {
+            doordashCents += entry.getTotalCents();
+        }
+    });
+    cout << setw(10) << left << label << right
+         << setw(10) << scan.matched
+         << setw(10) << scan.segments
+         << setw(10) << scan.blocksRead
+         << setw(10) << scan.blocksSkipped
+         << setw(10) << scan.records
+         << setw(12) << fixed << setprecision(1) << scan.nanoseconds / 1000.0
+         << setw(14) << doordashCents / 100 << endl;
+}
+
+/**
+ * Adds up the sizes of the files in a directory.
+ * @param directory The directory
+ * @return Total bytes
+ */
+long directoryBytes(const string& directory) {
+    long bytes = 0;
+    if (DIR* dir = opendir(directory.c_str())) {
+        while (dirent* file = readdir(dir)) {
+            struct stat info;
+            if (stat((directory + "/" + file->d_name).c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+                bytes += info.st_size;
+            }
+        }
+        closedir(dir);
+    }
+    return bytes;
+}
+
+int main(int argc, char* argv[]) {
+    long count = 500000;
+    int days = 30;
+    string directory = "history-bench";
+    bool compression = true;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:d:o:z:")) != -1) {
+        switch (option) {
+            case 'n':
+                count = atol(optarg);
+                break;
+            case 'd':
+                days = atoi(optarg);
+                break;
+            case 'o':
+                directory = optarg;
+                break;
+            case 'z':
+                compression = atoi(optarg) != 0;
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n orders] [-d days] [-o directory] [-z 0|1]" << endl;
+                return 1;
+        }
+    }
+    if (count < 1 || days < 1) {
+        cerr << "Order count and days must be positive" << endl;
+        return 1;
+    }
+
+    OrderHistory history;
+    if (!history.open(directory)) {
+        return 1;
+    }
+    history.setCompression(compression);
+    string textPath = directory + ".txt";
+    ofstream text(textPath);
+
+    // Orders spread evenly over the days, ending now, finishing up to 20 minutes out of placement order
+    time_t end = time(nullptr) / 3600 * 3600;
+    time_t start = end - (time_t)days * 86400;
+    double spacing = (double)(end - start) / count;
+
+    auto writeStart = chrono::steady_clock::now();
+    static const char* const customers[8] = {"Ann", "Bob", "Carmen", "Dev", "Elif", "Femi", "Gus", "Hana"};
+    MealTable meals;
+    for (long i = 0; i < count; i++) {
+        Order order(i + 1, i % 8, customers[i % 8], static_cast<OrderType>(i % 4));
+        order.setPlacedTime(start + (time_t)(i * spacing) - (i * 7919 % 1200));
+        for (int k = 0; k < 1 + i % 4; k++) {
+            order.addItem(Food(static_cast<FOOD>((i + k) % 17)), meals);
+        }
+        history.append(order, i % 50 == 0);
+        text << order.getOrderID() << " " << order.getNameID() << " " << order.getOrderType() << " 0 "
+             << order.getOrderStatus() << " " << order.getPlacedTime() << " " << order.getDiscountCents() << " "
+             << order.getFeePercent() << "\n" << order.mealToString() << "\n";
+    }
+    text.close();
+    double writeSeconds = chrono::duration<double>(chrono::steady_clock::now() - writeStart).count();
+    cout << count << " orders over " << days << " days archived in " << fixed << setprecision(2)
+         << writeSeconds << " s (" << (long)(count / writeSeconds) << " orders/s) into " << directory << endl;
+
+    long historyBytes = directoryBytes(directory);
+    struct stat textInfo;
+    stat(textPath.c_str(), &textInfo);
+    cout << "History " << historyBytes / 1024 << " KB (" << setprecision(1) << (double)historyBytes / count
+         << " bytes/order), text " << textInfo.st_size / 1024 << " KB ("
+         << (double)textInfo.st_size / count << " bytes/order)" << endl;
+
+    // Full scan of the text file, token by token like fileRead
+    auto textStart = chrono::steady_clock::now();
+    ifstream input(textPath);
+    long id, nameID, type, skip, status, placed, discount, fee, mealSize, code, cents;
+    long textOrders = 0;
+    long textDoordashCents = 0;
+    while (input >> id >> nameID >> type >> skip >> status >> placed >> discount >> fee >> mealSize) {
+        long subtotal = 0;
+        for (long k = 0; k < mealSize && input >> code >> cents; k++) {
+            subtotal += cents;
+        }
+        if (type == DOORDASH && id % 50 != 1) {
+            textDoordashCents += subtotal - discount + ((subtotal - discount) * fee + 50) / 100;
+        }
+        textOrders += 1;
+    }
+    double textSeconds = chrono::duration<double>(chrono::steady_clock::now() - textStart).count();
+    cout << "Text scan of " << textOrders << " orders: " << setprecision(1) << textSeconds * 1e6 << " us, DoorDash $"
+         << textDoordashCents / 100 << endl;
+
+    time_t hour = start + (days / 2) * 86400 + 18 * 3600;
+    cout << setw(10) << left << "Range" << right << setw(10) << "Orders" << setw(10) << "Segments"
+         << setw(10) << "Blocks" << setw(10) << "Skipped" << setw(10) << "Decoded"
+         << setw(12) << "Time us" << setw(14) << "DoorDash $" << endl;
+    runQuery(history, "All", start - 3600, end + 3600);
+    runQuery(history, "One day", hour - 18 * 3600, hour + 6 * 3600);
+    runQuery(history, "One hour", hour, hour + 3600);
+    runQuery(history, "10 min", hour + 1200, hour + 1800);
+    return 0;
+}
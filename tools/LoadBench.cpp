@@ -0,0 +1,141 @@
+/**
+ * @file LoadBench.cpp
+ * @brief Startup benchmark for loading a large state file.
+ *        Writes a state file of synthetic orders, then times fileRead with one thread and with
+ *        doubling thread counts up to the core count. Every load is written back out and compared
+ *        with the original, so a faster load that loses or reorders anything is caught.
+ *
+ *        Usage: LoadBench [-n orders] [-t maxThreads] [-o file]
+ *        Build: g++ -std=c++20 -O2 -I. tools/LoadBench.cpp $(ls *.cpp | grep -v main.cpp)
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <unistd.h>
+#include "../RestaurantSystem.h"
+
+using namespace std;
+
+/**
+ * Writes a state file in the format of fileWrite.
+ * @param path Where to write it
+ * @param count Orders in the file
+ */
+void writeStateFile(const string& path, long count) {
+    static const char* const customers[12] = {"Ann", "Bob", "Carmen", "Dev", "Elif", "Femi",
+                                              "Gus", "Hana", "Ivo", "Jun", "Kofi", "Lena"};
+    ofstream out(path);
+    out << count / 2 << " " << count + 1 << "\n" << 12 << "\n";
+    for (const char* name : customers) {
+        out << name << "\n";
+    }
+
+    // Names and meals are numbered by first use, as fileWrite numbers them
+    // Order i has 1 + i % 5 items starting at food i % 17, so there are 85 meals, in canonical order
+    out << 85 << "\n";
+    for (int meal = 0; meal < 85; meal++) {
+        int items = 1 + meal % 5;
+        vector<int> foods;
+        for (int k = 0; k < items; k++) {
+            foods.push_back((meal + k * 3) % 17);
+        }
+        sort(foods.begin(), foods.end());
+        out << items;
+        for (int food : foods) {
+            out << " " << food << " " << builtinMenuItem(static_cast<FOOD>(food)).priceCents;
+        }
+        out << "\n";
+    }
+
+    time_t now = time(nullptr);
+    for (long i = 0; i < count; i++) {
+        // Mostly placed, some cooking, some waiting for pickup; every fifth order promised
+        int status = (i % 5 < 2) ? PLACED : (i % 5 == 2) ? COOKING : READY_FOR_PICKUP;
+        time_t promised = (i % 5 == 0) ? now + 600 + i % 3600 : 0;
+        if (i > 0) {
+            out << "\n";
+        }
+        out << i + 1 << " " << i % 12 << " " << i % 4 << " " << i % 3 << " " << status << " "
+            << promised << " " << ((i % 9 == 0) ? 150 : 0) << " " << ((i % 4 == 3) ? 15 : 0) << " " << i % 85;
+    }
+}
+
+/**
+ * Reads a whole file.
+ * @param path The file
+ * @return Its contents
+ */
+string slurp(const string& path) {
+    ifstream in(path);
+    stringstream contents;
+    contents << in.rdbuf();
+    return contents.str();
+}
+
+int main(int argc, char* argv[]) {
+    long count = 2000000;
+    int maxThreads = max(1u, thread::hardware_concurrency());
+    string path = "load-bench.txt";
+
+    int option;
+    while ((option = getopt(argc, argv, "n:t:o:")) != -1) {
+        switch (option) {
+            case 'n':
+                count = atol(optarg);
+                break;
+            case 't':
+                maxThreads = atoi(optarg);
+                break;
+            case 'o':
+                path = optarg;
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n orders] [-t maxThreads] [-o file]" << endl;
+                return 1;
+        }
+    }
+    if (count < 1 || maxThreads < 1) {
+        cerr << "Order count and threads must be positive" << endl;
+        return 1;
+    }
+
+    writeStateFile(path, count);
+    string original = slurp(path);
+    cout << count << " orders, " << original.size() / (1024 * 1024) << " MB in " << path << endl;
+    cout << setw(8) << "Threads" << setw(12) << "Load ms" << setw(10) << "Speedup" << setw(12) << "Round trip" << endl;
+
+    double baseline = 0;
+    for (int threads = 1; threads <= maxThreads; threads = (threads == maxThreads) ? threads + 1 : min(threads * 2, maxThreads)) {
+        double seconds;
+        bool same;
+        {
+            RestaurantSystem pos;
+            ifstream input(path);
+            auto start = chrono::steady_clock::now();
+            pos.fileRead(input, threads);
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            string copyPath = path + ".out";
+            ofstream output(copyPath);
+            pos.fileWrite(output);
+            output.close();
+            same = slurp(copyPath) == original;
+            unlink(copyPath.c_str());
+        }
+        if (threads == 1) {
+            baseline = seconds;
+        }
+        cout << setw(8) << threads << setw(12) << fixed << setprecision(1) << seconds * 1000
+             << setw(9) << setprecision(2) << baseline / seconds << "x" << setw(12) << (same ? "same" : "DIFFERS") << endl;
+    }
+    unlink(path.c_str());
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file MemoryBudgetBench.cpp
+ * @brief Memory budget benchmark. Runs a long shift of orders through a store, in rushes that are
+ *        placed, cooked and made ready for pickup, with ready orders archived to a history directory.
+ *        The shift runs once without a budget and once with one, and reports the peak and final
+ *        footprint, the heap taken by the shift arena, the orders left in memory and spilled, and
+ *        the time per order, so the cost of spilling shows next to the memory it saves.
+ *
+ *        Usage: MemoryBudgetBench [-n orders] [-b ordersPerRush] [-M budgetKB]
+ *        Build: g++ -std=c++20 -O2 -I. tools/MemoryBudgetBench.cpp $(ls *.cpp | grep -v main.cpp)
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../RestaurantSystem.h"
+
+using namespace std;
+
+static const char* const customers[16] = {"Ann", "Bob", "Carmen", "Dev", "Elif", "Femi", "Gus", "Hana",
+                                          "Ivo", "Jun", "Kofi", "Lena", "Mika", "Nia", "Omar", "Pia"};
+
+/**
+ * Result of one shift.
+ */
+struct ShiftRun {
+    double seconds = 0;
+    size_t peakBytes = 0; // Largest footprint seen after a rush
+    MemoryFootprint last; // Footprint at the end of the shift
+    long inMemory = 0; // Orders left in the system
+};
+
+/**
+ * Runs a shift of rushes through a store with a budget, checking the footprint after every rush.
+ */
+static ShiftRun runShift(long orders, long perRush, size_t budget, const string& scratch){
+    string boardName = "/pos_board-memorybench-" + to_string(getpid());
+    ShiftRun run;
+    {
+        RestaurantSystem system(boardName);
+        system.setEcho(false);
+        filesystem::remove_all(scratch);
+        system.openHistory(scratch);
+        system.setMemoryBudget(budget);
+
+        auto start = chrono::steady_clock::now();
+        for (long placed = 0; placed < orders; placed += perRush) {
+            long rush = min(perRush, orders - placed);
+            for (long i = placed; i < placed + rush; i++) {
+                vector<FOOD> items{static_cast<FOOD>(i % 17), static_cast<FOOD>((i / 17) % 17)};
+                system.submitOrder(customers[i % 16], static_cast<OrderType>(i % 4), items);
+            }
+            for (long i = 0; i < rush; i++) {
+                system.cookNextOrder();
+            }
+            system.transitionMatching(COOKING, {}, READY_FOR_PICKUP);
+            system.tick();
+            run.peakBytes = max(run.peakBytes, system.memoryFootprint().total);
+        }
+        run.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        run.last = system.memoryFootprint();
+        run.inMemory = system.report().orders;
+    }
+    shm_unlink(boardName.c_str());
+    filesystem::remove_all(scratch);
+    return run;
+}
+
+int main(int argc, char* argv[]) {
+    long orders = 50000;
+    long perRush = 500;
+    long budgetKB = 1024;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:b:M:")) != -1) {
+        switch (option) {
+            case 'n':
+                orders = atol(optarg);
+                break;
+            case 'b':
+                perRush = atol(optarg);
+                break;
+            case 'M':
+                budgetKB = atol(optarg);
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n orders] [-b ordersPerRush] [-M budgetKB]" << endl;
+                return 1;
+        }
+    }
+    if (orders < 1 || perRush < 1 || budgetKB < 1) {
+        cerr << "Orders, rush size and budget must be positive" << endl;
+        return 1;
+    }
+
+    string scratch = "/tmp/memory-bench-" + to_string(getpid()) + ".history";
+    cout << orders << " orders in rushes of " << perRush << ", archived to a history" << endl;
+    cout << setw(14) << left << "Budget" << right << setw(11) << "Peak KB" << setw(11) << "Final KB"
+         << setw(11) << "Arena KB" << setw(11) << "In memory" << setw(11) << "Spilled" << setw(13) << "us/order" << endl;
+
+    for (size_t budget : {(size_t)0, (size_t)budgetKB * 1024}) {
+        ShiftRun run = runShift(orders, perRush, budget, scratch);
+        cout << setw(14) << left << (budget == 0 ? "None" : to_string(budgetKB) + " KB") << right
+             << setw(11) << run.peakBytes / 1024 << setw(11) << run.last.total / 1024
+             << setw(11) << run.last.arenaReserved / 1024 << setw(11) << run.inMemory
+             << setw(11) << orders - run.inMemory << setw(13) << fixed << setprecision(2)
+             << run.seconds * 1e6 / orders << endl;
+    }
+    return 0;
+}
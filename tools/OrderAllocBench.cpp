@@ -0,0 +1,175 @@
+/**
+ * @file OrderAllocBench.cpp
+ * @brief Allocation benchmark for orders placed on the global heap and in a ShiftArena.
+ *        Runs whole shifts of orders both ways and reports global heap allocations,
+ *        time per order placed, and the time to tear the shift down. Meals are interned in a meal
+ *        table on the same memory as the orders, as in the system.
+ *
+ *        Usage: OrderAllocBench [-n ordersPerShift] [-m itemsPerOrder] [-s shifts]
+ *        Build: g++ -std=c++20 -O2 tools/OrderAllocBench.cpp Order.cpp Food.cpp ReceiptFormatter.cpp ShiftArena.cpp MealTable.cpp Inventory.cpp MenuCatalog.cpp ShiftClock.cpp
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <unistd.h>
+#include "../Order.h"
+#include "../ShiftArena.h"
+
+using namespace std;
+
+static long heapAllocations = 0; // Calls to the global operator new
+
+void* operator new(size_t size) {
+    heapAllocations += 1;
+    if (void* pointer = malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+// The default memory resource allocates through the aligned forms
+void* operator new(size_t size, align_val_t alignment) {
+    heapAllocations += 1;
+    if (void* pointer = aligned_alloc((size_t)alignment, (size + (size_t)alignment - 1) & ~((size_t)alignment - 1))) {
+        return pointer;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* pointer, align_val_t) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t, align_val_t) noexcept {
+    free(pointer);
+}
+
+/**
+ * Results of one way of allocating, summed over all shifts.
+ */
+struct BenchResult {
+    long heapAllocations = 0;
+    long placeNanoseconds = 0;
+    long teardownNanoseconds = 0;
+};
+
+/**
+ * Places a shift of orders into a vector, then tears it down.
+ * @param orders The vector the orders go into; its allocator decides where memory comes from
+ * @param meals Meal table the orders' meals are interned in, on the same memory as the orders
+ * @param count Orders in the shift
+ * @param items Items per order
+ * @param result Receives the counters
+ * @param clearShift Tears the shift down once the orders are gone
+ */
+template <typename Vector, typename Clear>
+void runShift(Vector& orders, MealTable& meals, int count, int items,
+              BenchResult& result, Clear clearShift) {
+    long heapBefore = heapAllocations;
+    auto start = chrono::steady_clock::now();
+    vector<Food> meal;
+    meal.reserve(items);
+    for (int i = 0; i < count; i++) {
+        Order order(i + 1, 0, "bench", static_cast<OrderType>(i % 4));
+        meal.clear();
+        for (int k = 0; k < items; k++) {
+            meal.push_back(Food(static_cast<FOOD>((i + k) % 17)));
+        }
+        orders.emplace_back(order.getOrderID(), 0, "bench", order.getOrderType(), meals.intern(meal), 0, PLACED);
+    }
+    auto placed = chrono::steady_clock::now();
+    clearShift();
+    auto done = chrono::steady_clock::now();
+
+    result.heapAllocations += heapAllocations - heapBefore;
+    result.placeNanoseconds += chrono::duration_cast<chrono::nanoseconds>(placed - start).count();
+    result.teardownNanoseconds += chrono::duration_cast<chrono::nanoseconds>(done - placed).count();
+}
+
+/**
+ * Prints one row of the report.
+ * @param label Name of the allocation strategy
+ * @param result Summed counters
+ * @param orders Orders placed over all shifts
+ * @param shifts Number of shifts
+ */
+void printResult(const string& label, const BenchResult& result, long orders, int shifts) {
+    cout << setw(12) << left << label << right
+         << setw(14) << fixed << setprecision(2) << (double)result.heapAllocations / orders
+         << setw(16) << (double)result.placeNanoseconds / orders
+         << setw(18) << (double)result.teardownNanoseconds / shifts / 1000 << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int count = 10000;
+    int items = 4;
+    int shifts = 20;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:m:s:")) != -1) {
+        switch (option) {
+            case 'n':
+                count = atoi(optarg);
+                break;
+            case 'm':
+                items = atoi(optarg);
+                break;
+            case 's':
+                shifts = atoi(optarg);
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n ordersPerShift] [-m itemsPerOrder] [-s shifts]" << endl;
+                return 1;
+        }
+    }
+    if (count < 1 || items < 0 || shifts < 1) {
+        cerr << "Order count and shifts must be positive" << endl;
+        return 1;
+    }
+
+    BenchResult heap;
+    BenchResult arena;
+    ArenaStats lastShift;
+
+    for (int shift = 0; shift < shifts; shift++) {
+        {
+            MealTable meals;
+            vector<Order> orders;
+            runShift(orders, meals, count, items, heap, [&]() { vector<Order>().swap(orders); });
+        }
+        {
+            ShiftArena shiftArena;
+            MealTable meals(&shiftArena);
+            auto* orders = new (shiftArena.allocate(sizeof(pmr::vector<Order>), alignof(pmr::vector<Order>)))
+                    pmr::vector<Order>(&shiftArena);
+            // The orders are never destroyed one by one: releasing the arena frees the whole shift
+            runShift(*orders, meals, count, items, arena, [&]() {
+                lastShift = shiftArena.getStats();
+                shiftArena.release();
+            });
+        }
+    }
+
+    long orders = (long)count * shifts;
+    cout << count << " orders of " << items << " items per shift, " << shifts << " shifts" << endl;
+    cout << setw(12) << left << "Allocator" << right << setw(14) << "Heap/order"
+         << setw(16) << "Place ns/order" << setw(18) << "Teardown us/shift" << endl;
+    printResult("Global heap", heap, orders, shifts);
+    printResult("Shift arena", arena, orders, shifts);
+    cout << "Arena per shift: " << lastShift.allocations << " blocks, "
+         << lastShift.heapAllocations << " heap chunks, "
+         << lastShift.bytesReserved / 1024 << " KB reserved" << endl;
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file PipelineBench.cpp
+ * @brief Order pipeline benchmark. Starts a large number of order tasks on their own and reports the memory
+ *        per task and the time to start and resume one as its order goes from placed to ready for pickup.
+ *        Then leaves a long pickup list of ready orders in a store and times sending the orders placed after
+ *        them to the kitchen, for each order type, since the first placed order is found in its type's cook
+ *        queue rather than by scanning past the ready ones.
+ *
+ *        Usage: PipelineBench [-n tasks] [-r readyOrders] [-d dispatches]
+ *        Build: g++ -std=c++20 -O2 -I. tools/PipelineBench.cpp $(ls *.cpp | grep -v main.cpp)
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../RestaurantSystem.h"
+#include "../OrderPipeline.h"
+
+using namespace std;
+
+/**
+ * Seconds since a start time.
+ */
+static double since(chrono::steady_clock::time_point start){
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Times a store sending orders of one type to the kitchen with ready orders ahead of them.
+ *
+ * @return Microseconds per dispatch.
+ */
+static double timeDispatch(OrderType type, long ready, long dispatches){
+    string boardName = "/pos_board-pipelinebench-" + to_string(getpid());
+    double seconds;
+    {
+        RestaurantSystem system(boardName);
+        system.setEcho(false);
+        vector<FOOD> items{HAMBURGER, SODA};
+        for (long i = 0; i < ready; i++) {
+            system.submitOrder("Ann", static_cast<OrderType>(i % 4), items);
+        }
+        for (long i = 0; i < ready; i++) {
+            system.cookNextOrder();
+        }
+        system.transitionMatching(COOKING, {}, READY_FOR_PICKUP);
+        for (long i = 0; i < dispatches; i++) {
+            system.submitOrder("Bob", type, items);
+        }
+
+        auto start = chrono::steady_clock::now();
+        for (long i = 0; i < dispatches; i++) {
+            system.cookNextOrder();
+        }
+        seconds = since(start);
+    }
+    shm_unlink(boardName.c_str());
+    return seconds * 1e6 / dispatches;
+}
+
+int main(int argc, char* argv[]) {
+    long tasks = 500000;
+    long ready = 100000;
+    long dispatches = 2000;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:r:d:")) != -1) {
+        switch (option) {
+            case 'n':
+                tasks = atol(optarg);
+                break;
+            case 'r':
+                ready = atol(optarg);
+                break;
+            case 'd':
+                dispatches = atol(optarg);
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n tasks] [-r readyOrders] [-d dispatches]" << endl;
+                return 1;
+        }
+    }
+    if (tasks < 1 || ready < 0 || dispatches < 1) {
+        cerr << "Tasks and dispatches must be positive" << endl;
+        return 1;
+    }
+
+    cout << fixed << setprecision(2);
+    {
+        OrderPipeline pipeline;
+        vector<int> handles(tasks);
+
+        auto start = chrono::steady_clock::now();
+        for (long i = 0; i < tasks; i++) {
+            handles[i] = pipeline.start(static_cast<int>(i), static_cast<OrderType>(i % 4), PLACED);
+        }
+        double startSeconds = since(start);
+        size_t bytes = pipeline.bytesUsed();
+
+        start = chrono::steady_clock::now();
+        for (Status status : {COOKING, COMPLETE, READY_FOR_PICKUP}) {
+            for (long i = 0; i < tasks; i++) {
+                pipeline.signal(handles[i], status);
+            }
+            pipeline.run();
+        }
+        double resumeSeconds = since(start);
+
+        cout << tasks << " order tasks in flight: " << bytes / 1024 << " KB, " << (double)bytes / tasks
+             << " bytes per task" << endl;
+        cout << "Start: " << startSeconds * 1e9 / tasks << " ns per task, resume: "
+             << resumeSeconds * 1e9 / (3 * tasks) << " ns per status change, "
+             << pipeline.size() << " tasks left after pickup" << endl;
+    }
+
+    cout << "\nDispatching " << dispatches << " orders with " << ready << " ready orders ahead of them" << endl;
+    for (OrderType type : {DRIVE_THROUGH, ONSITE, PHONE, DOORDASH}) {
+        cout << setw(15) << left << OrderTypeList[type] << right << setw(10) << timeDispatch(type, ready, dispatches)
+             << " us per dispatch" << endl;
+    }
+    return 0;
+}
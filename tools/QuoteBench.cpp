@@ -0,0 +1,86 @@
+/**
+ * @file QuoteBench.cpp
+ * @brief Wait quote benchmark. Fills a store's placed queue to growing depths and times the wait quotes
+ *        given at placement, which come from running aggregates and so should cost the same at any depth.
+ *        Then moves every queued order straight to ready for pickup, as the pickup option can, and checks
+ *        the quote falls back to what an empty kitchen quotes.
+ *
+ *        Usage: QuoteBench [-n maxQueued] [-q quotesPerDepth]
+ *        Build: g++ -std=c++20 -O2 -I. tools/QuoteBench.cpp $(ls *.cpp | grep -v main.cpp)
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../RestaurantSystem.h"
+
+using namespace std;
+
+static const char* const customers[4] = {"Ann", "Bob", "Carmen", "Dev"};
+
+int main(int argc, char* argv[]) {
+    long maxQueued = 100000;
+    long quotes = 1000000;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:q:")) != -1) {
+        switch (option) {
+            case 'n':
+                maxQueued = atol(optarg);
+                break;
+            case 'q':
+                quotes = atol(optarg);
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n maxQueued] [-q quotesPerDepth]" << endl;
+                return 1;
+        }
+    }
+    if (maxQueued < 1 || quotes < 1) {
+        cerr << "Queue depth and quotes must be positive" << endl;
+        return 1;
+    }
+
+    string boardName = "/pos_board-quotebench-" + to_string(getpid());
+    bool recovered;
+    {
+        RestaurantSystem system(boardName);
+        system.setEcho(false);
+        int emptyQuote = system.quoteWait(DOORDASH, 300);
+
+        cout << "Queued orders  ns/quote  quote (s)" << endl;
+        cout << fixed << setprecision(2);
+        vector<int> ids;
+        for (long depth = 10; depth <= maxQueued; depth *= 10) {
+            while ((long)ids.size() < depth) {
+                long i = static_cast<long>(ids.size());
+                vector<FOOD> items{static_cast<FOOD>(i % 17), static_cast<FOOD>((i * 7) % 17)};
+                ids.push_back(system.submitOrder(customers[i % 4], static_cast<OrderType>(i % 4), items));
+            }
+
+            // Summed so the quotes cannot be optimised away
+            long total = 0;
+            auto start = chrono::steady_clock::now();
+            for (long q = 0; q < quotes; q++) {
+                total += system.quoteWait(static_cast<OrderType>(q % 4), 300);
+            }
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << setw(13) << depth << setw(10) << seconds * 1e9 / quotes << setw(11)
+                 << total / quotes << endl;
+        }
+
+        for (int id : ids) {
+            system.readyOrder(id);
+        }
+        int afterQuote = system.quoteWait(DOORDASH, 300);
+        recovered = afterQuote == emptyQuote;
+        cout << "Quote after readying every queued order: " << afterQuote << " s, empty kitchen: "
+             << emptyQuote << " s" << endl;
+    }
+    shm_unlink(boardName.c_str());
+    return recovered ? 0 : 1;
+}
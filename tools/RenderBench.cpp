@@ -0,0 +1,226 @@
+/**
+ * @file RenderBench.cpp
+ * @brief Display rendering benchmark. Renders the same order list frames three ways: through the iostream
+ *        path the order lists used before the console renderer (a setw chain per row, flushed by endl),
+ *        as full redraws through ConsoleRenderer, and as diff frames, which is how only the kitchen display
+ *        (-k) is drawn. Between frames a few orders change status, as between two looks at the queue.
+ *        Then prints receipt lines both ways: the old setw chain with endl per line and Food::print.
+ *        Reports bytes and time per frame, and checks the full redraw writes the same bytes as the old path.
+ *
+ *        Usage: RenderBench [-n rows] [-f frames] [-c changedRowsPerFrame] [-o output]
+ *        Build: g++ -std=c++20 -O2 -I. tools/RenderBench.cpp $(ls *.cpp | grep -v main.cpp)
+ *        The output defaults to /dev/null; a terminal such as /dev/pts/3 adds the cost of drawing.
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../ConsoleRenderer.h"
+#include "../Food.h"
+#include "../Order.h"
+
+using namespace std;
+
+static const char* const customers[6] = {"Ann", "Bob", "Carmen", "Dev", "Elif", "Femi"};
+
+/**
+ * One row of the order list.
+ */
+struct Row {
+    string name;
+    int orderID;
+    OrderType type;
+    Status status;
+    bool cold;
+};
+
+/**
+ * Writes a list frame the way printOrders did before the console renderer.
+ */
+static void printOld(ostream& out, const vector<Row>& rows){
+    out << "\n----NAME-----|--ID--|---TYPE---|-STATUS-" << endl;
+    for (const Row& row : rows) {
+        out << setw(12) << left << row.name
+            << " | " << setw(4) << row.orderID
+            << " | " << setw(6) << OrderTypeList[row.type]
+            << " | " << setw(8) << StatusList[row.status]
+            << (row.cold ? " | COLD" : "") << endl;
+    }
+}
+
+/**
+ * Builds a list frame the way printOrders does now.
+ */
+static void buildFrame(ConsoleRenderer& renderer, const vector<Row>& rows){
+    renderer.beginFrame();
+    renderer.text("");
+    renderer.endRow();
+    renderer.text("----NAME-----|--ID--|---TYPE---|-STATUS-");
+    renderer.endRow();
+    for (const Row& row : rows) {
+        renderer.padded(row.name, 12);
+        renderer.text(" | ");
+        renderer.number(row.orderID, 4);
+        renderer.text(" | ");
+        renderer.padded(OrderTypeList[row.type], 6);
+        renderer.text(" | ");
+        renderer.padded(StatusList[row.status], 8);
+        if (row.cold) {
+            renderer.text(" | COLD");
+        }
+        renderer.endRow();
+    }
+}
+
+/**
+ * Moves a few rows on to their next status, as happens between two redraws.
+ */
+static void changeRows(vector<Row>& rows, long frame, long changed){
+    for (long k = 0; k < changed; k++) {
+        Row& row = rows[(frame * changed + k) * 7 % rows.size()];
+        row.status = static_cast<Status>((row.status + 1) % 4);
+    }
+}
+
+/**
+ * Prints one line of the results.
+ */
+static void report(const char* label, double frames, double bytes, double seconds){
+    cout << setw(24) << left << label << right << setw(12) << bytes / frames << setw(12)
+         << seconds * 1e6 / frames << endl;
+}
+
+int main(int argc, char* argv[]) {
+    long rowCount = 40;
+    long frames = 20000;
+    long changed = 2;
+    string outputPath = "/dev/null";
+
+    int option;
+    while ((option = getopt(argc, argv, "n:f:c:o:")) != -1) {
+        switch (option) {
+            case 'n':
+                rowCount = atol(optarg);
+                break;
+            case 'f':
+                frames = atol(optarg);
+                break;
+            case 'c':
+                changed = atol(optarg);
+                break;
+            case 'o':
+                outputPath = optarg;
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n rows] [-f frames] [-c changedRowsPerFrame] [-o output]" << endl;
+                return 1;
+        }
+    }
+    if (rowCount < 1 || frames < 1 || changed < 0) {
+        cerr << "Rows and frames must be positive" << endl;
+        return 1;
+    }
+
+    vector<Row> start;
+    for (long i = 0; i < rowCount; i++) {
+        start.push_back(Row{customers[i % 6], static_cast<int>(i + 1), static_cast<OrderType>(i % 4),
+                            static_cast<Status>(i % 4), i % 9 == 0});
+    }
+
+    ofstream oldOutput(outputPath);
+    int fd = open(outputPath.c_str(), O_WRONLY | O_NOCTTY);
+    if (!oldOutput || fd < 0) {
+        cerr << "Cannot write to " << outputPath << endl;
+        return 1;
+    }
+
+    // The old path's bytes are the same text again, counted apart from the timed writes
+    vector<Row> rows = start;
+    double oldBytes = 0;
+    double oldSeconds = 0;
+    bool same = true;
+    ConsoleRenderer check;
+    for (long f = 0; f < frames; f++) {
+        auto begin = chrono::steady_clock::now();
+        printOld(oldOutput, rows);
+        oldSeconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        ostringstream text;
+        printOld(text, rows);
+        oldBytes += text.str().size();
+        if (f == 0) {
+            int pipes[2];
+            if (pipe(pipes) == 0) {
+                check.setOutput(pipes[1]);
+                buildFrame(check, rows);
+                check.endFrame();
+                close(pipes[1]);
+                string written;
+                char buffer[4096];
+                for (ssize_t got; (got = read(pipes[0], buffer, sizeof(buffer))) > 0;) {
+                    written.append(buffer, got);
+                }
+                close(pipes[0]);
+                same = written == text.str();
+            }
+        }
+        changeRows(rows, f, changed);
+    }
+
+    rows = start;
+    ConsoleRenderer full(fd);
+    ConsoleRenderer diff(fd);
+    for (long f = 0; f < frames; f++) {
+        buildFrame(full, rows);
+        full.endFrame();
+        buildFrame(diff, rows);
+        diff.endFrameDiff();
+        changeRows(rows, f, changed);
+    }
+    RenderStats fullStats = full.getFullStats();
+    RenderStats diffStats = diff.getDiffStats();
+
+    cout << frames << " frames of " << rowCount << " orders, " << changed << " changing per frame, to "
+         << outputPath << endl;
+    cout << fixed << setprecision(2);
+    cout << setw(24) << left << "Order list" << right << setw(12) << "bytes/frame" << setw(12) << "us/frame" << endl;
+    report("iostream, endl per row", frames, oldBytes, oldSeconds);
+    report("Full redraw, one write", frames, fullStats.bytes, fullStats.nanoseconds / 1e9);
+    report("Diff, one write (-k)", frames, diffStats.bytes, diffStats.nanoseconds / 1e9);
+    cout << "Full redraw " << (same ? "writes the same bytes as" : "DIFFERS from") << " the iostream path" << endl;
+
+    // Receipt lines go through cout either way
+    vector<Food> items;
+    for (int food = 0; food < 17; food++) {
+        items.push_back(Food(static_cast<FOOD>(food)));
+    }
+    streambuf* console = cout.rdbuf(oldOutput.rdbuf());
+    auto begin = chrono::steady_clock::now();
+    for (long f = 0; f < frames; f++) {
+        for (Food& item : items) {
+            cout << setw(15) << foodString[item.getFood()] << setw(5) << "$" << item.getPrice() << endl;
+        }
+    }
+    double oldReceipt = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    begin = chrono::steady_clock::now();
+    for (long f = 0; f < frames; f++) {
+        for (Food& item : items) {
+            item.print();
+        }
+        cout << flush;
+    }
+    double newReceipt = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    cout.rdbuf(console);
+
+    cout << "Receipt of " << items.size() << " items:    iostream, endl per line " << oldReceipt * 1e6 / frames
+         << " us, Food::print " << newReceipt * 1e6 / frames << " us" << endl;
+    close(fd);
+    return same ? 0 : 1;
+}
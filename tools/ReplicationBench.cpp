@@ -0,0 +1,184 @@
+/**
+ * @file ReplicationBench.cpp
+ * @brief Replication lag and throughput benchmark for log shipping between terminals on one machine.
+ *        Forks the given number of follower processes, then drives a rush of orders (place, cook,
+ *        complete, ready) through a leader, ticking after every batch as the menu loop does after
+ *        every option. Reports orders per second with and without followers, the lag from publishing
+ *        a batch to its acknowledgement, and the time for the followers to catch up at the end.
+ *        When the leader shuts down every follower writes its copy, which must match the leader's.
+ *
+ *        Usage: ReplicationBench [-n orders] [-f followers] [-b ordersPerBatch]
+ *        Build: g++ -std=c++20 -O2 -I. tools/ReplicationBench.cpp $(ls *.cpp | grep -v main.cpp)
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../RestaurantSystem.h"
+
+using namespace std;
+
+static const char* const customers[4] = {"Ann", "Bob", "Carmen", "Dev"};
+
+/**
+ * Runs the order flow on a system, ticking after every batch, and returns the seconds it took.
+ */
+static double rush(RestaurantSystem& system, long orders, int batchOrders){
+    auto start = chrono::steady_clock::now();
+    for (long i = 0; i < orders; i++) {
+        vector<FOOD> items{static_cast<FOOD>(i % 17), static_cast<FOOD>((i * 7) % 17)};
+        system.submitOrder(customers[i % 4], static_cast<OrderType>(i % 4), items, (i % 3) * 10);
+        int cooking = system.cookNextOrder();
+        system.completeOrder(cooking);
+        system.readyOrder(cooking);
+        if ((i + 1) % batchOrders == 0) {
+            system.tick();
+        }
+    }
+    system.tick();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Reads a whole file.
+ */
+static string slurp(const string& path){
+    ifstream input(path);
+    stringstream text;
+    text << input.rdbuf();
+    return text.str();
+}
+
+int main(int argc, char* argv[]) {
+    long orders = 20000;
+    int followerCount = 2;
+    int batchOrders = 50;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:f:b:")) != -1) {
+        switch (option) {
+            case 'n':
+                orders = atol(optarg);
+                break;
+            case 'f':
+                followerCount = atoi(optarg);
+                break;
+            case 'b':
+                batchOrders = atoi(optarg);
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n orders] [-f followers] [-b ordersPerBatch]" << endl;
+                return 1;
+        }
+    }
+    if (orders < 1 || followerCount < 1 || batchOrders < 1) {
+        cerr << "Orders, followers and batch size must be positive" << endl;
+        return 1;
+    }
+
+    string directory = "/tmp/replication-bench-" + to_string(getpid());
+    string socketPath = directory + ".sock";
+    string boardPrefix = "/pos_board-replbench-" + to_string(getpid());
+
+    double aloneSeconds;
+    {
+        RestaurantSystem alone(boardPrefix + "-alone");
+        alone.setEcho(false);
+        aloneSeconds = rush(alone, orders, batchOrders);
+    }
+    shm_unlink((boardPrefix + "-alone").c_str());
+
+    vector<pid_t> children;
+    for (int k = 0; k < followerCount; k++) {
+        pid_t child = fork();
+        if (child == 0) {
+            // Quiet follower; writes its copy when the leader shuts down
+            cout.setstate(ios::failbit);
+            RestaurantSystem replica(boardPrefix + "-" + to_string(k));
+            FollowEnd end;
+            while ((end = replica.follow(socketPath)) == NO_LEADER) {
+                this_thread::sleep_for(chrono::milliseconds(10));
+            }
+            ofstream output(directory + "-replica-" + to_string(k) + ".state");
+            replica.fileWrite(output);
+            output.close();
+            _exit(end == LEADER_SHUT_DOWN ? 0 : 1);
+        }
+        children.push_back(child);
+    }
+
+    cout << orders << " orders in batches of " << batchOrders << ", " << followerCount << " followers, "
+         << thread::hardware_concurrency() << " cores" << endl;
+
+    string leaderState;
+    {
+        RestaurantSystem leader(boardPrefix + "-leader");
+        leader.setEcho(false);
+        if (!leader.lead(socketPath)) {
+            cerr << "Cannot lead " << socketPath << endl;
+            return 1;
+        }
+        while (leader.getFollowers().size() < (size_t)followerCount) {
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+
+        double leaderSeconds = rush(leader, orders, batchOrders);
+
+        auto drainStart = chrono::steady_clock::now();
+        uint64_t last = leader.lastChange();
+        auto caughtUp = [&] {
+            for (const FollowerStatus& follower : leader.getFollowers()) {
+                if (follower.ackedLSN < last) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        while (!caughtUp()) {
+            this_thread::sleep_for(chrono::microseconds(200));
+        }
+        double drainMs = chrono::duration<double, milli>(chrono::steady_clock::now() - drainStart).count();
+
+        cout << fixed << setprecision(1);
+        cout << "Alone:         " << setw(10) << aloneSeconds * 1000 << " ms " << setw(10)
+             << (long)(orders / aloneSeconds) << " orders/s" << endl;
+        cout << "Leading:       " << setw(10) << leaderSeconds * 1000 << " ms " << setw(10)
+             << (long)(orders / leaderSeconds) << " orders/s, " << last << " changes" << endl;
+        cout << "Catch up:      " << setw(10) << drainMs << " ms after the last batch" << endl;
+        cout << setprecision(2);
+        vector<FollowerStatus> followers = leader.getFollowers();
+        for (size_t k = 0; k < followers.size(); k++) {
+            cout << "Follower " << (k + 1) << " lag: mean " << followers[k].meanLagMs << " ms, max "
+                 << followers[k].maxLagMs << " ms" << endl;
+        }
+
+        string path = directory + "-leader.state";
+        ofstream output(path);
+        leader.fileWrite(output);
+        output.close();
+        leaderState = slurp(path);
+        remove(path.c_str());
+    }
+    shm_unlink((boardPrefix + "-leader").c_str());
+
+    int matching = 0;
+    for (int k = 0; k < followerCount; k++) {
+        int status = 0;
+        waitpid(children[k], &status, 0);
+        string path = directory + "-replica-" + to_string(k) + ".state";
+        matching += (WIFEXITED(status) && WEXITSTATUS(status) == 0 && slurp(path) == leaderState);
+        remove(path.c_str());
+        shm_unlink((boardPrefix + "-" + to_string(k)).c_str());
+    }
+    remove((socketPath + ".lock").c_str());
+    cout << matching << " of " << followerCount << " replicas match the leader" << endl;
+    return matching == followerCount ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file ShardBench.cpp
+ * @brief Throughput benchmark for stores hosted as shards of one process.
+ *        Runs the same order flow (place, cook, complete, ready) on 1 up to the given number of
+ *        shards, every shard on its own pinned thread, and reports total orders per second.
+ *        With one core per shard the total should grow with the number of shards.
+ *
+ *        Usage: ShardBench [-n ordersPerShard] [-s maxShards] [-b ordersPerBatch]
+ *        Build: g++ -std=c++20 -O2 -I. tools/ShardBench.cpp $(ls *.cpp | grep -v main.cpp)
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../StoreShards.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    long orders = 20000;
+    int maxShards = max(2u, thread::hardware_concurrency());
+    int batchOrders = 500;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:s:b:")) != -1) {
+        switch (option) {
+            case 'n':
+                orders = atol(optarg);
+                break;
+            case 's':
+                maxShards = atoi(optarg);
+                break;
+            case 'b':
+                batchOrders = atoi(optarg);
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [-n ordersPerShard] [-s maxShards] [-b ordersPerBatch]" << endl;
+                return 1;
+        }
+    }
+    if (orders < 1 || maxShards < 1 || batchOrders < 1) {
+        cerr << "Orders, shards and batch size must be positive" << endl;
+        return 1;
+    }
+
+    cout << orders << " orders per shard in batches of " << batchOrders << ", "
+         << thread::hardware_concurrency() << " cores" << endl;
+    cout << setw(8) << "Shards" << setw(12) << "Orders" << setw(10) << "Time ms" << setw(14) << "Orders/s"
+         << setw(10) << "Scaling" << endl;
+
+    static const char* const customers[4] = {"Ann", "Bob", "Carmen", "Dev"};
+    double singleRate = 0;
+    for (int shards = 1; shards <= maxShards; shards = (shards == maxShards) ? shards + 1 : min(shards * 2, maxShards)) {
+        vector<StoreConfig> stores;
+        for (int k = 0; k < shards; k++) {
+            stores.push_back(StoreConfig{"bench-" + to_string(k), "", "", "", "", ""});
+        }
+
+        StoreShards host;
+        host.start(stores);
+        auto start = chrono::steady_clock::now();
+        for (int k = 0; k < shards; k++) {
+            for (long done = 0; done < orders; done += batchOrders) {
+                long count = min<long>(batchOrders, orders - done);
+                host.post(k, [count, done](RestaurantSystem& system) {
+                    for (long i = done; i < done + count; i++) {
+                        vector<FOOD> items{static_cast<FOOD>(i % 17), static_cast<FOOD>((i * 7) % 17)};
+                        system.submitOrder(customers[i % 4], static_cast<OrderType>(i % 4), items, (i % 3) * 10);
+                        int cooking = system.cookNextOrder();
+                        system.completeOrder(cooking);
+                        system.readyOrder(cooking);
+                    }
+                });
+            }
+        }
+        // Reports queue behind the work, so they come back once every shard is done
+        vector<StoreReport> reports = host.report();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        host.stop();
+
+        long total = 0;
+        for (const StoreReport& report : reports) {
+            total += report.byStatus[READY_FOR_PICKUP];
+        }
+        double rate = total / seconds;
+        if (shards == 1) {
+            singleRate = rate;
+        }
+        cout << setw(8) << shards << setw(12) << total << setw(10) << fixed << setprecision(1) << seconds * 1000
+             << setw(14) << (long)rate << setw(9) << setprecision(2) << rate / singleRate << "x" << endl;
+
+        for (const StoreConfig& store : stores) {
+            shm_unlink((string(BOARD_SHM_NAME) + "-" + store.name).c_str());
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file TraceReplay.cpp
+ * @brief Replays a shift recorded with -T trace.bin. Loads the menu, pricing rules and orders the
+ *        shift started with, then feeds every line typed back through the main menu with the shift
+ *        clock set to the second each line was typed, as fast as possible or paced by the recorded
+ *        gaps. Reports the replay rate and whether the final state matches the one recorded.
+ *
+ *        Usage: TraceReplay [-s speedUp] [-m menu] [-p rules] [-v] trace.bin
+ *        Build: g++ -std=c++20 -O2 -I. tools/TraceReplay.cpp $(ls *.cpp | grep -v main.cpp)
+ * @author Edward Villano
+ */
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../InputTrace.h"
+#include "../OptionsMenu.h"
+#include "../ShiftClock.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    double speedUp = 0;
+    bool verbose = false;
+    string menuPath, rulesPath;
+    bool menuGiven = false, rulesGiven = false;
+
+    int option;
+    while ((option = getopt(argc, argv, "s:m:p:v")) != -1) {
+        switch (option) {
+            case 's':
+                speedUp = atof(optarg);
+                break;
+            case 'm':
+                menuPath = optarg;
+                menuGiven = true;
+                break;
+            case 'p':
+                rulesPath = optarg;
+                rulesGiven = true;
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            default:
+                optind = argc + 1;
+        }
+    }
+    if (optind != argc - 1 || speedUp < 0) {
+        cerr << "Usage: " << argv[0] << " [-s speedUp] [-m menu] [-p rules] [-v] trace.bin" << endl;
+        return 1;
+    }
+
+    TraceReplayer trace;
+    if (!trace.open(argv[optind])) {
+        cerr << "Cannot read trace " << argv[optind] << endl;
+        return 1;
+    }
+    // The files of the capture, unless they have moved since
+    if (!menuGiven) {
+        menuPath = trace.menuPath;
+    }
+    if (!rulesGiven) {
+        rulesPath = trace.rulesPath;
+    }
+
+    cout << "Replaying " << trace.totalLines << " lines recorded at " << trace.startMs / 1000
+         << (speedUp > 0 ? "" : ", as fast as possible") << endl;
+    if (speedUp > 0) {
+        cout << "Paced at " << speedUp << "x the recorded speed" << endl;
+    }
+
+    string boardName = "/pos_board-replay-" + to_string(getpid());
+    bool matches;
+    uint64_t digest;
+    long orders;
+    double seconds;
+    {
+        ShiftClock::set(trace.startMs / 1000);
+        RestaurantSystem system(boardName);
+        system.setEcho(verbose);
+        if (!menuPath.empty()) {
+            system.loadMenu(menuPath);
+        }
+        if (!rulesPath.empty()) {
+            system.loadPricingRules(rulesPath);
+        }
+        istringstream state(trace.state);
+        system.fileRead(state);
+
+        // The order list is drawn straight to the descriptor, so quiet replays silence that
+        int console = dup(STDOUT_FILENO);
+        if (!verbose) {
+            int null = open("/dev/null", O_WRONLY);
+            dup2(null, STDOUT_FILENO);
+            close(null);
+        }
+        cin.exceptions(ios::badbit);
+        trace.attach(cin, speedUp);
+        auto start = chrono::steady_clock::now();
+        try {
+            int choice = -1;
+            while (choice != 0) {
+                system.tick();
+                OptionsMenu::DisplayMainMenu();
+                choice = OptionsMenu::menuInput();
+                if (choice != 0) {
+                    OptionsMenu::runChoice(system, choice);
+                }
+            }
+        } catch (const TraceEnded&) {
+            // A shift that ended in a crash stops where its input did
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        trace.detach();
+        cin.exceptions(ios::goodbit);
+        cin.clear();
+        cout.flush();
+        dup2(console, STDOUT_FILENO);
+        close(console);
+
+        digest = system.stateDigest();
+        orders = system.report().orders;
+        matches = trace.ended && digest == trace.digest && (uint64_t)orders == trace.orders;
+    }
+    ShiftClock::release();
+    shm_unlink(boardName.c_str());
+
+    cout << fixed << setprecision(1);
+    cout << "Replayed:      " << trace.lines << " of " << trace.totalLines << " lines, "
+         << trace.elapsedMs() / 1000.0 << " s of shift in " << seconds * 1000 << " ms ("
+         << (long)(trace.lines / max(seconds, 1e-9)) << " lines/s)" << endl;
+    cout << "Final state:   " << orders << " orders, digest " << hex << digest << dec << endl;
+    if (!trace.ended) {
+        cout << "Recording has no orderly exit; nothing to compare with" << endl;
+        return 2;
+    }
+    cout << "Recorded:      " << trace.orders << " orders, digest " << hex << trace.digest << dec << endl;
+    cout << (matches ? "Final state matches the recording" : "Final state DIFFERS from the recording") << endl;
+    return matches ? 0 : 1;
+}